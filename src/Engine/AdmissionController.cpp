@@ -0,0 +1,138 @@
+#include "AdmissionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Client buckets idle long enough to have refilled are dropped this often.
+constexpr std::int64_t kSweepIntervalMs = 10000;
+
+}  // namespace
+
+AdmissionLimits AdmissionLimits::FromConfig(const EngineConfig& config) {
+    AdmissionLimits limits;
+    limits.max_tick_lag_ms = config.admission_max_tick_lag_ms;
+    limits.max_region_queue = static_cast<std::size_t>(config.admission_max_region_queue);
+    limits.max_enqueues_per_second = config.admission_max_enqueues_per_second;
+    limits.client_enqueues_per_second = config.client_enqueues_per_second;
+    limits.client_enqueue_burst =
+        config.client_enqueue_burst > 0 ? config.client_enqueue_burst : config.client_enqueues_per_second;
+    limits.retry_after_ms = config.admission_retry_after_ms;
+    return limits;
+}
+
+const char* AdmissionReasonName(AdmissionReason reason) {
+    switch (reason) {
+        case AdmissionReason::Admitted:
+            return "admitted";
+        case AdmissionReason::TickLag:
+            return "tick_lag";
+        case AdmissionReason::RegionQueue:
+            return "region_queue";
+        case AdmissionReason::IngestRate:
+            return "ingest_rate";
+        case AdmissionReason::ClientRate:
+            return "client_rate";
+    }
+    return "unknown";
+}
+
+std::int64_t AdmissionController::TokenBucket::Take(double rate, double burst, std::int64_t now_ms) {
+    burst = std::max(burst, 1.0);
+    if (updated_ms < 0) {
+        tokens = burst;
+    } else if (now_ms > updated_ms) {
+        tokens = std::min(burst, tokens + rate * static_cast<double>(now_ms - updated_ms) / 1000.0);
+    }
+    updated_ms = std::max(updated_ms, now_ms);
+    if (tokens >= 1.0) {
+        tokens -= 1.0;
+        return 0;
+    }
+    return std::max<std::int64_t>(1, static_cast<std::int64_t>(std::ceil((1.0 - tokens) * 1000.0 / rate)));
+}
+
+AdmissionController::AdmissionController(const AdmissionLimits& limits)
+    : limits_(limits) {}
+
+void AdmissionController::SetLimits(const AdmissionLimits& limits) {
+    std::scoped_lock lock(mtx_);
+    limits_ = limits;
+    if (limits_.client_enqueues_per_second <= 0.0) {
+        clients_.clear();
+    }
+}
+
+AdmissionDecision AdmissionController::Admit(std::string_view client, const AdmissionSignals& signals,
+                                             std::int64_t now_ms) {
+    std::scoped_lock lock(mtx_);
+    auto reject = [](AdmissionReason reason, std::int64_t retry_after_ms, std::uint64_t& counter) {
+        ++counter;
+        return AdmissionDecision{reason, std::max<std::int64_t>(retry_after_ms, 1)};
+    };
+
+    if (limits_.max_tick_lag_ms > 0 && signals.tick_lag_ms > limits_.max_tick_lag_ms) {
+        return reject(AdmissionReason::TickLag, std::max(limits_.retry_after_ms, signals.tick_lag_ms),
+                      stats_.rejected_tick_lag);
+    }
+    if (limits_.max_region_queue > 0 && signals.region_queue >= limits_.max_region_queue) {
+        return reject(AdmissionReason::RegionQueue, limits_.retry_after_ms, stats_.rejected_region_queue);
+    }
+
+    TokenBucket* client_bucket = nullptr;
+    if (limits_.client_enqueues_per_second > 0.0) {
+        DropIdleClients(now_ms);
+        client_bucket = &clients_[std::string(client)];
+        const std::int64_t wait =
+            client_bucket->Take(limits_.client_enqueues_per_second, limits_.client_enqueue_burst, now_ms);
+        if (wait > 0) {
+            return reject(AdmissionReason::ClientRate, wait, stats_.rejected_client_rate);
+        }
+    }
+    if (limits_.max_enqueues_per_second > 0.0) {
+        const std::int64_t wait =
+            ingest_.Take(limits_.max_enqueues_per_second, limits_.max_enqueues_per_second, now_ms);
+        if (wait > 0) {
+            // The player was not admitted, so the client keeps its token.
+            if (client_bucket) {
+                client_bucket->tokens += 1.0;
+            }
+            return reject(AdmissionReason::IngestRate, wait, stats_.rejected_ingest_rate);
+        }
+    }
+    CountAdmitted(now_ms);
+    return AdmissionDecision{};
+}
+
+AdmissionStats AdmissionController::Stats(std::int64_t now_ms) const {
+    std::scoped_lock lock(mtx_);
+    AdmissionStats stats = stats_;
+    const std::int64_t elapsed = now_ms - window_start_ms_;
+    stats.enqueues_per_second =
+        elapsed >= 1000 ? static_cast<double>(window_admitted_) * 1000.0 / static_cast<double>(elapsed) : last_rate_;
+    return stats;
+}
+
+void AdmissionController::CountAdmitted(std::int64_t now_ms) {
+    const std::int64_t elapsed = now_ms - window_start_ms_;
+    if (elapsed >= 1000) {
+        last_rate_ = static_cast<double>(window_admitted_) * 1000.0 / static_cast<double>(elapsed);
+        window_start_ms_ = now_ms;
+        window_admitted_ = 0;
+    }
+    ++window_admitted_;
+}
+
+void AdmissionController::DropIdleClients(std::int64_t now_ms) {
+    if (now_ms - last_sweep_ms_ < kSweepIntervalMs) {
+        return;
+    }
+    last_sweep_ms_ = now_ms;
+    const double rate = limits_.client_enqueues_per_second;
+    const double burst = std::max(limits_.client_enqueue_burst, 1.0);
+    std::erase_if(clients_, [&](const auto& entry) {
+        const TokenBucket& bucket = entry.second;
+        return bucket.tokens + rate * static_cast<double>(now_ms - bucket.updated_ms) / 1000.0 >= burst;
+    });
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "EngineConfig.h"
+
+// Thresholds above which enqueues are shed; 0 disables a check.
+struct AdmissionLimits {
+    std::int64_t max_tick_lag_ms = 0;
+    std::size_t max_region_queue = 0;
+    double max_enqueues_per_second = 0.0;
+    double client_enqueues_per_second = 0.0;
+    double client_enqueue_burst = 0.0;
+    std::int64_t retry_after_ms = 1000;
+
+    static AdmissionLimits FromConfig(const EngineConfig& config);
+};
+
+// Engine state an enqueue is judged against.
+struct AdmissionSignals {
+    // How far past its due time the next tick is.
+    std::int64_t tick_lag_ms = 0;
+    // Players already queued in the enqueuing player's region.
+    std::size_t region_queue = 0;
+};
+
+enum class AdmissionReason {
+    Admitted,
+    TickLag,
+    RegionQueue,
+    IngestRate,
+    ClientRate,
+};
+
+const char* AdmissionReasonName(AdmissionReason reason);
+
+struct AdmissionDecision {
+    AdmissionReason reason = AdmissionReason::Admitted;
+    // When a rejected client should try again.
+    std::int64_t retry_after_ms = 0;
+
+    bool Admitted() const { return reason == AdmissionReason::Admitted; }
+};
+
+struct AdmissionStats {
+    // Enqueues admitted per second over the last full second.
+    double enqueues_per_second = 0.0;
+    std::uint64_t rejected_tick_lag = 0;
+    std::uint64_t rejected_region_queue = 0;
+    std::uint64_t rejected_ingest_rate = 0;
+    std::uint64_t rejected_client_rate = 0;
+};
+
+// Decides whether an enqueue may join the queue. Overload signals (tick lag, region
+// depth) are checked first, then a token bucket per client and one for total ingest,
+// so a client that is refused never spends shared capacity. Thread-safe.
+class AdmissionController {
+public:
+    explicit AdmissionController(const AdmissionLimits& limits);
+
+    void SetLimits(const AdmissionLimits& limits);
+
+    // `now_ms` is any monotonic millisecond clock; the engine passes its elapsed time.
+    AdmissionDecision Admit(std::string_view client, const AdmissionSignals& signals, std::int64_t now_ms);
+
+    AdmissionStats Stats(std::int64_t now_ms) const;
+
+private:
+    struct TokenBucket {
+        double tokens = 0.0;
+        // -1 until first used; a new bucket starts full.
+        std::int64_t updated_ms = -1;
+
+        // Takes a token and returns 0, or returns the milliseconds until one is available.
+        std::int64_t Take(double rate, double burst, std::int64_t now_ms);
+    };
+
+    void CountAdmitted(std::int64_t now_ms);
+    void DropIdleClients(std::int64_t now_ms);
+
+    mutable std::mutex mtx_;
+    AdmissionLimits limits_;
+    TokenBucket ingest_;
+    std::unordered_map<std::string, TokenBucket> clients_;
+    std::int64_t last_sweep_ms_ = 0;
+    std::int64_t window_start_ms_ = 0;
+    std::uint64_t window_admitted_ = 0;
+    double last_rate_ = 0.0;
+    AdmissionStats stats_;
+};
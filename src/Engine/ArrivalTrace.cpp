@@ -0,0 +1,190 @@
+#include "ArrivalTrace.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/ConfigParser.h"
+
+namespace {
+
+const std::vector<std::string> kEventKeys = {
+    "t_ms", "op", "id", "mmr", "ping", "region", "ping_na", "ping_eu", "ping_asia", "queue_id", "pings",
+    "started_unix_ms",
+};
+
+constexpr const char* kSessionOp = "session";
+
+// "pings": {"FRA": 23, "IAD": 95}, one member per Player.pings entry.
+bool ReadPings(const ConfigValue& root, matchmaking::Player& player, ConfigError* error) {
+    const ConfigValue* pings = root.Find("pings");
+    if (!pings) {
+        return true;
+    }
+    if (!pings->IsObject()) {
+        return config::Fail(error, ConfigError::Kind::TypeMismatch, pings->line(),
+                            "pings: expected an object of datacenter pings");
+    }
+    for (const auto& [datacenter, value] : pings->Members()) {
+        int ping = 0;
+        if (!config::ReadInt(*pings, datacenter.c_str(), ping, error, 0)) {
+            return false;
+        }
+        auto* dc = player.add_pings();
+        dc->set_datacenter(datacenter);
+        dc->set_ping_ms(ping);
+    }
+    return true;
+}
+
+// One JSON object per line, e.g. {"t_ms":10,"op":"enqueue","id":"p1","mmr":1500}, or a
+// session marker {"op":"session","started_unix_ms":...}, which sets `session_marker`.
+bool ParseEvent(const std::string& line, ArrivalEvent& event, bool& session_marker, ConfigError* error) {
+    ConfigValue root;
+    if (!ConfigParser::Parse(line, root, error) || !config::CheckKnownKeys(root, kEventKeys, error)) {
+        return false;
+    }
+    const ConfigValue* op_value = root.Find("op");
+    session_marker = op_value && op_value->type() == ConfigValue::Type::String && op_value->AsString() == kSessionOp;
+    if (session_marker) {
+        std::int64_t started_unix_ms = 0;
+        return config::ReadInt64(root, "started_unix_ms", started_unix_ms, error);
+    }
+    if (!root.Find("t_ms") || !root.Find("op") || !root.Find("id")) {
+        return config::Fail(error, ConfigError::Kind::TypeMismatch, 0, "t_ms, op and id are required");
+    }
+
+    std::string op;
+    std::string id;
+    std::string region;
+    std::string queue_id;
+    int mmr = 0;
+    int ping = 0;
+    int ping_na = 0;
+    int ping_eu = 0;
+    int ping_asia = 0;
+    if (!config::ReadInt64(root, "t_ms", event.t_ms, error) ||
+        !config::ReadString(root, "op", op, error) ||
+        !config::ReadString(root, "id", id, error) ||
+        !config::ReadString(root, "region", region, error) ||
+        !config::ReadString(root, "queue_id", queue_id, error) ||
+        !config::ReadInt(root, "mmr", mmr, error) ||
+        !config::ReadInt(root, "ping", ping, error) ||
+        !config::ReadInt(root, "ping_na", ping_na, error) ||
+        !config::ReadInt(root, "ping_eu", ping_eu, error) ||
+        !config::ReadInt(root, "ping_asia", ping_asia, error) ||
+        !ReadPings(root, event.player, error)) {
+        return false;
+    }
+    if (op == "enqueue") {
+        event.type = ArrivalEvent::Type::Enqueue;
+    } else if (op == "cancel") {
+        event.type = ArrivalEvent::Type::Cancel;
+    } else {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, root.Find("op")->line(),
+                            "op: expected \"enqueue\" or \"cancel\"");
+    }
+    if (id.empty()) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, root.Find("id")->line(), "id: must not be empty");
+    }
+
+    event.player.set_id(std::move(id));
+    event.player.set_region(std::move(region));
+    event.player.set_queue_id(std::move(queue_id));
+    event.player.set_mmr(mmr);
+    event.player.set_ping(ping);
+    event.player.set_ping_na(ping_na);
+    event.player.set_ping_eu(ping_eu);
+    event.player.set_ping_asia(ping_asia);
+    return true;
+}
+
+}  // namespace
+
+ArrivalTraceWriter::ArrivalTraceWriter(const std::string& path)
+    : out_(path, std::ios::app) {
+    if (!out_.is_open()) {
+        return;
+    }
+    const auto started_unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    out_ << "{\"op\":\"" << kSessionOp << "\",\"started_unix_ms\":" << started_unix_ms << "}\n";
+}
+
+void ArrivalTraceWriter::RecordEnqueue(std::int64_t t_ms, const matchmaking::Player& player) {
+    if (!out_.is_open()) {
+        return;
+    }
+    out_ << "{\"t_ms\":" << t_ms
+         << ",\"op\":\"enqueue\""
+         << ",\"id\":" << config::Quote(player.id())
+         << ",\"mmr\":" << player.mmr()
+         << ",\"ping\":" << player.ping()
+         << ",\"region\":" << config::Quote(player.region())
+         << ",\"ping_na\":" << player.ping_na()
+         << ",\"ping_eu\":" << player.ping_eu()
+         << ",\"ping_asia\":" << player.ping_asia();
+    if (!player.queue_id().empty()) {
+        out_ << ",\"queue_id\":" << config::Quote(player.queue_id());
+    }
+    if (player.pings_size() > 0) {
+        out_ << ",\"pings\":{";
+        for (int d = 0; d < player.pings_size(); ++d) {
+            out_ << (d > 0 ? "," : "") << config::Quote(player.pings(d).datacenter()) << ':'
+                 << player.pings(d).ping_ms();
+        }
+        out_ << '}';
+    }
+    out_ << "}\n";
+}
+
+void ArrivalTraceWriter::RecordCancel(std::int64_t t_ms, const std::string& id) {
+    if (!out_.is_open()) {
+        return;
+    }
+    out_ << "{\"t_ms\":" << t_ms
+         << ",\"op\":\"cancel\""
+         << ",\"id\":" << config::Quote(id)
+         << "}\n";
+}
+
+bool ArrivalTraceReader::Load(const std::string& path, std::vector<ArrivalEvent>& events, std::string* error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    std::uint32_t session = 0;
+    bool session_has_events = false;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        ArrivalEvent event;
+        bool session_marker = false;
+        ConfigError parse_error;
+        if (!ParseEvent(line, event, session_marker, &parse_error)) {
+            if (error) *error = path + ":" + std::to_string(line_number) + ": malformed trace event: " + parse_error.message;
+            return false;
+        }
+        if (session_marker) {
+            if (session_has_events) {
+                ++session;
+                session_has_events = false;
+            }
+            continue;
+        }
+        event.session = session;
+        session_has_events = true;
+        events.push_back(std::move(event));
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ArrivalEvent& a, const ArrivalEvent& b) {
+                         return a.session != b.session ? a.session < b.session : a.t_ms < b.t_ms;
+                     });
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "matchmaker.pb.h"
+
+// One recorded queue operation. `t_ms` is relative to the start of the engine that
+// recorded it, so it restarts with each session.
+struct ArrivalEvent {
+    enum class Type {
+        Enqueue,
+        Cancel,
+    };
+
+    std::int64_t t_ms = 0;
+    // Each writer that opens the file starts a new session; events of one session
+    // never share a timeline with another's.
+    std::uint32_t session = 0;
+    Type type = Type::Enqueue;
+    matchmaking::Player player;  // only `id` is set for cancels
+};
+
+// Appends Enqueue/Cancel operations to a JSONL trace that match_replay can feed back
+// through the engine. Opening the file appends a session marker first.
+class ArrivalTraceWriter {
+public:
+    explicit ArrivalTraceWriter(const std::string& path);
+
+    bool IsOpen() const { return out_.is_open(); }
+    void RecordEnqueue(std::int64_t t_ms, const matchmaking::Player& player);
+    void RecordCancel(std::int64_t t_ms, const std::string& id);
+
+private:
+    std::ofstream out_;
+};
+
+class ArrivalTraceReader {
+public:
+    // Loads every event in `path`, sorted by session and then by time. On failure
+    // `error` names the offending line.
+    static bool Load(const std::string& path, std::vector<ArrivalEvent>& events, std::string* error);
+};
@@ -0,0 +1,162 @@
+#include "ConfigWatcher.h"
+
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Editors and deploy tools often write a file in several steps; wait for writes to
+// settle before reporting a change.
+constexpr std::chrono::milliseconds kSettleTime(100);
+
+struct FileStamp {
+    bool exists = false;
+    off_t size = 0;
+    long long mtime_ns = 0;
+
+    bool operator==(const FileStamp&) const = default;
+};
+
+FileStamp StatFile(const std::string& path) {
+    FileStamp stamp;
+    struct stat st{};
+    if (stat(path.c_str(), &st) == 0) {
+        stamp.exists = true;
+        stamp.size = st.st_size;
+#ifdef __linux__
+        stamp.mtime_ns = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+        stamp.mtime_ns = static_cast<long long>(st.st_mtime) * 1000000000LL;
+#endif
+    }
+    return stamp;
+}
+
+void SplitPath(const std::string& path, std::string& dir, std::string& name) {
+    std::size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        dir = ".";
+        name = path;
+    } else {
+        dir = slash == 0 ? "/" : path.substr(0, slash);
+        name = path.substr(slash + 1);
+    }
+}
+
+}  // namespace
+
+ConfigWatcher::ConfigWatcher(std::string path,
+                             Callback on_change,
+                             std::chrono::milliseconds poll_interval)
+    : path_(std::move(path)),
+      on_change_(std::move(on_change)),
+      poll_interval_(poll_interval) {}
+
+ConfigWatcher::~ConfigWatcher() { Stop(); }
+
+void ConfigWatcher::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+#ifdef __linux__
+    std::string dir;
+    std::string name;
+    SplitPath(path_, dir, name);
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ >= 0 &&
+        inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+
+    if (inotify_fd_ >= 0) {
+        worker_ = std::thread(&ConfigWatcher::RunInotify, this);
+    } else {
+        worker_ = std::thread(&ConfigWatcher::RunPolling, this);
+    }
+}
+
+void ConfigWatcher::Stop() {
+    running_ = false;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+}
+
+void ConfigWatcher::RunInotify() {
+#ifdef __linux__
+    std::string dir;
+    std::string name;
+    SplitPath(path_, dir, name);
+
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+    auto last_event = std::chrono::steady_clock::now();
+
+    while (running_) {
+        pollfd pfd{inotify_fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, static_cast<int>(kSettleTime.count()));
+
+        if (ready > 0) {
+            for (;;) {
+                ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
+                if (len <= 0) {
+                    break;
+                }
+                for (char* p = buffer; p < buffer + len;) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    if (event->len > 0 && name == event->name) {
+                        pending = true;
+                        last_event = std::chrono::steady_clock::now();
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+        if (pending && std::chrono::steady_clock::now() - last_event >= kSettleTime) {
+            pending = false;
+            on_change_();
+        }
+    }
+#endif
+}
+
+void ConfigWatcher::RunPolling() {
+    FileStamp last = StatFile(path_);
+    while (running_) {
+        auto deadline = std::chrono::steady_clock::now() + poll_interval_;
+        while (running_ && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        if (!running_) {
+            break;
+        }
+
+        FileStamp current = StatFile(path_);
+        if (current == last || !current.exists) {
+            continue;
+        }
+        // Re-check after the settle time so a half-written file is not reported.
+        std::this_thread::sleep_for(kSettleTime);
+        FileStamp settled = StatFile(path_);
+        if (settled != current) {
+            continue;
+        }
+        last = settled;
+        on_change_();
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Invokes a callback on its own thread whenever the watched file changes. Uses inotify
+// on the file's directory (so editors that save via rename are seen) and falls back to
+// polling size/mtime when inotify is unavailable.
+class ConfigWatcher {
+public:
+    using Callback = std::function<void()>;
+
+    ConfigWatcher(std::string path,
+                  Callback on_change,
+                  std::chrono::milliseconds poll_interval = std::chrono::milliseconds(1000));
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    void Start();
+    void Stop();
+
+    bool UsingInotify() const { return inotify_fd_ >= 0; }
+
+private:
+    void RunInotify();
+    void RunPolling();
+
+    std::string path_;
+    Callback on_change_;
+    std::chrono::milliseconds poll_interval_;
+
+    int inotify_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
@@ -1,16 +1,65 @@
 #include "Engine/Engine.h"
+#include <algorithm>
 #include <chrono>
-#include <iostream>
 
-#include "MatchBuilder.h"
+#include "common/Logger.h"
 using namespace matchmaking;
 
-Engine::Engine()
-    : config_(EngineConfig::LoadFromFile("config/server_config.json")),
-      persistence_(config_.matches_path) {}
-Engine::~Engine() { Stop(); }
+namespace {
+
+// Formed matches the delivery stage may fall behind by before the tick waits for it.
+constexpr std::size_t kPipelineCapacity = 4096;
+
+// Wait estimator slot for a home region; names outside the table share the last one.
+std::size_t RegionSlot(const RegionTable& regions, const std::string& region) {
+    const int index = regions.IndexOf(region);
+    return index < 0 ? kMaxRegions : static_cast<std::size_t>(index);
+}
+
+}  // namespace
+
+Engine::Engine(const EngineConfig& config, std::shared_ptr<EngineClock> clock)
+    : settings_(EngineSettings::Build(config)),
+      workers_(static_cast<std::size_t>(std::max(config.matching_threads, 1))),
+      pendingMatches_(std::chrono::milliseconds(config.pending_match_ttl_ms),
+                      static_cast<std::size_t>(config.pending_match_max_mb) << 20),
+      admission_(AdmissionLimits::FromConfig(config)),
+      startup_node_id_(config.node_id),
+      startup_matching_threads_(config.matching_threads),
+      clock_(std::move(clock)),
+      start_(clock_->Now()),
+      next_tick_due_ms_(config.tick_interval_ms),
+      persistence_(config.matches_path),
+      match_ids_(config.node_id >= 0 ? config.node_id : MatchIdGenerator::DefaultNode()),
+      pipeline_([this](FormedMatch& m) { DeliverMatch(m); }, [this](FormedMatch& m) { PersistMatch(m); },
+                kPipelineCapacity) {
+    for (const auto& queue : settings_->queues) {
+        auto playlist = std::make_unique<Playlist>();
+        playlist->id = queue.id;
+        playlist->rules = queue.rules;
+        playlists_.push_back(std::move(playlist));
+    }
+    if (!config.arrival_trace_path.empty()) {
+        trace_ = std::make_unique<ArrivalTraceWriter>(config.arrival_trace_path);
+    }
+    auto initial_metrics = std::make_shared<EngineMetrics>();
+    initial_metrics->regions = config.regions;
+    for (const auto& queue : settings_->queues) {
+        initial_metrics->queues.push_back(PlaylistMetrics{queue.id, queue.rules->config.team_size, 0, 0});
+    }
+    published_metrics_.store(std::move(initial_metrics));
+    auto empty_queue = std::make_shared<QueueSummary>();
+    empty_queue->regions = config.regions;
+    published_queue_.store(std::move(empty_queue));
+}
+
+Engine::~Engine() {
+    Stop();
+    delete staged_settings_.exchange(nullptr);
+}
 
 void Engine::Start() {
+    pipeline_.Start();
     running_ = true;
     worker_ = std::thread(&Engine::TickLoop, this);
 }
@@ -18,105 +67,434 @@ void Engine::Start() {
 void Engine::Stop() {
     running_ = false;
     if (worker_.joinable()) worker_.join();
+    pipeline_.Stop();
 }
 
-void Engine::AddPlayer(const Player& player) {
-    std::scoped_lock lock(mtx_);
-    queue_.push_back(PlayerEntry(player));
-    std::cout << "Players currently in queue: " << queue_.size() << std::endl;
+bool Engine::ReloadConfig(const EngineConfig& config, std::string* error) {
+    if (!config.Validate(error)) {
+        return false;
+    }
+    const char* restart_key = nullptr;
+    if (config.node_id != startup_node_id_) {
+        restart_key = "node_id";
+    } else if (config.matching_threads != startup_matching_threads_) {
+        restart_key = "matching_threads";
+    }
+    if (restart_key) {
+        if (error) {
+            *error = std::string(restart_key) + " requires restart";
+        }
+        return false;
+    }
+    const std::uint64_t version = config_version_.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto* staged = EngineSettings::Build(config, version).release();
+    // A snapshot that was staged but not yet adopted is simply superseded.
+    delete staged_settings_.exchange(staged, std::memory_order_acq_rel);
+    return true;
 }
 
-bool Engine::RemovePlayer(const std::string& id) {
-    std::scoped_lock lock(mtx_);
-    auto it = std::remove_if(queue_.begin(), queue_.end(),
-                             [&](const PlayerEntry& e) {
-                                 return e.player.id() == id;
-                             });
+std::uint64_t Engine::ConfigVersion() const {
+    return config_version_.load(std::memory_order_relaxed);
+}
+
+Engine::Playlist* Engine::FindPlaylist(const std::string& queue_id) const {
+    for (const auto& playlist : playlists_) {
+        if (!playlist->retired && (queue_id.empty() || playlist->id == queue_id)) {
+            return playlist.get();
+        }
+    }
+    return nullptr;
+}
+
+std::int64_t Engine::TickLagMs() const {
+    return std::max<std::int64_t>(0, ElapsedMs() - next_tick_due_ms_.load(std::memory_order_relaxed));
+}
+
+AdmissionDecision Engine::Admit(std::string_view client, const Player& player) {
+    AdmissionSignals signals;
+    signals.tick_lag_ms = TickLagMs();
+    const auto metrics = published_metrics_.load();
+    auto it = metrics->queue_sizes_per_region.find(player.region());
+    if (it != metrics->queue_sizes_per_region.end()) {
+        signals.region_queue = it->second;
+    }
+    const AdmissionDecision decision = admission_.Admit(client, signals, ElapsedMs());
+    if (!decision.Admitted()) {
+        MM_LOG(Debug, "player_rejected", "player_id", player.id(), "client", client, "reason",
+               AdmissionReasonName(decision.reason), "retry_after_ms", decision.retry_after_ms);
+    }
+    return decision;
+}
+
+bool Engine::AddPlayer(const Player& player) {
+    std::shared_lock playlists(playlists_mtx_);
+    Playlist* playlist = FindPlaylist(player.queue_id());
+    if (!playlist) {
+        MM_LOG(Debug, "player_rejected", "player_id", player.id(), "queue_id", player.queue_id(),
+               "reason", "unknown_queue");
+        return false;
+    }
+    // The client's ping list may repeat datacenters or name unknown ones. The queue, the
+    // matches and the trace keep one resolved ping per configured datacenter instead.
+    const RegionTable& regions = settings_->regions;
+    const RegionPings resolved = regions.Resolve(player);
+    Player stored = player;
+    stored.clear_pings();
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+        auto* dc = stored.add_pings();
+        dc->set_datacenter(regions.Name(r));
+        dc->set_ping_ms(resolved.ping[r]);
+    }
+    std::scoped_lock lock(playlist->mtx);
+    playlist->queue.ResolvePings(playlist->queue.Push(stored, ElapsedMs()), regions);
+    playlist->mmr_histogram.Add(player.mmr());
+    {
+        std::scoped_lock trace_lock(mtx_);
+        if (trace_) {
+            trace_->RecordEnqueue(ElapsedMs(), stored);
+        }
+    }
+    MM_LOG(Debug, "player_enqueued", "player_id", player.id(), "queue_id", playlist->id,
+           "queue_size", playlist->queue.size());
+    return true;
+}
 
-    if (it != queue_.end()) {
-        queue_.erase(it, queue_.end());
+bool Engine::RemovePlayer(const std::string& id) {
+    std::shared_lock playlists(playlists_mtx_);
+    for (const auto& playlist : playlists_) {
+        std::scoped_lock lock(playlist->mtx);
+        auto& queue = playlist->queue;
+        const std::size_t removed = queue.RemoveIf([&](const PlayerEntry& e) {
+            if (queue.PlayerOf(e).id() != id) {
+                return false;
+            }
+            playlist->mmr_histogram.Remove(e.mmr);
+            return true;
+        });
+        if (removed == 0) {
+            continue;
+        }
+        std::scoped_lock trace_lock(mtx_);
+        if (trace_) {
+            trace_->RecordCancel(ElapsedMs(), id);
+        }
         return true;
     }
     return false;
 }
 
-std::vector<Match> Engine::GetMatchesForPlayer(const std::string& id) {
+std::vector<PendingMatchStore::MatchHandle> Engine::GetMatchesForPlayer(const std::string& id) {
     std::scoped_lock lock(mtx_);
-    auto it = pendingMatches_.find(id);
-    if (it == pendingMatches_.end()) {
-        return {};
-    }
-    auto result = it->second;
-    pendingMatches_.erase(it);
-    return result;
+    return pendingMatches_.Take(id);
 }
 
-EngineMetrics Engine::GetMetricsSnapshot() const {
+std::vector<PendingMatchStore::MatchHandle> Engine::PeekMatchesForPlayer(const std::string& id) const {
     std::scoped_lock lock(mtx_);
-    return metrics_;
+    return pendingMatches_.Peek(id);
 }
 
-void Engine::FillQueueSnapshot(matchmaking::QueueSnapshot& snapshot) const {
+bool Engine::AcknowledgeMatch(const std::string& player_id, const std::string& match_id) {
     std::scoped_lock lock(mtx_);
-    auto now = std::chrono::steady_clock::now();
-    for (const auto& entry : queue_) {
-        auto waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.queuedAt).count();
-        if (waited_ms < 0) {
-            waited_ms = 0;
+    return pendingMatches_.Acknowledge(player_id, match_id);
+}
+
+EngineMetrics Engine::GetMetricsSnapshot() const {
+    return *published_metrics_.load();
+}
+
+std::shared_ptr<const QueueSummary> Engine::GetQueueSummary() const {
+    return published_queue_.load();
+}
+
+void Engine::FillQueueSnapshot(matchmaking::QueueSnapshot& snapshot, const QueueQuery& query) const {
+    FillQueuePage(*published_queue_.load(), query, snapshot);
+}
+
+bool Engine::GetQueueStatus(const std::string& player_id, QueueStatus& status) const {
+    return FillQueueStatus(*published_queue_.load(), player_id, ElapsedMs(), status);
+}
+
+void Engine::PublishSnapshots(std::int64_t now_ms) {
+    ++step_count_;
+    const bool publish_queue =
+        step_count_ == 1 || now_ms - last_queue_publish_ms_ >= settings_->config.queue_snapshot_interval_ms;
+
+    auto summary = std::make_shared<QueueSummary>();
+    metrics_.queue_sizes_per_region.clear();
+    metrics_.queues.clear();
+    for (const auto& playlist : playlists_) {
+        std::scoped_lock lock(playlist->mtx);
+        for (const auto& entry : playlist->queue) {
+            metrics_.queue_sizes_per_region[playlist->queue.PlayerOf(entry).region()] += 1;
+        }
+        if (!playlist->retired || !playlist->queue.empty()) {
+            metrics_.queues.push_back(PlaylistMetrics{playlist->id, playlist->rules->config.team_size,
+                                                      playlist->queue.size(), playlist->matches,
+                                                      playlist->budget_exhausted});
+        }
+        if (!publish_queue) {
+            continue;
+        }
+        const std::size_t merged = summary->players.size();
+        playlist->waits.Refresh(now_ms);
+        std::unordered_map<std::string, std::uint32_t> region_counts;
+        std::vector<std::size_t> bucket_counts(WaitEstimator::kBuckets);
+        for (auto& entry : playlist->queue) {
+            playlist->queue.ResolvePings(entry, settings_->regions);
+            const Player& p = playlist->queue.PlayerOf(entry);
+            QueueSummaryEntry summary_entry{p.id(), playlist->id, p.region(), entry.mmr,
+                                            playlist->queue.PingsOf(entry), entry.queued_ms};
+            summary_entry.position = ++region_counts[p.region()];
+            const std::size_t region = entry.region == PlayerEntry::kNoRegion ? kMaxRegions : entry.region;
+            const std::size_t ahead = bucket_counts[WaitEstimator::BucketOf(region, entry.mmr)]++;
+            summary_entry.estimated_wait_ms =
+                playlist->waits.Estimate(region, entry.mmr, now_ms - entry.queued_ms, ahead);
+            summary->players.push_back(std::move(summary_entry));
+        }
+        for (std::size_t i = merged; i < summary->players.size(); ++i) {
+            summary->players[i].region_queue = region_counts[summary->players[i].region];
+        }
+        // Each playlist is in enqueue order; merging keeps the copy in one global order.
+        std::inplace_merge(summary->players.begin(), summary->players.begin() + static_cast<std::ptrdiff_t>(merged),
+                           summary->players.end(), [](const QueueSummaryEntry& a, const QueueSummaryEntry& b) {
+                               return a.queued_ms < b.queued_ms;
+                           });
+    }
+
+    auto metrics = std::make_shared<EngineMetrics>(metrics_);
+    metrics->version = step_count_;
+    metrics->regions = settings_->config.regions;
+    {
+        std::scoped_lock lock(mtx_);
+        metrics->pending = pendingMatches_.Stats();
+    }
+    metrics->admission = admission_.Stats(ElapsedMs());
+    published_metrics_.store(std::move(metrics));
+
+    if (!publish_queue) {
+        return;
+    }
+    summary->index.reserve(summary->players.size());
+    for (std::size_t i = 0; i < summary->players.size(); ++i) {
+        summary->index.try_emplace(summary->players[i].id, i);
+    }
+    summary->version = step_count_;
+    summary->taken_ms = now_ms;
+    summary->regions = settings_->config.regions;
+    last_queue_publish_ms_ = now_ms;
+    published_queue_.store(std::move(summary));
+}
+
+std::int64_t Engine::ElapsedMs() const {
+    return ToMs(clock_->Now());
+}
+
+std::int64_t Engine::ToMs(EngineClock::time_point t) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t - start_).count();
+}
+
+void Engine::AdoptStagedSettings() {
+    EngineSettings* staged = staged_settings_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!staged) {
+        return;
+    }
+    std::shared_ptr<const EngineSettings> next(staged);
+    const EngineConfig& current = settings_->config;
+    if (next->config.matches_path != current.matches_path) {
+        // Matches formed under the old config still go to the old file.
+        pipeline_.Flush();
+        persistence_ = MatchPersistence(next->config.matches_path);
+    }
+    std::scoped_lock lock(playlists_mtx_, mtx_);
+    if (next->config.arrival_trace_path != current.arrival_trace_path) {
+        trace_.reset();
+        if (!next->config.arrival_trace_path.empty()) {
+            trace_ = std::make_unique<ArrivalTraceWriter>(next->config.arrival_trace_path);
+        }
+    }
+    pendingMatches_.SetLimits(std::chrono::milliseconds(next->config.pending_match_ttl_ms),
+                              static_cast<std::size_t>(next->config.pending_match_max_mb) << 20);
+    admission_.SetLimits(AdmissionLimits::FromConfig(next->config));
+
+    // Configured playlists take the new config's order; dropped ones go last and retire.
+    std::vector<std::unique_ptr<Playlist>> playlists;
+    for (const auto& queue : next->queues) {
+        auto it = std::find_if(playlists_.begin(), playlists_.end(), [&](const auto& p) { return p && p->id == queue.id; });
+        std::unique_ptr<Playlist> playlist;
+        if (it != playlists_.end()) {
+            playlist = std::move(*it);
+        } else {
+            playlist = std::make_unique<Playlist>();
+            playlist->id = queue.id;
+        }
+        playlist->rules = queue.rules;
+        playlist->retired = false;
+        // The region order and the search's resume point belong to the old rules.
+        playlist->next_region = 0;
+        playlist->search.suspended = false;
+        playlist->pass.valid = false;
+        playlists.push_back(std::move(playlist));
+    }
+    retired_playlists_ = 0;
+    for (auto& playlist : playlists_) {
+        if (playlist && !playlist->queue.empty()) {
+            if (!playlist->retired) {
+                MM_LOG(Info, "queue_retired", "queue_id", playlist->id, "players", playlist->queue.size());
+            }
+            playlist->retired = true;
+            ++retired_playlists_;
+            playlists.push_back(std::move(playlist));
+        }
+    }
+    playlists_ = std::move(playlists);
+    if (next->regions.Key() != settings_->regions.Key()) {
+        // Estimates are kept per region index, which the new table may reassign.
+        for (auto& playlist : playlists_) {
+            playlist->waits.Reset();
         }
-        auto* qp = snapshot.add_players();
-        qp->set_id(entry.player.id());
-        qp->set_region(entry.player.region());
-        qp->set_mmr(entry.player.mmr());
-        qp->set_ping_na(entry.player.ping_na());
-        qp->set_ping_eu(entry.player.ping_eu());
-        qp->set_ping_asia(entry.player.ping_asia());
-        qp->set_waited_seconds(static_cast<double>(waited_ms) / 1000.0);
     }
+    MM_LOG(Info, "config_applied", "version", next->version, "queues", next->queues.size());
+    settings_ = std::move(next);
+}
+
+void Engine::DropEmptyRetiredPlaylists() {
+    if (retired_playlists_ == 0) {
+        return;
+    }
+    std::scoped_lock lock(playlists_mtx_);
+    auto it = std::remove_if(playlists_.begin(), playlists_.end(), [](const auto& playlist) {
+        return playlist->retired && playlist->queue.empty();
+    });
+    retired_playlists_ -= static_cast<std::size_t>(playlists_.end() - it);
+    playlists_.erase(it, playlists_.end());
+}
+
+void Engine::DeliverMatch(FormedMatch& formed) {
+    formed.handle = std::make_shared<const PendingMatch>(std::move(formed.match));
+    std::scoped_lock lock(mtx_);
+    pendingMatches_.Add(formed.handle, formed.formed_at);
+}
+
+void Engine::PersistMatch(FormedMatch& formed) {
+    const Match& match = formed.handle->match;
+    const MatchMetrics& metrics = formed.metrics;
+    persistence_.Append(match);
+    MM_LOG(Info, "match_created", "match_id", match.match_id(), "queue_id", match.queue_id(), "region",
+           formed.region, "datacenter", match.datacenter(), "datacenter_ping_ms", match.datacenter_ping_ms(),
+           "players", match.players_size(), "avg_mmr", metrics.average_mmr, "mmr_spread",
+           static_cast<double>(metrics.max_mmr - metrics.min_mmr), "avg_wait_s", metrics.average_wait_ms / 1000.0);
 }
 
 void Engine::TickLoop() {
     while (running_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.tick_interval_ms));
-        std::scoped_lock lock(mtx_);
+        std::this_thread::sleep_for(std::chrono::milliseconds(settings_->config.tick_interval_ms));
+        Step();
+    }
+}
+
+void Engine::MatchPlaylist(Playlist& playlist, std::int64_t now_ms, std::vector<FormedMatch>& out) {
+    const EngineSettings& rules = *playlist.rules;
+    const auto match_budget = static_cast<std::size_t>(rules.config.max_matches_per_tick);
+    // Measured on the steady clock rather than the engine clock: the budget bounds how
+    // long this pass holds the playlist lock.
+    const auto deadline = rules.config.tick_budget_ms > 0
+                              ? std::chrono::steady_clock::now() + std::chrono::milliseconds(rules.config.tick_budget_ms)
+                              : std::chrono::steady_clock::time_point::max();
 
-        const std::string regions[] = {"NA", "EU", "ASIA"};
-        for (const auto& region : regions) {
-            matchmaking::Match match;
-
-            while (true) {
-                MatchMetrics metrics;
-                if (MatchBuilder::BuildMatch(queue_, match, config_, region, &metrics)) {
-                    double mmr_spread = static_cast<double>(metrics.max_mmr - metrics.min_mmr);
-                    double avg_wait_seconds = metrics.average_wait_ms / 1000.0;
-                    std::cout << "Created match " << match.match_id()
-                              << " in region " << region
-                              << " with " << match.players_size()
-                              << " players"
-                              << " avg_mmr=" << metrics.average_mmr
-                              << " mmr_spread=" << mmr_spread
-                              << " avg_wait_s=" << avg_wait_seconds
-                              << std::endl;
-                    metrics_.matches_per_region[region] += 1;
-                    metrics_.last_match_average_mmr = metrics.average_mmr;
-                    metrics_.last_match_mmr_spread = mmr_spread;
-                    metrics_.last_match_average_wait_seconds = avg_wait_seconds;
-                    for (int i = 0; i < match.players_size(); ++i) {
-                        const auto& p = match.players(i);
-                        pendingMatches_[p.id()].push_back(match);
-                    }
-                    persistence_.Append(match);
-                    match = matchmaking::Match();  // reset for next
-                } else {
-                    break;
+    std::scoped_lock lock(playlist.mtx);
+    playlist.search.deadline = deadline;
+    playlist.pass.valid = false;
+    const auto& regions = rules.regions.Names();
+    if (playlist.next_region >= regions.size()) {
+        playlist.next_region = 0;
+        playlist.search.suspended = false;
+    }
+    bool worked = false;
+    for (std::size_t visited = 0; visited < regions.size(); ++visited) {
+        const std::size_t r = (playlist.next_region + visited) % regions.size();
+        for (;;) {
+            if (match_budget > 0 && out.size() >= match_budget) {
+                playlist.next_region = r;
+                return;
+            }
+            if (worked && std::chrono::steady_clock::now() >= deadline) {
+                ++playlist.budget_exhausted;
+                playlist.next_region = r;
+                return;
+            }
+            worked = true;
+            FormedMatch formed;
+            const bool built = MatchBuilder::BuildMatch(playlist.queue, formed.match, rules, regions[r], now_ms,
+                                                        &formed.metrics, &playlist.mmr_histogram, &match_ids_,
+                                                        &playlist.search, &playlist.pass);
+            if (built) {
+                for (const auto& p : formed.match.players()) {
+                    playlist.mmr_histogram.Remove(p.mmr());
                 }
+                formed.match.set_queue_id(playlist.id);
+                formed.region = regions[r];
+                out.push_back(std::move(formed));
+            }
+            if (playlist.search.out_of_time) {
+                ++playlist.budget_exhausted;
+                playlist.next_region = r;
+                return;
+            }
+            if (!built) {
+                break;
             }
         }
+    }
+    playlist.next_region = 0;
+}
 
-        metrics_.queue_sizes_per_region.clear();
-        for (const auto& entry : queue_) {
-            const std::string& region = entry.player.region();
-            metrics_.queue_sizes_per_region[region] += 1;
+std::size_t Engine::Step(std::vector<matchmaking::Match>* formed) {
+    AdoptStagedSettings();
+    DropEmptyRetiredPlaylists();
+    // Sampled once per tick. Queue entries hold engine milliseconds, so the matcher and
+    // the snapshots measure every wait against this one sample.
+    const auto now = clock_->Now();
+    const std::int64_t now_ms = ToMs(now);
+    {
+        std::scoped_lock lock(mtx_);
+        pendingMatches_.Expire(now);
+    }
+
+    std::shared_lock playlists(playlists_mtx_);
+    // Playlists are matched in parallel; the starting one rotates every tick so that with
+    // fewer threads than playlists none of them is always served last.
+    const std::size_t count = playlists_.size();
+    std::vector<std::vector<FormedMatch>> results(count);
+    const std::size_t first = count == 0 ? 0 : step_count_ % count;
+    workers_.Run(count, [&](std::size_t task) {
+        const std::size_t i = (first + task) % count;
+        MatchPlaylist(*playlists_[i], now_ms, results[i]);
+    });
+
+    std::size_t created = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        playlists_[i]->matches += results[i].size();
+        for (auto& formed_match : results[i]) {
+            const MatchMetrics& metrics = formed_match.metrics;
+            for (int j = 0; j < formed_match.match.players_size(); ++j) {
+                const Player& p = formed_match.match.players(j);
+                playlists_[i]->waits.RecordMatched(RegionSlot(settings_->regions, p.region()), p.mmr(),
+                                                   metrics.wait_ms[static_cast<std::size_t>(j)]);
+            }
+            metrics_.matches_per_region[formed_match.region] += 1;
+            metrics_.last_match_average_mmr = metrics.average_mmr;
+            metrics_.last_match_mmr_spread = static_cast<double>(metrics.max_mmr - metrics.min_mmr);
+            metrics_.last_match_average_wait_seconds = metrics.average_wait_ms / 1000.0;
+            ++created;
+            if (formed) {
+                formed->push_back(formed_match.match);
+            }
+            formed_match.formed_at = now;
+            pipeline_.Push(std::move(formed_match));
         }
     }
+    PublishSnapshots(now_ms);
+    next_tick_due_ms_.store(ElapsedMs() + settings_->config.tick_interval_ms, std::memory_order_relaxed);
+
+    return created;
 }
@@ -1,46 +1,177 @@
 #pragma once
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 #include <atomic>
 #include "matchmaker.pb.h"
-#include "PlayerEntry.h"
+#include "PlayerQueue.h"
+#include "AdmissionController.h"
+#include "ArrivalTrace.h"
+#include "EngineClock.h"
 #include "EngineConfig.h"
+#include "EngineSettings.h"
+#include "MatchBuilder.h"
+#include "MatchIdGenerator.h"
+#include "MatchPipeline.h"
 #include "MatchPersistence.h"
+#include "MmrHistogram.h"
+#include "PendingMatchStore.h"
+#include "QueueSummary.h"
+#include "WaitEstimator.h"
+#include "WorkerPool.h"
+
+struct PlaylistMetrics {
+    std::string id;
+    int team_size = 0;
+    std::size_t queue_size = 0;
+    std::size_t matches = 0;
+    // Ticks whose matching pass ran out of tick_budget_ms and was suspended.
+    std::size_t budget_exhausted = 0;
+};
 
 struct EngineMetrics {
+    // Step that published this snapshot.
+    std::uint64_t version = 0;
+    // Configured regions, in tick order.
+    std::vector<std::string> regions;
     std::unordered_map<std::string, std::size_t> queue_sizes_per_region;
     std::unordered_map<std::string, std::size_t> matches_per_region;
+    // Configured playlists in config order; the region counts above sum over them.
+    std::vector<PlaylistMetrics> queues;
     double last_match_average_mmr = 0.0;
     double last_match_mmr_spread = 0.0;
     double last_match_average_wait_seconds = 0.0;
+    PendingMatchStats pending;
+    AdmissionStats admission;
 };
 
 class Engine {
 public:
-    Engine();
+    Engine(const EngineConfig& config, std::shared_ptr<EngineClock> clock);
     ~Engine();
 
     void Start();
     void Stop();
 
-    void AddPlayer(const matchmaking::Player& player);
+    // Runs one matching pass on the calling thread. The tick thread calls this after
+    // every sleep; offline drivers call it directly instead of Start(). Matches formed
+    // during the pass are appended to `formed` when it is non-null. Once started, the
+    // pass hands its matches to the delivery and persistence threads and returns without
+    // waiting for them; without Start() both stages finish before Step returns.
+    std::size_t Step(std::vector<matchmaking::Match>* formed = nullptr);
+
+    // Validates `config`, precomputes its relaxation curves and publishes it to the
+    // tick thread, which adopts it at the start of its next pass. Safe to call from
+    // any thread; the tick thread never blocks on it. Fails if `config` changes node_id
+    // or matching_threads, which take effect only at construction.
+    bool ReloadConfig(const EngineConfig& config, std::string* error = nullptr);
+    std::uint64_t ConfigVersion() const;
+
+    // Admission control for `client` (its address) enqueueing `player`, judged on the live
+    // tick lag and the region depth of the last published snapshot. Offline drivers skip
+    // it and call AddPlayer directly.
+    AdmissionDecision Admit(std::string_view client, const matchmaking::Player& player);
+    // How far past its due time the next tick is; 0 while ticks are on schedule.
+    std::int64_t TickLagMs() const;
+
+    // Fails when player.queue_id names no configured playlist.
+    bool AddPlayer(const matchmaking::Player& player);
     bool RemovePlayer(const std::string& id);
-    std::vector<matchmaking::Match> GetMatchesForPlayer(const std::string& id);
+    // Removes and returns the player's undelivered matches.
+    std::vector<PendingMatchStore::MatchHandle> GetMatchesForPlayer(const std::string& id);
+    // Returns them without removing; each stays until AcknowledgeMatch or its TTL.
+    std::vector<PendingMatchStore::MatchHandle> PeekMatchesForPlayer(const std::string& id) const;
+    bool AcknowledgeMatch(const std::string& player_id, const std::string& match_id);
+
+    // Readers are served from snapshots the tick publishes at the end of each Step
+    // (the queue at most every queue_snapshot_interval_ms); they never take the engine
+    // lock, so polling them cannot stall matching.
     EngineMetrics GetMetricsSnapshot() const;
-    void FillQueueSnapshot(matchmaking::QueueSnapshot& snapshot) const;
+    std::shared_ptr<const QueueSummary> GetQueueSummary() const;
+    void FillQueueSnapshot(matchmaking::QueueSnapshot& snapshot, const QueueQuery& query = {}) const;
+    // Position and estimated wait of a queued player, from the latest queue snapshot.
+    // Fails when the player was not queued when it was taken.
+    bool GetQueueStatus(const std::string& player_id, matchmaking::QueueStatus& status) const;
 
 private:
+    // One playlist's queue. Each has its own lock, so enqueues into one playlist never
+    // wait for another's matching pass.
+    struct Playlist {
+        std::string id;
+        // Replaced only by AdoptStagedSettings.
+        std::shared_ptr<const EngineSettings> rules;
+        // Dropped from the config: still matched on its last rules until empty, but
+        // closed to new players.
+        bool retired = false;
+        // Tick-thread only.
+        std::size_t matches = 0;
+        std::size_t budget_exhausted = 0;
+        WaitEstimator waits;
+
+        std::mutex mtx;
+        // In enqueue order; the matcher's emergency stage depends on it.
+        PlayerQueue queue;
+        // Kept in step with queue so the matcher can reject sparse MMR windows cheaply.
+        MmrHistogram mmr_histogram;
+        // Where a pass cut short by a budget resumes: the region (as an index into the
+        // rules' table) and, within it, the suspended seed search.
+        std::size_t next_region = 0;
+        MatchSearch search;
+        // Per-region matcher state, built by a pass's first BuildMatch call for the region.
+        MatchPass pass;
+    };
+
     void TickLoop();
 
-    std::deque<PlayerEntry> queue_;
-    std::unordered_map<std::string, std::vector<matchmaking::Match>> pendingMatches_;
-    EngineConfig config_;
+    void AdoptStagedSettings();
+    void DropEmptyRetiredPlaylists();
+    Playlist* FindPlaylist(const std::string& queue_id) const;
+    void MatchPlaylist(Playlist& playlist, std::int64_t now_ms, std::vector<FormedMatch>& out);
+    void PublishSnapshots(std::int64_t now_ms);
+    void DeliverMatch(FormedMatch& formed);
+    void PersistMatch(FormedMatch& formed);
+    std::int64_t ElapsedMs() const;
+    // Milliseconds from engine start to `t`.
+    std::int64_t ToMs(EngineClock::time_point t) const;
+
+    // Lock order: playlists_mtx_, then a Playlist::mtx, then mtx_. playlists_mtx_ is held
+    // exclusively only to change the playlist set or settings_.
+    mutable std::shared_mutex playlists_mtx_;
+    std::vector<std::unique_ptr<Playlist>> playlists_;
+    std::size_t retired_playlists_ = 0;
+    // Owned by the tick thread (or whoever drives Step); replaced only by AdoptStagedSettings.
+    std::shared_ptr<const EngineSettings> settings_;
+    WorkerPool workers_;
+    PendingMatchStore pendingMatches_;
+    AdmissionController admission_;
+    // Single-slot mailbox from ReloadConfig to the tick thread.
+    std::atomic<EngineSettings*> staged_settings_{nullptr};
+    std::atomic<std::uint64_t> config_version_{0};
+    // Read only at construction; ReloadConfig refuses to change them.
+    const int startup_node_id_;
+    const int startup_matching_threads_;
+    std::shared_ptr<EngineClock> clock_;
+    EngineClock::time_point start_;
+    // ElapsedMs() at which the next tick should start: the end of the last pass plus
+    // tick_interval_ms.
+    std::atomic<std::int64_t> next_tick_due_ms_;
+    // Persistence stage only; replaced by AdoptStagedSettings after flushing the pipeline.
     MatchPersistence persistence_;
+    MatchIdGenerator match_ids_;
+    std::unique_ptr<ArrivalTraceWriter> trace_;
     EngineMetrics metrics_;
+    std::uint64_t step_count_ = 0;
+    std::int64_t last_queue_publish_ms_ = 0;
+    std::atomic<std::shared_ptr<const EngineMetrics>> published_metrics_;
+    std::atomic<std::shared_ptr<const QueueSummary>> published_queue_;
 
+    // Guards pendingMatches_ and trace_.
     mutable std::mutex mtx_;
     std::atomic<bool> running_{false};
     std::thread worker_;
+    // Last, so its threads stop before anything they use is destroyed.
+    MatchPipeline pipeline_;
 };
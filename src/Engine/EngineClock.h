@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// Time source for the engine. Production uses the steady clock; tests and the
+// replay driver inject a manual clock so queue waits follow virtual time.
+class EngineClock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~EngineClock() = default;
+    virtual time_point Now() const = 0;
+};
+
+class SteadyEngineClock final : public EngineClock {
+public:
+    time_point Now() const override { return std::chrono::steady_clock::now(); }
+};
+
+class ManualEngineClock final : public EngineClock {
+public:
+    explicit ManualEngineClock(time_point start = time_point{}) : now_(start.time_since_epoch().count()) {}
+
+    time_point Now() const override {
+        return time_point(time_point::duration(now_.load(std::memory_order_relaxed)));
+    }
+
+    void Set(time_point t) { now_.store(t.time_since_epoch().count(), std::memory_order_relaxed); }
+
+    template <typename Rep, typename Period>
+    void Advance(std::chrono::duration<Rep, Period> d) {
+        now_.fetch_add(std::chrono::duration_cast<time_point::duration>(d).count(), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<time_point::rep> now_;
+};
@@ -1,57 +1,189 @@
 #include "EngineConfig.h"
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <string>
+#include <vector>
+
+#include "MatchIdGenerator.h"
+#include "RegionTable.h"
+#include "common/ConfigParser.h"
+#include "common/Logger.h"
 
 namespace {
 
-bool ExtractInt(const std::string& content, const std::string& key, int& out) {
-    std::size_t key_pos = content.find("\"" + key + "\"");
-    if (key_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t colon_pos = content.find(':', key_pos);
-    if (colon_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t start = colon_pos + 1;
-    while (start < content.size() && (content[start] == ' ' || content[start] == '\t' || content[start] == '\n' || content[start] == '\r')) {
-        ++start;
-    }
-    std::size_t end = start;
-    while (end < content.size() && (content[end] == '-' || (content[end] >= '0' && content[end] <= '9'))) {
-        ++end;
+using config::Quote;
+
+const std::vector<std::string> kEngineConfigKeys = {
+    "tick_interval_ms",
+    "matches_path",
+    "regions",
+    "datacenter_objective",
+    "max_ping_ms",
+    "ping_relax_per_second",
+    "max_ping_ms_cap",
+    "min_wait_before_match_ms",
+    "max_allowed_mmr_diff",
+    "base_mmr_window",
+    "mmr_relax_per_second",
+    "max_mmr_window",
+    "mmr_diff_relax_per_second",
+    "max_relaxed_mmr_diff",
+    "cross_region_step_ms",
+    "good_region_ping_ms",
+    "emergency_match_wait_ms",
+    "team_size",
+    "max_matches_per_tick",
+    "tick_budget_ms",
+    "queues",
+    "matching_threads",
+    "node_id",
+    "pending_match_ttl_ms",
+    "pending_match_max_mb",
+    "queue_snapshot_interval_ms",
+    "admission_max_tick_lag_ms",
+    "admission_max_region_queue",
+    "admission_max_enqueues_per_second",
+    "client_enqueues_per_second",
+    "client_enqueue_burst",
+    "admission_retry_after_ms",
+    "log_level",
+    "arrival_trace_path",
+};
+
+// Keys whose override values are taken verbatim rather than as JSON literals.
+const std::vector<std::string> kStringKeys = {
+    "matches_path",
+    "datacenter_objective",
+    "log_level",
+    "arrival_trace_path",
+};
+
+// Matching keys a queue can set for itself; the rest are shared by every queue.
+const std::vector<std::string> kQueueKeys = {
+    "datacenter_objective",
+    "max_ping_ms",
+    "ping_relax_per_second",
+    "max_ping_ms_cap",
+    "min_wait_before_match_ms",
+    "max_allowed_mmr_diff",
+    "base_mmr_window",
+    "mmr_relax_per_second",
+    "max_mmr_window",
+    "mmr_diff_relax_per_second",
+    "max_relaxed_mmr_diff",
+    "cross_region_step_ms",
+    "good_region_ping_ms",
+    "emergency_match_wait_ms",
+    "team_size",
+    "max_matches_per_tick",
+    "tick_budget_ms",
+};
+
+bool IsStringKey(const std::string& key) {
+    return std::find(kStringKeys.begin(), kStringKeys.end(), key) != kStringKeys.end();
+}
+
+// "queues": {"ranked": {"team_size": 5}, ...}. Each queue's members are kept as override
+// pairs; their ranges are checked when the queue is resolved.
+bool ReadQueues(const ConfigValue& root, std::vector<QueueConfig>& out, ConfigError* error) {
+    const ConfigValue* value = root.Find("queues");
+    if (!value) {
+        return true;
     }
-    if (start == end) {
-        return false;
+    if (!value->IsObject()) {
+        return config::Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                            "queues: expected an object of queue objects");
     }
-    try {
-        out = std::stoi(content.substr(start, end - start));
-    } catch (...) {
-        return false;
+    std::vector<QueueConfig> parsed;
+    for (const auto& [id, rules] : value->Members()) {
+        if (!rules.IsObject()) {
+            return config::Fail(error, ConfigError::Kind::TypeMismatch, rules.line(),
+                                "queues." + id + ": expected an object");
+        }
+        if (!config::CheckKnownKeys(rules, kQueueKeys, error, "queues." + id)) {
+            return false;
+        }
+        QueueConfig queue;
+        queue.id = id;
+        for (const auto& [key, rule] : rules.Members()) {
+            const bool is_string = IsStringKey(key);
+            if (rule.type() != (is_string ? ConfigValue::Type::String : ConfigValue::Type::Number)) {
+                return config::Fail(error, ConfigError::Kind::TypeMismatch, rule.line(),
+                                    "queues." + id + "." + key + (is_string ? ": expected a string" : ": expected a number"));
+            }
+            if (is_string) {
+                queue.rules.emplace_back(key, rule.AsString());
+                continue;
+            }
+            char text[32];
+            const double number = rule.AsNumber();
+            auto [end, ec] = number == std::trunc(number) && std::abs(number) < 1e15
+                                 ? std::to_chars(text, text + sizeof(text), static_cast<long long>(number))
+                                 : std::to_chars(text, text + sizeof(text), number);
+            queue.rules.emplace_back(key, std::string(text, ec == std::errc() ? end : text));
+        }
+        parsed.push_back(std::move(queue));
     }
+    out = std::move(parsed);
     return true;
 }
 
-bool ExtractString(const std::string& content, const std::string& key, std::string& out) {
-    std::size_t key_pos = content.find("\"" + key + "\"");
-    if (key_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t colon_pos = content.find(':', key_pos);
-    if (colon_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t start = content.find('"', colon_pos + 1);
-    if (start == std::string::npos) {
+bool ReadFields(const ConfigValue& root, EngineConfig& out, ConfigError* error) {
+    using config::ReadInt;
+    using config::ReadString;
+
+    return config::CheckKnownKeys(root, kEngineConfigKeys, error) &&
+           ReadInt(root, "tick_interval_ms", out.tick_interval_ms, error, 1) &&
+           ReadString(root, "matches_path", out.matches_path, error) &&
+           config::ReadStringArray(root, "regions", out.regions, error) &&
+           ReadString(root, "datacenter_objective", out.datacenter_objective, error) &&
+           ReadInt(root, "max_ping_ms", out.max_ping_ms, error, 0) &&
+           ReadInt(root, "ping_relax_per_second", out.ping_relax_per_second, error, 0) &&
+           ReadInt(root, "max_ping_ms_cap", out.max_ping_ms_cap, error, 0) &&
+           ReadInt(root, "min_wait_before_match_ms", out.min_wait_before_match_ms, error, 0) &&
+           ReadInt(root, "max_allowed_mmr_diff", out.max_allowed_mmr_diff, error, 0) &&
+           ReadInt(root, "base_mmr_window", out.base_mmr_window, error, 0) &&
+           ReadInt(root, "mmr_relax_per_second", out.mmr_relax_per_second, error, 0) &&
+           ReadInt(root, "max_mmr_window", out.max_mmr_window, error, 0) &&
+           ReadInt(root, "mmr_diff_relax_per_second", out.mmr_diff_relax_per_second, error, 0) &&
+           ReadInt(root, "max_relaxed_mmr_diff", out.max_relaxed_mmr_diff, error, 0) &&
+           ReadInt(root, "cross_region_step_ms", out.cross_region_step_ms, error, 0) &&
+           ReadInt(root, "good_region_ping_ms", out.good_region_ping_ms, error, 0) &&
+           ReadInt(root, "emergency_match_wait_ms", out.emergency_match_wait_ms, error, 0) &&
+           ReadInt(root, "team_size", out.team_size, error, 1, kMaxTeamSize) &&
+           ReadInt(root, "max_matches_per_tick", out.max_matches_per_tick, error, 0) &&
+           ReadInt(root, "tick_budget_ms", out.tick_budget_ms, error, 0) &&
+           ReadQueues(root, out.queues, error) &&
+           ReadInt(root, "matching_threads", out.matching_threads, error, 1, kMaxMatchingThreads) &&
+           ReadInt(root, "node_id", out.node_id, error, -1, MatchIdGenerator::kMaxNode) &&
+           ReadInt(root, "pending_match_ttl_ms", out.pending_match_ttl_ms, error, 0) &&
+           ReadInt(root, "pending_match_max_mb", out.pending_match_max_mb, error, 1) &&
+           ReadInt(root, "queue_snapshot_interval_ms", out.queue_snapshot_interval_ms, error, 0) &&
+           ReadInt(root, "admission_max_tick_lag_ms", out.admission_max_tick_lag_ms, error, 0) &&
+           ReadInt(root, "admission_max_region_queue", out.admission_max_region_queue, error, 0) &&
+           ReadInt(root, "admission_max_enqueues_per_second", out.admission_max_enqueues_per_second, error, 0) &&
+           ReadInt(root, "client_enqueues_per_second", out.client_enqueues_per_second, error, 0) &&
+           ReadInt(root, "client_enqueue_burst", out.client_enqueue_burst, error, 0) &&
+           ReadInt(root, "admission_retry_after_ms", out.admission_retry_after_ms, error, 1) &&
+           ReadString(root, "log_level", out.log_level, error) &&
+           ReadString(root, "arrival_trace_path", out.arrival_trace_path, error);
+}
+
+bool Finish(const ConfigValue& root, EngineConfig& out, ConfigError* error, const EngineConfig& base = EngineConfig()) {
+    EngineConfig parsed = base;
+    if (!ReadFields(root, parsed, error)) {
         return false;
     }
-    ++start;
-    std::size_t end = content.find('"', start);
-    if (end == std::string::npos) {
-        return false;
+    std::string message;
+    if (!parsed.Validate(&message)) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, 0, message);
     }
-    out = content.substr(start, end - start);
+    out = parsed;
     return true;
 }
 
@@ -59,90 +191,179 @@ bool ExtractString(const std::string& content, const std::string& key, std::stri
 
 EngineConfig EngineConfig::LoadFromFile(const std::string& path) {
     EngineConfig config;
-
-    std::ifstream in(path);
-    if (!in.is_open()) {
-        return config;
+    ConfigError error;
+    if (!TryLoadFromFile(path, config, &error) && error.kind != ConfigError::Kind::Io) {
+        MM_LOG(Warn, "config_invalid", "path", path, "error", error.ToString(), "fallback", "defaults");
     }
+    return config;
+}
 
-    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+bool EngineConfig::TryLoadFromFile(const std::string& path, EngineConfig& out, ConfigError* error) {
+    ConfigValue root;
+    return ConfigParser::ParseFile(path, root, error) && Finish(root, out, error);
+}
 
-    int tick_value = config.tick_interval_ms;
-    if (ExtractInt(content, "tick_interval_ms", tick_value)) {
-        config.tick_interval_ms = tick_value;
-    }
+bool EngineConfig::Parse(const std::string& content, EngineConfig& out, ConfigError* error) {
+    ConfigValue root;
+    return ConfigParser::Parse(content, root, error) && Finish(root, out, error);
+}
 
-    std::string matches_value = config.matches_path;
-    if (ExtractString(content, "matches_path", matches_value)) {
-        config.matches_path = matches_value;
+bool EngineConfig::ApplyOverrides(const ConfigOverrides& overrides, EngineConfig& config, ConfigError* error) {
+    // One member per line, so a parse or schema error's line names the override.
+    std::string content = "{";
+    for (std::size_t i = 0; i < overrides.size(); ++i) {
+        const auto& [key, value] = overrides[i];
+        const bool is_string = IsStringKey(key);
+        std::string literal = is_string ? Quote(value) : value;
+        if (key == "regions" && value.find('[') == std::string::npos) {
+            // Also accept a plain comma-separated list: MM_REGIONS=FRA,IAD,SIN.
+            literal = "[";
+            for (std::size_t begin = 0; begin <= value.size();) {
+                std::size_t end = std::min(value.find(',', begin), value.size());
+                literal += (begin == 0 ? "" : ",") + Quote(value.substr(begin, end - begin));
+                begin = end + 1;
+            }
+            literal += "]";
+        }
+        // Each value must be one JSON value on its own, so it cannot close the member and
+        // add keys of its own. Its newlines are then only whitespace.
+        ConfigValue parsed;
+        ConfigError value_error;
+        if (!ConfigParser::ParseSingleValue(literal, parsed, &value_error)) {
+            return config::Fail(error, value_error.kind, 0, "override " + key + ": " + value_error.message);
+        }
+        std::replace(literal.begin(), literal.end(), '\n', ' ');
+        content += (i == 0 ? "\n" : ",\n") + Quote(key) + ": " + literal;
     }
+    content += "\n}";
 
-    int max_ping_value = config.max_ping_ms;
-    if (ExtractInt(content, "max_ping_ms", max_ping_value)) {
-        config.max_ping_ms = max_ping_value;
+    ConfigValue root;
+    if (ConfigParser::Parse(content, root, error) && Finish(root, config, error, config)) {
+        return true;
     }
-
-    int relax_value = config.ping_relax_per_second;
-    if (ExtractInt(content, "ping_relax_per_second", relax_value)) {
-        config.ping_relax_per_second = relax_value;
+    if (error && error->line >= 2 && static_cast<std::size_t>(error->line - 2) < overrides.size()) {
+        error->message = "override " + overrides[static_cast<std::size_t>(error->line - 2)].first + ": " + error->message;
+        error->line = 0;
     }
+    return false;
+}
 
-    int ping_cap_value = config.max_ping_ms_cap;
-    if (ExtractInt(content, "max_ping_ms_cap", ping_cap_value)) {
-        config.max_ping_ms_cap = ping_cap_value;
+ConfigOverrides EngineConfig::EnvironmentOverrides() {
+    ConfigOverrides overrides;
+    for (const auto& key : kEngineConfigKeys) {
+        std::string name = "MM_";
+        for (char c : key) {
+            name += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        const char* value = std::getenv(name.c_str());
+        if (value && *value) {
+            overrides.emplace_back(key, value);
+        }
     }
+    return overrides;
+}
 
-    int min_wait_value = config.min_wait_before_match_ms;
-    if (ExtractInt(content, "min_wait_before_match_ms", min_wait_value)) {
-        config.min_wait_before_match_ms = min_wait_value;
+bool EngineConfig::ResolveQueue(const QueueConfig& queue, EngineConfig& out, ConfigError* error) const {
+    for (const auto& [key, value] : queue.rules) {
+        if (std::find(kQueueKeys.begin(), kQueueKeys.end(), key) == kQueueKeys.end()) {
+            return config::Fail(error, ConfigError::Kind::UnknownKey, 0,
+                                "queues." + queue.id + ": \"" + key + "\" cannot be set per queue");
+        }
     }
-
-    int max_diff_value = config.max_allowed_mmr_diff;
-    if (ExtractInt(content, "max_allowed_mmr_diff", max_diff_value)) {
-        config.max_allowed_mmr_diff = max_diff_value;
+    EngineConfig resolved = *this;
+    resolved.queues.clear();
+    if (!ApplyOverrides(queue.rules, resolved, error)) {
+        if (error) {
+            error->message = "queues." + queue.id + ": " + error->message;
+        }
+        return false;
     }
+    out = std::move(resolved);
+    return true;
+}
 
-    int base_window_value = config.base_mmr_window;
-    if (ExtractInt(content, "base_mmr_window", base_window_value)) {
-        config.base_mmr_window = base_window_value;
-    }
+bool EngineConfig::Validate(std::string* error) const {
+    auto fail = [&](const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
 
-    int relax_mmr_value = config.mmr_relax_per_second;
-    if (ExtractInt(content, "mmr_relax_per_second", relax_mmr_value)) {
-        config.mmr_relax_per_second = relax_mmr_value;
+    if (tick_interval_ms <= 0) {
+        return fail("tick_interval_ms must be positive");
     }
-
-    int max_window_value = config.max_mmr_window;
-    if (ExtractInt(content, "max_mmr_window", max_window_value)) {
-        config.max_mmr_window = max_window_value;
+    if (regions.empty() || regions.size() > kMaxRegions) {
+        return fail("regions must list 1 to " + std::to_string(kMaxRegions) + " datacenters");
     }
-
-    int diff_relax_value = config.mmr_diff_relax_per_second;
-    if (ExtractInt(content, "mmr_diff_relax_per_second", diff_relax_value)) {
-        config.mmr_diff_relax_per_second = diff_relax_value;
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        if (!RegionTable::IsValidName(regions[i])) {
+            return fail("regions: \"" + regions[i] + "\" is not a valid name ([A-Za-z0-9_-], at most 32 characters)");
+        }
+        if (std::find(regions.begin(), regions.begin() + static_cast<std::ptrdiff_t>(i), regions[i]) !=
+            regions.begin() + static_cast<std::ptrdiff_t>(i)) {
+            return fail("regions: \"" + regions[i] + "\" is listed twice");
+        }
     }
-
-    int max_relaxed_diff_value = config.max_relaxed_mmr_diff;
-    if (ExtractInt(content, "max_relaxed_mmr_diff", max_relaxed_diff_value)) {
-        config.max_relaxed_mmr_diff = max_relaxed_diff_value;
+    DatacenterObjective objective;
+    if (!ParseDatacenterObjective(datacenter_objective, objective)) {
+        return fail("datacenter_objective must be \"max\" or \"p90\"");
     }
-
-    int cross_region_step_value = config.cross_region_step_ms;
-    if (ExtractInt(content, "cross_region_step_ms", cross_region_step_value)) {
-        config.cross_region_step_ms = cross_region_step_value;
+    if (max_ping_ms < 0 || ping_relax_per_second < 0 || max_ping_ms_cap < max_ping_ms) {
+        return fail("ping limits must be non-negative and max_ping_ms_cap >= max_ping_ms");
     }
-
-    int good_region_ping_value = config.good_region_ping_ms;
-    if (ExtractInt(content, "good_region_ping_ms", good_region_ping_value)) {
-        config.good_region_ping_ms = good_region_ping_value;
+    if (min_wait_before_match_ms < 0 || max_allowed_mmr_diff < 0) {
+        return fail("min_wait_before_match_ms and max_allowed_mmr_diff must be non-negative");
     }
-
-    int emergency_wait_value = config.emergency_match_wait_ms;
-    if (ExtractInt(content, "emergency_match_wait_ms", emergency_wait_value)) {
-        config.emergency_match_wait_ms = emergency_wait_value;
+    if (base_mmr_window < 0 || mmr_relax_per_second < 0 || max_mmr_window < base_mmr_window) {
+        return fail("MMR window must be non-negative and max_mmr_window >= base_mmr_window");
     }
-
-    return config;
+    if (mmr_diff_relax_per_second < 0 || max_relaxed_mmr_diff < max_allowed_mmr_diff) {
+        return fail("mmr_diff_relax_per_second must be non-negative and max_relaxed_mmr_diff >= max_allowed_mmr_diff");
+    }
+    if (cross_region_step_ms < 0 || good_region_ping_ms < 0 || emergency_match_wait_ms < 0) {
+        return fail("cross_region_step_ms, good_region_ping_ms and emergency_match_wait_ms must be non-negative");
+    }
+    if (team_size < 1 || team_size > kMaxTeamSize || max_matches_per_tick < 0 || tick_budget_ms < 0) {
+        return fail("team_size must be in [1, " + std::to_string(kMaxTeamSize) +
+                    "], max_matches_per_tick and tick_budget_ms non-negative");
+    }
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        if (!RegionTable::IsValidName(queues[i].id)) {
+            return fail("queues: \"" + queues[i].id + "\" is not a valid id ([A-Za-z0-9_-], at most 32 characters)");
+        }
+        for (std::size_t j = 0; j < i; ++j) {
+            if (queues[j].id == queues[i].id) {
+                return fail("queues: \"" + queues[i].id + "\" is listed twice");
+            }
+        }
+        EngineConfig resolved;
+        ConfigError queue_error;
+        if (!ResolveQueue(queues[i], resolved, &queue_error)) {
+            return fail(queue_error.message);
+        }
+    }
+    if (matching_threads < 1 || matching_threads > kMaxMatchingThreads) {
+        return fail("matching_threads must be in [1, " + std::to_string(kMaxMatchingThreads) + "]");
+    }
+    if (node_id < -1 || node_id > MatchIdGenerator::kMaxNode) {
+        return fail("node_id must be -1 or in [0, " + std::to_string(MatchIdGenerator::kMaxNode) + "]");
+    }
+    if (pending_match_ttl_ms < 0 || pending_match_max_mb < 1) {
+        return fail("pending_match_ttl_ms must be non-negative and pending_match_max_mb positive");
+    }
+    if (queue_snapshot_interval_ms < 0) {
+        return fail("queue_snapshot_interval_ms must be non-negative");
+    }
+    if (admission_max_tick_lag_ms < 0 || admission_max_region_queue < 0 || admission_max_enqueues_per_second < 0 ||
+        client_enqueues_per_second < 0 || client_enqueue_burst < 0 || admission_retry_after_ms < 1) {
+        return fail("admission limits must be non-negative and admission_retry_after_ms positive");
+    }
+    LogLevel level;
+    if (!ParseLogLevel(log_level, level)) {
+        return fail("log_level must be one of trace, debug, info, warn, error, off");
+    }
+    return true;
 }
 
 bool EngineConfig::SaveToFile(const std::string& path) const {
@@ -153,7 +374,13 @@ bool EngineConfig::SaveToFile(const std::string& path) const {
 
     out << "{\n";
     out << "  \"tick_interval_ms\": " << tick_interval_ms << ",\n";
-    out << "  \"matches_path\": \"" << matches_path << "\",\n";
+    out << "  \"matches_path\": " << Quote(matches_path) << ",\n";
+    out << "  \"regions\": [";
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << Quote(regions[i]);
+    }
+    out << "],\n";
+    out << "  \"datacenter_objective\": " << Quote(datacenter_objective) << ",\n";
     out << "  \"max_ping_ms\": " << max_ping_ms << ",\n";
     out << "  \"ping_relax_per_second\": " << ping_relax_per_second << ",\n";
     out << "  \"max_ping_ms_cap\": " << max_ping_ms_cap << ",\n";
@@ -166,7 +393,35 @@ bool EngineConfig::SaveToFile(const std::string& path) const {
     out << "  \"max_relaxed_mmr_diff\": " << max_relaxed_mmr_diff << ",\n";
     out << "  \"cross_region_step_ms\": " << cross_region_step_ms << ",\n";
     out << "  \"good_region_ping_ms\": " << good_region_ping_ms << ",\n";
-    out << "  \"emergency_match_wait_ms\": " << emergency_match_wait_ms << "\n";
+    out << "  \"emergency_match_wait_ms\": " << emergency_match_wait_ms << ",\n";
+    out << "  \"team_size\": " << team_size << ",\n";
+    out << "  \"max_matches_per_tick\": " << max_matches_per_tick << ",\n";
+    out << "  \"tick_budget_ms\": " << tick_budget_ms << ",\n";
+    if (!queues.empty()) {
+        out << "  \"queues\": {\n";
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            out << "    " << Quote(queues[i].id) << ": {";
+            for (std::size_t k = 0; k < queues[i].rules.size(); ++k) {
+                const auto& [key, value] = queues[i].rules[k];
+                out << (k == 0 ? "" : ", ") << Quote(key) << ": " << (IsStringKey(key) ? Quote(value) : value);
+            }
+            out << (i + 1 < queues.size() ? "},\n" : "}\n");
+        }
+        out << "  },\n";
+    }
+    out << "  \"matching_threads\": " << matching_threads << ",\n";
+    out << "  \"node_id\": " << node_id << ",\n";
+    out << "  \"pending_match_ttl_ms\": " << pending_match_ttl_ms << ",\n";
+    out << "  \"pending_match_max_mb\": " << pending_match_max_mb << ",\n";
+    out << "  \"queue_snapshot_interval_ms\": " << queue_snapshot_interval_ms << ",\n";
+    out << "  \"admission_max_tick_lag_ms\": " << admission_max_tick_lag_ms << ",\n";
+    out << "  \"admission_max_region_queue\": " << admission_max_region_queue << ",\n";
+    out << "  \"admission_max_enqueues_per_second\": " << admission_max_enqueues_per_second << ",\n";
+    out << "  \"client_enqueues_per_second\": " << client_enqueues_per_second << ",\n";
+    out << "  \"client_enqueue_burst\": " << client_enqueue_burst << ",\n";
+    out << "  \"admission_retry_after_ms\": " << admission_retry_after_ms << ",\n";
+    out << "  \"log_level\": " << Quote(log_level) << ",\n";
+    out << "  \"arrival_trace_path\": " << Quote(arrival_trace_path) << "\n";
     out << "}\n";
 
     return true;
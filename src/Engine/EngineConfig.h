@@ -1,11 +1,35 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
+
+struct ConfigError;
+
+// (config key, value) pairs layered over a loaded config, e.g. from MM_* variables.
+using ConfigOverrides = std::vector<std::pair<std::string, std::string>>;
+
+// Matches are two teams of team_size players.
+constexpr int kMaxTeamSize = 8;
+constexpr int kMaxMatchingThreads = 64;
+
+// A playlist: a named queue matched on its own. `rules` are (key, value) pairs over the
+// top-level matching keys, e.g. {"team_size", "3"}, applied like overrides.
+struct QueueConfig {
+    std::string id;
+    ConfigOverrides rules;
+};
 
 struct EngineConfig {
     int tick_interval_ms = 100;
     std::string matches_path = "matches.jsonl";
 
+    // Datacenters matches are formed for, in the order each tick visits them (at most
+    // kMaxRegions). Changing the set on reload re-resolves queued players' pings.
+    std::vector<std::string> regions = {"NA", "EU", "ASIA"};
+    // Each formed match is hosted in the region with the lowest "max" or "p90" player ping.
+    std::string datacenter_objective = "max";
+
     int max_ping_ms = 80;
     int ping_relax_per_second = 10;
     int max_ping_ms_cap = 200;
@@ -25,7 +49,68 @@ struct EngineConfig {
 
     int emergency_match_wait_ms = 300000;
 
+    // Players per team (1-kMaxTeamSize).
+    int team_size = 5;
+    // Matches one queue may form per tick (0 = no limit); the rest wait for the next tick,
+    // so a hot queue cannot hold the matching threads away from the others.
+    int max_matches_per_tick = 0;
+    // Time one queue's matching pass may take per tick (0 = no limit). A pass that runs
+    // out resumes at the same region and seed on the next tick, unless a reload came in
+    // between.
+    int tick_budget_ms = 0;
+
+    // Playlists players pick with Player.queue_id; an empty queue_id selects the first.
+    // Without any, every player joins a single "default" queue run on the top-level keys.
+    std::vector<QueueConfig> queues;
+    // Threads that run the queues' matching passes each tick. Read at startup.
+    int matching_threads = 1;
+
+    // Node bits of generated match IDs (0-1023). Shards writing to a shared log need
+    // distinct values; -1 derives one from the host name and process id. Read at startup.
+    int node_id = -1;
+
+    // Formed matches wait this long for every player to pick them up, and are evicted
+    // oldest first once undelivered matches use more than pending_match_max_mb.
+    int pending_match_ttl_ms = 120000;
+    int pending_match_max_mb = 64;
+
+    // Minimum spacing of the queue copies GetQueue is served from (0 = every tick).
+    int queue_snapshot_interval_ms = 1000;
+
+    // Enqueues are rejected with RESOURCE_EXHAUSTED and a retry-after hint while the next
+    // tick is more than admission_max_tick_lag_ms overdue, while the player's region holds
+    // admission_max_region_queue players, or beyond admission_max_enqueues_per_second in
+    // total or client_enqueues_per_second (bursts of client_enqueue_burst) per client
+    // address. 0 disables each check.
+    int admission_max_tick_lag_ms = 0;
+    int admission_max_region_queue = 0;
+    int admission_max_enqueues_per_second = 0;
+    int client_enqueues_per_second = 0;
+    int client_enqueue_burst = 0;
+    // Retry hint for rejections that have no natural wait, such as a full region.
+    int admission_retry_after_ms = 1000;
+
+    // Minimum level written by the server's logger: trace, debug, info, warn, error or off.
+    std::string log_level = "info";
+
+    // When set, every Enqueue/Cancel is appended to this JSONL trace for match_replay.
+    std::string arrival_trace_path;
+
+    // Falls back to defaults when the file is missing or invalid (the latter is logged).
     static EngineConfig LoadFromFile(const std::string& path);
+    // Strict variants: unknown keys, wrong types and out-of-range values fail with a
+    // line-numbered error and leave `out` untouched.
+    static bool TryLoadFromFile(const std::string& path, EngineConfig& out, ConfigError* error = nullptr);
+    static bool Parse(const std::string& content, EngineConfig& out, ConfigError* error = nullptr);
+    // Applies `overrides` with the same type and range checks as the file; on failure
+    // `config` is left untouched.
+    static bool ApplyOverrides(const ConfigOverrides& overrides, EngineConfig& config, ConfigError* error = nullptr);
+    // MM_<KEY> environment variables for every config key (MM_TICK_INTERVAL_MS, ...).
+    static ConfigOverrides EnvironmentOverrides();
+    // The config `queue` is matched with: this config, without its queues, with the
+    // queue's rules applied. Fails on keys that are not per-queue.
+    bool ResolveQueue(const QueueConfig& queue, EngineConfig& out, ConfigError* error = nullptr) const;
+    bool Validate(std::string* error = nullptr) const;
     bool SaveToFile(const std::string& path) const;
 };
 
@@ -0,0 +1,64 @@
+#include "EngineSettings.h"
+
+#include <algorithm>
+
+namespace {
+
+// Curves longer than this are truncated; the last entry then stands for every later second.
+constexpr int kMaxCurveSeconds = 1 << 16;
+
+int SecondsToSaturate(int base, int per_second, int cap) {
+    if (per_second <= 0 || base >= cap) {
+        return 0;
+    }
+    int seconds = (cap - base + per_second - 1) / per_second;
+    return std::min(seconds, kMaxCurveSeconds);
+}
+
+}  // namespace
+
+RelaxCurves RelaxCurves::Build(const EngineConfig& config) {
+    int length = 1 + std::max({
+        SecondsToSaturate(config.base_mmr_window, config.mmr_relax_per_second, config.max_mmr_window),
+        SecondsToSaturate(config.max_ping_ms, config.ping_relax_per_second, config.max_ping_ms_cap),
+        SecondsToSaturate(config.max_allowed_mmr_diff, config.mmr_diff_relax_per_second, config.max_relaxed_mmr_diff),
+    });
+
+    RelaxCurves curves;
+    curves.mmr_window.resize(static_cast<std::size_t>(length));
+    curves.ping_window.resize(static_cast<std::size_t>(length));
+    curves.allowed_spread.resize(static_cast<std::size_t>(length));
+
+    for (int s = 0; s < length; ++s) {
+        long long window = static_cast<long long>(config.base_mmr_window) +
+                           static_cast<long long>(config.mmr_relax_per_second) * s;
+        long long ping = static_cast<long long>(config.max_ping_ms) +
+                         static_cast<long long>(config.ping_relax_per_second) * s;
+        long long spread = static_cast<long long>(config.max_allowed_mmr_diff) +
+                           static_cast<long long>(config.mmr_diff_relax_per_second) * s;
+
+        auto idx = static_cast<std::size_t>(s);
+        curves.mmr_window[idx] = static_cast<int>(std::min<long long>(window, config.max_mmr_window));
+        curves.ping_window[idx] = static_cast<int>(std::min<long long>(ping, config.max_ping_ms_cap));
+        curves.allowed_spread[idx] = static_cast<int>(std::min<long long>(spread, config.max_relaxed_mmr_diff));
+    }
+
+    return curves;
+}
+
+std::unique_ptr<EngineSettings> EngineSettings::Build(const EngineConfig& cfg, std::uint64_t v) {
+    auto settings = std::make_unique<EngineSettings>(cfg, v);
+    if (cfg.queues.empty()) {
+        settings->queues.push_back(QueueSettings{"default", std::make_shared<const EngineSettings>(cfg, v)});
+        return settings;
+    }
+    for (const auto& queue : cfg.queues) {
+        EngineConfig resolved;
+        if (!cfg.ResolveQueue(queue, resolved)) {
+            resolved = cfg;
+            resolved.queues.clear();
+        }
+        settings->queues.push_back(QueueSettings{queue.id, std::make_shared<const EngineSettings>(resolved, v)});
+    }
+    return settings;
+}
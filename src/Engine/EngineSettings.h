@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EngineConfig.h"
+#include "RegionTable.h"
+
+// Relaxation limits indexed by whole seconds waited past min_wait_before_match_ms.
+// Built once per config so the matcher only does table lookups.
+struct RelaxCurves {
+    std::vector<int> mmr_window;
+    std::vector<int> ping_window;
+    std::vector<int> allowed_spread;
+
+    static RelaxCurves Build(const EngineConfig& config);
+
+    int MmrWindow(int relax_seconds) const { return At(mmr_window, relax_seconds); }
+    int PingWindow(int relax_seconds) const { return At(ping_window, relax_seconds); }
+    int AllowedSpread(int relax_seconds) const { return At(allowed_spread, relax_seconds); }
+
+private:
+    static int At(const std::vector<int>& curve, int relax_seconds) {
+        if (relax_seconds < 0) {
+            relax_seconds = 0;
+        }
+        std::size_t idx = static_cast<std::size_t>(relax_seconds);
+        return idx < curve.size() ? curve[idx] : curve.back();
+    }
+};
+
+struct EngineSettings;
+
+// A playlist's id and the resolved settings its queue is matched with.
+struct QueueSettings {
+    std::string id;
+    std::shared_ptr<const EngineSettings> rules;
+};
+
+// Immutable config snapshot handed to the tick thread. A reload builds a new one
+// and publishes it; the matcher never sees a half-applied config.
+struct EngineSettings {
+    EngineConfig config;
+    RelaxCurves curves;
+    RegionTable regions;
+    DatacenterObjective datacenter_objective = DatacenterObjective::MaxPing;
+    std::uint64_t version = 0;
+    // Filled by Build(); empty for the per-queue settings themselves.
+    std::vector<QueueSettings> queues;
+
+    // Settings for `cfg` with every playlist resolved: cfg.queues in order, or a single
+    // "default" queue on the top-level keys. A queue that fails to resolve (only possible
+    // for a config that was never validated) runs on the top-level keys.
+    static std::unique_ptr<EngineSettings> Build(const EngineConfig& cfg, std::uint64_t v = 0);
+
+    explicit EngineSettings(const EngineConfig& cfg, std::uint64_t v = 0)
+        : config(cfg),
+          curves(RelaxCurves::Build(cfg)),
+          regions(cfg.regions),
+          version(v) {
+        ParseDatacenterObjective(cfg.datacenter_objective, datacenter_objective);
+    }
+};
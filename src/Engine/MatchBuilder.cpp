@@ -1,98 +1,243 @@
 #include "MatchBuilder.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
 #include <chrono>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 using namespace matchmaking;
 
 namespace {
 
-int GetRegionPing(const Player& p, const std::string& region) {
-    if (region == "NA") {
-        if (p.ping_na() > 0) return p.ping_na();
-    } else if (region == "EU") {
-        if (p.ping_eu() > 0) return p.ping_eu();
-    } else if (region == "ASIA") {
-        if (p.ping_asia() > 0) return p.ping_asia();
-    }
-    return p.ping();
-}
-
-bool IsRegionAllowedForPlayer(const PlayerEntry& entry,
-                              const std::string& region,
+// A player's best region is always allowed, as is any region under good_region_ping_ms;
+// the k-th best opens after k * cross_region_step_ms of waiting.
+bool IsRegionAllowedForPlayer(const RegionPings& pings,
+                              std::size_t region,
                               long long waited_ms,
                               const EngineConfig& config) {
-    struct RegionPing {
-        const char* name;
-        int ping;
-    };
+    const int rank = pings.rank[region];
+    if (rank == 0) {
+        return true;
+    }
 
-    const Player& p = entry.player;
-    RegionPing regions[3] = {
-        {"NA", GetRegionPing(p, "NA")},
-        {"EU", GetRegionPing(p, "EU")},
-        {"ASIA", GetRegionPing(p, "ASIA")}
-    };
+    if (pings.ping[region] < config.good_region_ping_ms) {
+        return true;
+    }
 
-    std::sort(regions, regions + 3,
-              [](const RegionPing& a, const RegionPing& b) {
-                  return a.ping < b.ping;
-              });
+    long long required_ms = static_cast<long long>(rank) * config.cross_region_step_ms;
+    return waited_ms >= required_ms;
+}
 
-    int rank = -1;
-    int region_ping = 0;
-    for (int i = 0; i < 3; ++i) {
-        if (region == regions[i].name) {
-            rank = i;
-            region_ping = regions[i].ping;
-            break;
+// Region eligibility and region ping depend only on each player's own wait, so they are
+// computed once per pass rather than once per seed. Pings and ranks are cached on the
+// entry and only resolved again when the region table changes.
+void PreparePass(PlayerQueue& queue, const EngineSettings& settings, int region, std::int64_t now_ms,
+                 MatchPass& pass) {
+    const std::size_t count = queue.size();
+    const auto r = static_cast<std::size_t>(region);
+    pass.wait_ms.assign(count, 0);
+    pass.allowed.assign(count, 0);
+    pass.region_ping.assign(count, 0);
+    pass.by_mmr.clear();
+    pass.runs.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        pass.wait_ms[i] = std::max<long long>(0, now_ms - queue[i].queued_ms);
+        queue.ResolvePings(queue[i], settings.regions);
+        const RegionPings& pings = queue.PingsOf(queue[i]);
+        pass.allowed[i] = IsRegionAllowedForPlayer(pings, r, pass.wait_ms[i], settings.config) ? 1 : 0;
+        pass.region_ping[i] = pings.ping[r];
+        if (pass.allowed[i]) {
+            pass.by_mmr.push_back(i);
         }
     }
+    std::stable_sort(pass.by_mmr.begin(), pass.by_mmr.end(), [&](std::size_t a, std::size_t b) {
+        return queue[a].mmr < queue[b].mmr;
+    });
+    pass.sorted_mmr.resize(pass.by_mmr.size());
+    for (std::size_t k = 0; k < pass.by_mmr.size(); ++k) {
+        pass.sorted_mmr[k] = queue[pass.by_mmr[k]].mmr;
+    }
 
-    if (rank == -1) {
-        return false;
+    pass.valid = true;
+    pass.queue = &queue;
+    pass.settings = &settings;
+    pass.region = region;
+    pass.now_ms = now_ms;
+    pass.queue_version = queue.Version();
+}
+
+// Drops the players flagged in `removed` from `pass`, as PlayerQueue::RemoveIf drops
+// them from the queue: the rest keep their order and move to their new indices.
+void DropFromPass(MatchPass& pass, const std::vector<bool>& removed) {
+    std::vector<std::size_t> new_index(removed.size());
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < removed.size(); ++i) {
+        new_index[i] = kept;
+        if (!removed[i]) {
+            pass.wait_ms[kept] = pass.wait_ms[i];
+            pass.allowed[kept] = pass.allowed[i];
+            pass.region_ping[kept] = pass.region_ping[i];
+            ++kept;
+        }
+    }
+    pass.wait_ms.resize(kept);
+    pass.allowed.resize(kept);
+    pass.region_ping.resize(kept);
+
+    std::size_t out = 0;
+    for (std::size_t k = 0; k < pass.by_mmr.size(); ++k) {
+        const std::size_t i = pass.by_mmr[k];
+        if (!removed[i]) {
+            pass.by_mmr[out] = new_index[i];
+            pass.sorted_mmr[out] = pass.sorted_mmr[k];
+            ++out;
+        }
     }
+    pass.by_mmr.resize(out);
+    pass.sorted_mmr.resize(out);
+    pass.runs.clear();
+}
 
-    if (rank == 0) {
-        return true;
+[[maybe_unused]] bool InEnqueueOrder(const PlayerQueue& queue) {
+    return std::is_sorted(queue.begin(), queue.end(),
+                          [](const PlayerEntry& a, const PlayerEntry& b) { return a.queued_ms < b.queued_ms; });
+}
+
+// The pass's runs for `ping_window`, built the first time a seed asks for them.
+const PingWindowRuns& RunsFor(MatchPass& pass, int ping_window, std::size_t match_size) {
+    for (const auto& runs : pass.runs) {
+        if (runs.ping_window == ping_window) {
+            return runs;
+        }
+    }
+    PingWindowRuns& runs = pass.runs.emplace_back();
+    runs.ping_window = ping_window;
+    for (std::size_t k = 0; k < pass.by_mmr.size(); ++k) {
+        const std::size_t i = pass.by_mmr[k];
+        if (pass.region_ping[i] <= ping_window) {
+            runs.players.push_back(i);
+            runs.mmr.push_back(pass.sorted_mmr[k]);
+        }
+    }
+    const std::size_t count = runs.players.size();
+    if (count < match_size) {
+        return runs;
     }
 
-    if (region_ping < config.good_region_ping_ms) {
-        return true;
+    const std::size_t run_count = count - match_size + 1;
+    runs.run_wait.resize(run_count);
+    long long sum = 0;
+    for (std::size_t k = 0; k < match_size; ++k) {
+        sum += pass.wait_ms[runs.players[k]];
+    }
+    for (std::size_t k = 0; k < run_count; ++k) {
+        runs.run_wait[k] = sum;
+        if (k + match_size < count) {
+            sum += pass.wait_ms[runs.players[k + match_size]] - pass.wait_ms[runs.players[k]];
+        }
     }
 
-    long long required_ms = static_cast<long long>(rank) * config.cross_region_step_ms;
-    return waited_ms >= required_ms;
+    auto spread = [&](std::size_t k) { return runs.mmr[k + match_size - 1] - runs.mmr[k]; };
+    std::vector<std::size_t>& first_level = runs.tightest.emplace_back(run_count);
+    for (std::size_t k = 0; k < run_count; ++k) {
+        first_level[k] = k;
+    }
+    for (std::size_t half = 1; 2 * half <= run_count; half *= 2) {
+        const std::vector<std::size_t>& prev = runs.tightest.back();
+        std::vector<std::size_t> next(prev.size() - half);
+        for (std::size_t k = 0; k < next.size(); ++k) {
+            next[k] = spread(prev[k + half]) < spread(prev[k]) ? prev[k + half] : prev[k];
+        }
+        runs.tightest.push_back(std::move(next));
+    }
+    return runs;
+}
+
+// The tightest of the runs starting at `first` through `last`, first on ties.
+std::size_t TightestRun(const PingWindowRuns& runs, std::size_t first, std::size_t last, std::size_t match_size) {
+    const auto level = static_cast<std::size_t>(std::bit_width(last - first + 1) - 1);
+    const std::vector<std::size_t>& row = runs.tightest[level];
+    const std::size_t a = row[first];
+    const std::size_t b = row[last + 1 - (std::size_t{1} << level)];
+    const int spread_a = runs.mmr[a + match_size - 1] - runs.mmr[a];
+    const int spread_b = runs.mmr[b + match_size - 1] - runs.mmr[b];
+    return spread_b < spread_a ? b : a;
 }
 
 }  // namespace
 
-bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
+bool MatchBuilder::BuildMatch(PlayerQueue& queue,
+                              Match& outMatch,
+                              const EngineConfig& config,
+                              const std::string& region,
+                              MatchMetrics* metrics)
+{
+    return BuildMatch(queue, outMatch, config, region, std::int64_t{0}, metrics);
+}
+
+bool MatchBuilder::BuildMatch(PlayerQueue& queue,
                               Match& outMatch,
                               const EngineConfig& config,
                               const std::string& region,
+                              std::int64_t now_ms,
                               MatchMetrics* metrics)
 {
-    if (queue.size() < 10) {
+    EngineSettings settings(config);
+    return BuildMatch(queue, outMatch, settings, region, now_ms, metrics);
+}
+
+bool MatchBuilder::BuildMatch(PlayerQueue& queue,
+                              Match& outMatch,
+                              const EngineSettings& settings,
+                              const std::string& region,
+                              std::int64_t now_ms,
+                              MatchMetrics* metrics,
+                              const MmrHistogram* histogram,
+                              MatchIdGenerator* ids,
+                              MatchSearch* search,
+                              MatchPass* pass)
+{
+    const EngineConfig& config = settings.config;
+    const RelaxCurves& curves = settings.curves;
+
+    // Two teams of team_size players.
+    const std::size_t team_size = static_cast<std::size_t>(std::clamp(config.team_size, 1, kMaxTeamSize));
+    const std::size_t match_size = 2 * team_size;
+
+    const int region_index = settings.regions.IndexOf(region);
+    if (queue.size() < match_size || region_index < 0) {
         return false;
     }
+    const auto r = static_cast<std::size_t>(region_index);
 
-    auto now = std::chrono::steady_clock::now();
     const std::size_t n = queue.size();
 
-    // Precompute wait times for all players once.
-    std::vector<long long> wait_ms(n, 0);
-    for (std::size_t i = 0; i < n; ++i) {
-        auto w = std::chrono::duration_cast<std::chrono::milliseconds>(now - queue[i].queuedAt).count();
-        if (w < 0) {
-            w = 0;
+    MmrHistogram local_histogram;
+    if (!histogram) {
+        for (const auto& entry : queue) {
+            local_histogram.Add(entry.mmr);
         }
-        wait_ms[i] = w;
+        histogram = &local_histogram;
     }
 
+    MatchPass local_pass;
+    if (!pass) {
+        pass = &local_pass;
+    }
+    if (!pass->valid || pass->queue != &queue || pass->queue_version != queue.Version() ||
+        pass->settings != &settings || pass->region != region_index || pass->now_ms != now_ms) {
+        PreparePass(queue, settings, region_index, now_ms, *pass);
+    }
+    const std::vector<long long>& wait_ms = pass->wait_ms;
+    const std::vector<char>& allowed = pass->allowed;
+    const std::vector<int>& region_ping = pass->region_ping;
+
     struct SeedChoice {
         bool valid = false;
         std::size_t seed_index = 0;
@@ -104,109 +249,157 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
 
     SeedChoice best;
 
-    // Consider every player as a potential seed for this region.
-    for (std::size_t seed_index = 0; seed_index < n; ++seed_index) {
-        long long waited_ms = wait_ms[seed_index];
-
-        if (!IsRegionAllowedForPlayer(queue[seed_index], region, waited_ms, config)) {
-            continue;
-        }
-
-        int relax_seconds = 0;
-        if (waited_ms > config.min_wait_before_match_ms) {
-            relax_seconds = static_cast<int>((waited_ms - config.min_wait_before_match_ms) / 1000);
+    std::vector<std::size_t> seeds;
+    seeds.reserve(pass->by_mmr.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        if (allowed[i]) {
+            seeds.push_back(i);
         }
+    }
 
-        int window = config.base_mmr_window +
-                     config.mmr_relax_per_second * relax_seconds;
-        if (window > config.max_mmr_window) {
-            window = config.max_mmr_window;
+    auto relax_seconds_for = [&](long long waited_ms) {
+        if (waited_ms <= config.min_wait_before_match_ms) {
+            return 0;
         }
+        return static_cast<int>((waited_ms - config.min_wait_before_match_ms) / 1000);
+    };
 
-        const int seed_mmr = queue[seed_index].player.mmr();
-        const int min_mmr = seed_mmr - window;
-        const int max_mmr = seed_mmr + window;
-
-        int ping_window = config.max_ping_ms +
-                          config.ping_relax_per_second * relax_seconds;
-        if (ping_window > config.max_ping_ms_cap) {
-            ping_window = config.max_ping_ms_cap;
+    // Upper bound on the average wait of any match a seed can produce: the match_size
+    // longest waits among players inside its ping window. The ping window only grows with
+    // the seed's wait, so the bound for a seed also covers every seed that waited less.
+    // Returns a negative value when fewer than match_size players fit the window.
+    std::vector<std::pair<int, double>> bound_cache;
+    auto wait_bound = [&](int ping_window) {
+        for (const auto& [cached_window, bound] : bound_cache) {
+            if (cached_window == ping_window) {
+                return bound;
+            }
         }
-
-        std::vector<std::size_t> eligible_indices;
-        eligible_indices.reserve(n);
-
+        std::vector<long long> top;
+        top.reserve(match_size + 1);
         for (std::size_t i = 0; i < n; ++i) {
-            long long wait_i = wait_ms[i];
-            if (!IsRegionAllowedForPlayer(queue[i], region, wait_i, config)) {
+            if (!allowed[i] || region_ping[i] > ping_window) {
                 continue;
             }
+            top.push_back(wait_ms[i]);
+            std::push_heap(top.begin(), top.end(), std::greater<>());
+            if (top.size() > match_size) {
+                std::pop_heap(top.begin(), top.end(), std::greater<>());
+                top.pop_back();
+            }
+        }
+        double bound = -1.0;
+        if (top.size() == match_size) {
+            long long sum = 0;
+            for (long long w : top) {
+                sum += w;
+            }
+            bound = static_cast<double>(sum) / static_cast<double>(match_size);
+        }
+        bound_cache.emplace_back(ping_window, bound);
+        return bound;
+    };
 
-            int mmr = queue[i].player.mmr();
-            int ping = GetRegionPing(queue[i].player, region);
-            if (mmr >= min_mmr && mmr <= max_mmr &&
-                ping <= ping_window) {
-                eligible_indices.push_back(i);
+    // A suspended search skips the seeds it already tried. They stay candidates for
+    // other seeds' matches, and are tried again once the search wraps around.
+    if (search && search->suspended) {
+        assert(InEnqueueOrder(queue));
+        auto resume = std::lower_bound(queue.begin(), queue.end(), search->resume_queued_ms,
+                                       [](const PlayerEntry& e, std::int64_t t) { return e.queued_ms < t; });
+        for (auto it = resume; it != queue.end() && it->queued_ms == search->resume_queued_ms; ++it) {
+            if (queue.PlayerOf(*it).id() == search->resume_id) {
+                resume = it;
+                break;
             }
         }
+        const auto first_seed = static_cast<std::size_t>(resume - queue.begin());
+        seeds.erase(std::remove_if(seeds.begin(), seeds.end(), [&](std::size_t i) { return i < first_seed; }),
+                    seeds.end());
+    }
+    if (search) {
+        search->suspended = false;
+        search->out_of_time = false;
+    }
 
-        if (eligible_indices.size() < 10) {
-            continue;
+    // Max-heap of seeds by wait; ties pop in queue order so the result matches a full
+    // scan that keeps the first best seed.
+    auto seed_less = [&](std::size_t a, std::size_t b) {
+        if (wait_ms[a] != wait_ms[b]) {
+            return wait_ms[a] < wait_ms[b];
+        }
+        return a > b;
+    };
+    std::make_heap(seeds.begin(), seeds.end(), seed_less);
+
+    std::size_t seeds_evaluated = 0;
+    std::size_t seeds_tried = 0;
+    while (!seeds.empty()) {
+        std::pop_heap(seeds.begin(), seeds.end(), seed_less);
+        const std::size_t seed_index = seeds.back();
+        seeds.pop_back();
+
+        if (search && seeds_tried > 0 && std::chrono::steady_clock::now() >= search->deadline) {
+            search->suspended = true;
+            search->out_of_time = true;
+            search->resume_queued_ms = queue[seed_index].queued_ms;
+            search->resume_id = queue.PlayerOf(queue[seed_index]).id();
+            break;
         }
+        ++seeds_tried;
 
-        struct Candidate {
-            std::size_t index;
-            int mmr;
-        };
+        long long waited_ms = wait_ms[seed_index];
+        const int relax_seconds = relax_seconds_for(waited_ms);
+        const int ping_window = curves.PingWindow(relax_seconds);
 
-        std::vector<Candidate> all_candidates;
-        all_candidates.reserve(eligible_indices.size());
-        for (std::size_t idx : eligible_indices) {
-            all_candidates.push_back(Candidate{idx, queue[idx].player.mmr()});
+        const double bound = wait_bound(ping_window);
+        if (bound < 0.0 || (best.valid && bound < best.avg_wait_ms)) {
+            break;
         }
 
-        std::sort(all_candidates.begin(), all_candidates.end(),
-                  [](const Candidate& a, const Candidate& b) {
-                      return a.mmr < b.mmr;
-                  });
+        const int window = curves.MmrWindow(relax_seconds);
 
-        int best_start_for_seed = -1;
-        int best_spread_for_seed = std::numeric_limits<int>::max();
-        for (std::size_t i = 0; i + 9 < all_candidates.size(); ++i) {
-            int spread = all_candidates[i + 9].mmr - all_candidates[i].mmr;
-            if (spread < best_spread_for_seed) {
-                best_spread_for_seed = spread;
-                best_start_for_seed = static_cast<int>(i);
-            }
+        const int seed_mmr = queue[seed_index].mmr;
+        const int min_mmr = seed_mmr - window;
+        const int max_mmr = seed_mmr + window;
+
+        int allowed_spread = config.max_allowed_mmr_diff;
+        if (waited_ms > config.min_wait_before_match_ms) {
+            allowed_spread = curves.AllowedSpread(relax_seconds);
         }
 
-        if (best_start_for_seed < 0) {
+        // Too few queued players anywhere in the window: no candidate scan needed.
+        if (histogram->CountInRange(min_mmr, max_mmr) < match_size) {
             continue;
         }
 
-        int allowed_spread = config.max_allowed_mmr_diff;
-        if (waited_ms > config.min_wait_before_match_ms) {
-            allowed_spread += config.mmr_diff_relax_per_second * relax_seconds;
-            if (allowed_spread > config.max_relaxed_mmr_diff) {
-                allowed_spread = config.max_relaxed_mmr_diff;
-            }
+        // The seed's match is the tightest run of match_size players in its MMR and ping
+        // window, read from the table for its ping window rather than by scanning it. A
+        // run waiting less than the best match so far cannot replace it.
+        const PingWindowRuns& runs = RunsFor(*pass, ping_window, match_size);
+        const auto first = static_cast<std::size_t>(
+            std::lower_bound(runs.mmr.begin(), runs.mmr.end(), min_mmr) - runs.mmr.begin());
+        const auto last = static_cast<std::size_t>(
+            std::upper_bound(runs.mmr.begin(), runs.mmr.end(), max_mmr) - runs.mmr.begin());
+        if (last - first < match_size) {
+            continue;
         }
-
+        const std::size_t run = TightestRun(runs, first, last - match_size, match_size);
+        const int best_spread_for_seed = runs.mmr[run + match_size - 1] - runs.mmr[run];
         if (best_spread_for_seed > allowed_spread) {
             continue;
         }
-
-        std::vector<std::size_t> selected_indices;
-        selected_indices.reserve(10);
-        long long sum_wait_ms = 0;
-
-        for (int j = 0; j < 10; ++j) {
-            std::size_t idx = all_candidates[best_start_for_seed + j].index;
-            selected_indices.push_back(idx);
-            sum_wait_ms += wait_ms[idx];
+        const double avg_wait_ms = static_cast<double>(runs.run_wait[run]) / static_cast<double>(match_size);
+        if (best.valid && avg_wait_ms < best.avg_wait_ms) {
+            continue;
         }
-
-        double avg_wait_ms = static_cast<double>(sum_wait_ms) / 10.0;
+        // A seed queued after the best match's seed whose run is that match loses the tie.
+        const auto run_begin = runs.players.begin() + static_cast<std::ptrdiff_t>(run);
+        const auto run_end = run_begin + static_cast<std::ptrdiff_t>(match_size);
+        if (best.valid && seed_index > best.seed_index &&
+            std::equal(run_begin, run_end, best.selected_indices.begin(), best.selected_indices.end())) {
+            continue;
+        }
+        ++seeds_evaluated;
 
         bool take = false;
         if (!best.valid) {
@@ -214,41 +407,70 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
         } else if (avg_wait_ms > best.avg_wait_ms) {
             take = true;
         } else if (avg_wait_ms == best.avg_wait_ms &&
-                   best_spread_for_seed < best.spread) {
+                   (best_spread_for_seed < best.spread ||
+                    (best_spread_for_seed == best.spread && seed_index < best.seed_index))) {
             take = true;
         }
 
         if (take) {
             best.valid = true;
             best.seed_index = seed_index;
-            best.selected_indices = std::move(selected_indices);
+            best.selected_indices.assign(run_begin, run_end);
             best.seed_wait_ms = waited_ms;
             best.avg_wait_ms = avg_wait_ms;
             best.spread = best_spread_for_seed;
         }
     }
 
+    if (metrics) {
+        metrics->seeds_evaluated = seeds_evaluated;
+    }
+
+    if (!best.valid && search && search->out_of_time) {
+        return false;
+    }
     if (!best.valid) {
-        long long emergency_ms = config.emergency_match_wait_ms;
-        if (region == "NA" && emergency_ms > 0) {
-            std::vector<std::size_t> long_wait_indices;
-            long_wait_indices.reserve(n);
-            for (std::size_t i = 0; i < n; ++i) {
-                if (wait_ms[i] >= emergency_ms) {
-                    long_wait_indices.push_back(i);
+        // Emergency stage: players past emergency_match_wait_ms are matched regardless of
+        // MMR and ping limits, using the tightest full-match MMR window among them. The
+        // queue is in enqueue order, so they form a prefix found by binary search.
+        const std::int64_t emergency_wait_ms = config.emergency_match_wait_ms;
+        if (emergency_wait_ms > 0) {
+            assert(InEnqueueOrder(queue));
+            auto long_wait_end = std::partition_point(queue.begin(), queue.end(), [&](const PlayerEntry& e) {
+                return now_ms - e.queued_ms >= emergency_wait_ms;
+            });
+            const auto long_wait_count = static_cast<std::size_t>(long_wait_end - queue.begin());
+
+            std::vector<std::size_t> long_waiters;
+            long_waiters.reserve(long_wait_count);
+            for (std::size_t i = 0; i < long_wait_count; ++i) {
+                if (allowed[i]) {
+                    long_waiters.push_back(i);
                 }
             }
-            if (long_wait_indices.size() >= 10) {
+            if (long_waiters.size() >= match_size) {
+                std::stable_sort(long_waiters.begin(), long_waiters.end(), [&](std::size_t a, std::size_t b) {
+                    return queue[a].mmr < queue[b].mmr;
+                });
+                std::size_t best_start = 0;
+                int best_spread = std::numeric_limits<int>::max();
+                for (std::size_t i = 0; i + match_size <= long_waiters.size(); ++i) {
+                    int spread = queue[long_waiters[i + match_size - 1]].mmr - queue[long_waiters[i]].mmr;
+                    if (spread < best_spread) {
+                        best_spread = spread;
+                        best_start = i;
+                    }
+                }
                 best.valid = true;
-                best.seed_index = long_wait_indices[0];
-                best.selected_indices.assign(long_wait_indices.begin(),
-                                             long_wait_indices.begin() + 10);
+                best.seed_index = long_waiters[best_start];
+                best.selected_indices.assign(long_waiters.begin() + static_cast<std::ptrdiff_t>(best_start),
+                                             long_waiters.begin() + static_cast<std::ptrdiff_t>(best_start + match_size));
                 long long sum_wait = 0;
                 for (std::size_t idx : best.selected_indices) {
                     sum_wait += wait_ms[idx];
                 }
-                best.avg_wait_ms = static_cast<double>(sum_wait) / 10.0;
-                best.spread = 0;
+                best.avg_wait_ms = static_cast<double>(sum_wait) / static_cast<double>(match_size);
+                best.spread = best_spread;
             }
         }
         if (!best.valid) {
@@ -256,7 +478,8 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
         }
     }
 
-    outMatch.set_match_id("match_" + std::to_string(rand()));
+    const auto match_id = (ids ? *ids : MatchIdGenerator::ProcessDefault()).NextEncoded();
+    outMatch.set_match_id(match_id.data(), match_id.size());
 
     struct TeamCandidate {
         std::size_t index;
@@ -264,9 +487,9 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
     };
 
     std::vector<TeamCandidate> candidates;
-    candidates.reserve(10);
+    candidates.reserve(match_size);
     for (std::size_t idx : best.selected_indices) {
-        candidates.push_back(TeamCandidate{idx, queue[idx].player.mmr()});
+        candidates.push_back(TeamCandidate{idx, queue[idx].mmr});
     }
 
     std::sort(candidates.begin(), candidates.end(),
@@ -276,16 +499,16 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
 
     std::vector<std::size_t> team_a;
     std::vector<std::size_t> team_b;
-    team_a.reserve(5);
-    team_b.reserve(5);
+    team_a.reserve(team_size);
+    team_b.reserve(team_size);
     int sum_a = 0;
     int sum_b = 0;
 
     for (const auto& c : candidates) {
         bool choose_a = false;
-        if (team_a.size() < 5 && team_b.size() < 5) {
+        if (team_a.size() < team_size && team_b.size() < team_size) {
             choose_a = sum_a <= sum_b;
-        } else if (team_a.size() < 5) {
+        } else if (team_a.size() < team_size) {
             choose_a = true;
         } else {
             choose_a = false;
@@ -307,12 +530,17 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
     int min_mmr_match = std::numeric_limits<int>::max();
     int max_mmr_match = std::numeric_limits<int>::min();
     int selected_count = 0;
+    std::array<const RegionPings*, 2 * kMaxTeamSize> rows{};
+    std::size_t row_count = 0;
+    std::array<std::uint32_t, 2 * kMaxTeamSize> selected_handles{};
 
     auto add_player_to_match = [&](std::size_t idx) {
         selected_flags[idx] = true;
-        *outMatch.add_players() = queue[idx].player;
+        *outMatch.add_players() = queue.PlayerOf(queue[idx]);
+        rows[row_count++] = &queue.PingsOf(queue[idx]);
+        selected_handles[row_count - 1] = queue[idx].handle;
 
-        int mmr = queue[idx].player.mmr();
+        int mmr = queue[idx].mmr;
         sum_mmr_match += mmr;
         if (mmr < min_mmr_match) {
             min_mmr_match = mmr;
@@ -325,6 +553,9 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
             w = 0;
         }
         total_wait_ms += w;
+        if (metrics) {
+            metrics->wait_ms[static_cast<std::size_t>(selected_count)] = w;
+        }
         ++selected_count;
     };
 
@@ -335,6 +566,13 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
         add_player_to_match(idx);
     }
 
+    // Host where the chosen players' worst (or p90) ping is lowest, which need not be
+    // the region the match was formed for.
+    const DatacenterChoice host =
+        SelectDatacenter(rows.data(), row_count, settings.regions.size(), r, settings.datacenter_objective);
+    outMatch.set_datacenter(settings.regions.Name(host.region));
+    outMatch.set_datacenter_ping_ms(host.ping_ms);
+
     if (metrics) {
         if (selected_count > 0) {
             metrics->average_mmr = static_cast<double>(sum_mmr_match) / static_cast<double>(selected_count);
@@ -349,15 +587,12 @@ bool MatchBuilder::BuildMatch(std::deque<PlayerEntry>& queue,
         }
     }
 
-    std::deque<PlayerEntry> remaining;
-
-    for (std::size_t i = 0; i < n; ++i) {
-        if (!selected_flags[i]) {
-            remaining.push_back(queue[i]);
-        }
-    }
-
-    queue.swap(remaining);
+    queue.RemoveIf([&](const PlayerEntry& entry) {
+        return std::find(selected_handles.begin(), selected_handles.begin() + row_count, entry.handle) !=
+               selected_handles.begin() + row_count;
+    });
+    DropFromPass(*pass, selected_flags);
+    pass->queue_version = queue.Version();
 
     return true;
 }
@@ -1,20 +1,114 @@
 #pragma once
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
 #include "matchmaker.pb.h"
-#include "PlayerEntry.h"
+#include "PlayerQueue.h"
 #include "EngineConfig.h"
+#include "EngineSettings.h"
+#include "MatchIdGenerator.h"
+#include "MmrHistogram.h"
 
 struct MatchMetrics {
     double average_mmr = 0.0;
     int min_mmr = 0;
     int max_mmr = 0;
     double average_wait_ms = 0.0;
+    // Each matched player's wait, in Match.players order.
+    std::array<std::int64_t, 2 * kMaxTeamSize> wait_ms{};
+    // Seeds whose match could still replace the best one found so far. Seeds the MMR
+    // histogram or the wait bounds rule out, and seeds that would form the best match
+    // found so far again, are not counted.
+    std::size_t seeds_evaluated = 0;
 };
 
+// Deadline and resume point of an incremental search. Seeds are tried longest wait
+// first, i.e. in enqueue order; a search that reaches the deadline records the next
+// untried seed, and the next call with the same object starts from it instead of from
+// the head of the queue. The deadline is checked between seeds, after at least one.
+struct MatchSearch {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Set while a search is suspended; cleared when a call tries every remaining seed.
+    bool suspended = false;
+    std::int64_t resume_queued_ms = 0;
+    std::string resume_id;
+    // Out: the last call stopped at the deadline. It still forms the best match found
+    // before stopping; the emergency stage waits until a search completes.
+    bool out_of_time = false;
+};
+
+// The allowed players within one ping window, in MMR order. A run is match_size of
+// them in a row, named by its first position: `run_wait` holds each run's summed wait,
+// and level j of `tightest` the tightest run (smallest MMR spread, first on ties) among
+// the runs starting at k through k + 2^j - 1.
+struct PingWindowRuns {
+    int ping_window = 0;
+    std::vector<std::size_t> players;
+    std::vector<int> mmr;
+    std::vector<long long> run_wait;
+    std::vector<std::vector<std::size_t>> tightest;
+};
+
+// Per-player state of one region at one now_ms, shared by the BuildMatch calls of a
+// matching pass. The first call builds it; each match then drops its players from it
+// the way it drops them from the queue, so later calls skip resolving, filtering and
+// sorting the queue again. Any other change to the queue, the region, the settings or
+// now_ms rebuilds it. Indexed like the queue.
+struct MatchPass {
+    bool valid = false;
+    const PlayerQueue* queue = nullptr;
+    std::uint64_t queue_version = 0;
+    const EngineSettings* settings = nullptr;
+    int region = -1;
+    std::int64_t now_ms = 0;
+
+    std::vector<long long> wait_ms;
+    // The region is open to the player at its current wait.
+    std::vector<char> allowed;
+    std::vector<int> region_ping;
+    // Allowed players ordered by MMR (ties in queue order), and their MMRs.
+    std::vector<std::size_t> by_mmr;
+    std::vector<int> sorted_mmr;
+    // Built on first use for each ping window the seeds ask for; cleared when a match
+    // drops players.
+    std::vector<PingWindowRuns> runs;
+};
+
+// Seeds are tried by wait whatever their place in `queue`, but the emergency stage and a
+// resumed search look players up by queued_ms: `queue` must be in enqueue order
+// (non-decreasing queued_ms), as the engine keeps it. Debug builds assert it there.
+// Waits are `now_ms` minus each entry's queued_ms, both on the queue's timeline.
 class MatchBuilder {
 public:
-    static bool BuildMatch(std::deque<PlayerEntry>& queue,
+    static bool BuildMatch(PlayerQueue& queue,
                            matchmaking::Match& outMatch,
                            const EngineConfig& config,
                            const std::string& region,
                            MatchMetrics* metrics = nullptr);
+
+    // Same as above, but measures queue waits at `now_ms` instead of at time 0.
+    static bool BuildMatch(PlayerQueue& queue,
+                           matchmaking::Match& outMatch,
+                           const EngineConfig& config,
+                           const std::string& region,
+                           std::int64_t now_ms,
+                           MatchMetrics* metrics = nullptr);
+
+    // Engine entry point: uses the relaxation curves precomputed in `settings`.
+    // `histogram` must count every player in `queue` by MMR; when null one is built
+    // for the call. Matched players are not removed from it. Match IDs come from `ids`,
+    // or from MatchIdGenerator::ProcessDefault() when null. `search`, when set, bounds
+    // the call's time and carries its resume point between calls. `pass`, when set, is
+    // reused across the calls of one pass instead of being rebuilt by each.
+    static bool BuildMatch(PlayerQueue& queue,
+                           matchmaking::Match& outMatch,
+                           const EngineSettings& settings,
+                           const std::string& region,
+                           std::int64_t now_ms,
+                           MatchMetrics* metrics = nullptr,
+                           const MmrHistogram* histogram = nullptr,
+                           MatchIdGenerator* ids = nullptr,
+                           MatchSearch* search = nullptr,
+                           MatchPass* pass = nullptr);
 };
@@ -0,0 +1,100 @@
+#include "MatchIdGenerator.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace {
+
+constexpr char kAlphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+int DecodeChar(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c = static_cast<char>(c - 'a' + 'A');
+    }
+    for (int i = 0; i < 32; ++i) {
+        if (kAlphabet[i] == c) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::uint64_t NowMs() {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count();
+    return static_cast<std::uint64_t>(std::max<long long>(ms, 0));
+}
+
+}  // namespace
+
+MatchIdGenerator::MatchIdGenerator(int node)
+    : node_(std::clamp(node, 0, kMaxNode)) {}
+
+std::uint64_t MatchIdGenerator::Next() {
+    const std::uint64_t now = NowMs();
+    const std::uint64_t since_epoch = now > kEpochMs ? now - kEpochMs : 0;
+    const std::uint64_t candidate = since_epoch << kSequenceBits;
+
+    // Sequence overflow within a millisecond borrows from the next one, so the clock
+    // never has to be waited on.
+    std::uint64_t last = last_.load(std::memory_order_relaxed);
+    std::uint64_t next;
+    do {
+        next = std::max(candidate, last + 1);
+    } while (!last_.compare_exchange_weak(last, next, std::memory_order_relaxed));
+
+    const std::uint64_t sequence_mask = (std::uint64_t{1} << kSequenceBits) - 1;
+    return ((next >> kSequenceBits) << (kNodeBits + kSequenceBits)) |
+           (static_cast<std::uint64_t>(node_) << kSequenceBits) |
+           (next & sequence_mask);
+}
+
+MatchIdGenerator::Encoded MatchIdGenerator::Encode(std::uint64_t id) {
+    Encoded out;
+    for (std::size_t i = kEncodedLength; i-- > 0;) {
+        out[i] = kAlphabet[id & 31];
+        id >>= 5;
+    }
+    return out;
+}
+
+bool MatchIdGenerator::Decode(std::string_view text, std::uint64_t& id) {
+    if (text.size() != kEncodedLength) {
+        return false;
+    }
+    // 13 digits hold 65 bits; the leading one may only carry the top bit.
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < kEncodedLength; ++i) {
+        int digit = DecodeChar(text[i]);
+        if (digit < 0 || (i == 0 && digit > 15)) {
+            return false;
+        }
+        value = (value << 5) | static_cast<std::uint64_t>(digit);
+    }
+    id = value;
+    return true;
+}
+
+int MatchIdGenerator::NodeOf(std::uint64_t id) {
+    return static_cast<int>((id >> kSequenceBits) & static_cast<std::uint64_t>(kMaxNode));
+}
+
+std::uint64_t MatchIdGenerator::TimestampMsOf(std::uint64_t id) {
+    return (id >> (kNodeBits + kSequenceBits)) + kEpochMs;
+}
+
+int MatchIdGenerator::DefaultNode() {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    std::size_t hash = std::hash<std::string>()(std::string(host) + ":" + std::to_string(getpid()));
+    return static_cast<int>(hash % static_cast<std::size_t>(kMaxNode + 1));
+}
+
+MatchIdGenerator& MatchIdGenerator::ProcessDefault() {
+    static MatchIdGenerator generator(DefaultNode());
+    return generator;
+}
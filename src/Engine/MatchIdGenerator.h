@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+// Snowflake-style 64-bit match IDs: 41 bits of milliseconds since 2024-01-01 UTC, 10 bits
+// of node and 12 bits of sequence. IDs from one generator are strictly increasing even if
+// the wall clock steps back; distinct nodes never collide. Next() is lock-free.
+class MatchIdGenerator {
+public:
+    static constexpr int kNodeBits = 10;
+    static constexpr int kSequenceBits = 12;
+    static constexpr int kMaxNode = (1 << kNodeBits) - 1;
+    static constexpr std::uint64_t kEpochMs = 1704067200000ULL;
+
+    // Fixed-width Crockford base32, so rendered IDs sort in ID order.
+    static constexpr std::size_t kEncodedLength = 13;
+    using Encoded = std::array<char, kEncodedLength>;
+
+    explicit MatchIdGenerator(int node);
+
+    std::uint64_t Next();
+    Encoded NextEncoded() { return Encode(Next()); }
+
+    int Node() const { return node_; }
+
+    static Encoded Encode(std::uint64_t id);
+    static bool Decode(std::string_view text, std::uint64_t& id);
+    static int NodeOf(std::uint64_t id);
+    static std::uint64_t TimestampMsOf(std::uint64_t id);
+
+    // Node hashed from the host name and process id, for offline drivers without a
+    // configured node_id. Two processes can draw the same node; servers must configure one.
+    static int DefaultNode();
+    // Shared generator on DefaultNode() for callers that do not own one.
+    static MatchIdGenerator& ProcessDefault();
+
+private:
+    int node_;
+    // Last issued (milliseconds << kSequenceBits | sequence).
+    std::atomic<std::uint64_t> last_{0};
+};
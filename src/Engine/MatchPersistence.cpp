@@ -1,6 +1,25 @@
 #include "MatchPersistence.h"
 
+#include <chrono>
 #include <fstream>
+#include <string_view>
+
+#include "common/ConfigParser.h"
+
+namespace {
+
+// JSON string literal of `value`. Most strings need no escaping and go out as they are.
+void WriteQuoted(std::ostream& out, std::string_view value) {
+    for (char c : value) {
+        if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+            out << config::Quote(value);
+            return;
+        }
+    }
+    out << '"' << value << '"';
+}
+
+}  // namespace
 
 MatchPersistence::MatchPersistence(const std::string& path)
     : path_(path) {}
@@ -12,7 +31,20 @@ void MatchPersistence::Append(const matchmaking::Match& match) {
     }
 
     out << "{";
-    out << "\"match_id\":\"" << match.match_id() << "\"";
+    out << "\"match_id\":";
+    WriteQuoted(out, match.match_id());
+    auto created_at_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    out << ",\"created_at_ms\":" << created_at_ms;
+    if (!match.queue_id().empty()) {
+        out << ",\"queue_id\":";
+        WriteQuoted(out, match.queue_id());
+    }
+    if (!match.datacenter().empty()) {
+        out << ",\"datacenter\":";
+        WriteQuoted(out, match.datacenter());
+        out << ",\"datacenter_ping_ms\":" << match.datacenter_ping_ms();
+    }
     out << ",\"players\":[";
     for (int i = 0; i < match.players_size(); ++i) {
         const auto& p = match.players(i);
@@ -20,13 +52,24 @@ void MatchPersistence::Append(const matchmaking::Match& match) {
             out << ",";
         }
         out << "{";
-        out << "\"id\":\"" << p.id() << "\"";
+        out << "\"id\":";
+        WriteQuoted(out, p.id());
         out << ",\"mmr\":" << p.mmr();
         out << ",\"ping\":" << p.ping();
         out << ",\"ping_na\":" << p.ping_na();
         out << ",\"ping_eu\":" << p.ping_eu();
         out << ",\"ping_asia\":" << p.ping_asia();
-        out << ",\"region\":\"" << p.region() << "\"";
+        out << ",\"region\":";
+        WriteQuoted(out, p.region());
+        if (p.pings_size() > 0) {
+            out << ",\"pings\":{";
+            for (int d = 0; d < p.pings_size(); ++d) {
+                out << (d > 0 ? "," : "");
+                WriteQuoted(out, p.pings(d).datacenter());
+                out << ":" << p.pings(d).ping_ms();
+            }
+            out << "}";
+        }
         out << "}";
     }
     out << "]";
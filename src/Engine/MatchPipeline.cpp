@@ -0,0 +1,78 @@
+#include "MatchPipeline.h"
+
+MatchPipeline::MatchPipeline(Stage deliver, Stage persist, std::size_t capacity)
+    : deliver_(std::move(deliver)),
+      persist_(std::move(persist)),
+      to_delivery_(capacity),
+      to_persistence_(capacity) {}
+
+MatchPipeline::~MatchPipeline() {
+    Stop();
+}
+
+void MatchPipeline::Start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    delivery_thread_ = std::thread(&MatchPipeline::DeliveryLoop, this);
+    persistence_thread_ = std::thread(&MatchPipeline::PersistenceLoop, this);
+}
+
+void MatchPipeline::Stop() {
+    if (!running_) {
+        return;
+    }
+    to_delivery_.Push(std::nullopt);
+    delivery_thread_.join();
+    persistence_thread_.join();
+    running_ = false;
+}
+
+void MatchPipeline::Push(FormedMatch match) {
+    ++pushed_;
+    if (!running_) {
+        deliver_(match);
+        persist_(match);
+        Finished();
+        return;
+    }
+    to_delivery_.Push(std::move(match));
+}
+
+void MatchPipeline::Flush() {
+    for (auto done = finished_.load(std::memory_order_acquire); done != pushed_;
+         done = finished_.load(std::memory_order_acquire)) {
+        finished_.wait(done, std::memory_order_acquire);
+    }
+}
+
+void MatchPipeline::DeliveryLoop() {
+    for (;;) {
+        auto item = to_delivery_.Pop();
+        if (item) {
+            deliver_(*item);
+        }
+        const bool stop = !item;
+        to_persistence_.Push(std::move(item));
+        if (stop) {
+            return;
+        }
+    }
+}
+
+void MatchPipeline::PersistenceLoop() {
+    for (;;) {
+        auto item = to_persistence_.Pop();
+        if (!item) {
+            return;
+        }
+        persist_(*item);
+        Finished();
+    }
+}
+
+void MatchPipeline::Finished() {
+    finished_.fetch_add(1, std::memory_order_release);
+    finished_.notify_all();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "matchmaker.pb.h"
+#include "EngineClock.h"
+#include "MatchBuilder.h"
+#include "PendingMatchStore.h"
+#include "SpscRing.h"
+
+struct FormedMatch {
+    // Moved into `handle` by the delivery stage.
+    matchmaking::Match match;
+    std::string region;
+    MatchMetrics metrics;
+    EngineClock::time_point formed_at;
+    PendingMatchStore::MatchHandle handle;
+};
+
+// Carries formed matches from the tick thread through delivery and then persistence,
+// each stage on its own thread and fed by an SPSC ring. Matching never waits for the
+// later stages unless a ring fills up, so throughput is bounded by the slowest stage
+// rather than by the sum of them. Before Start() (and after Stop()) Push runs both
+// stages inline, which keeps offline drivers deterministic.
+class MatchPipeline {
+public:
+    using Stage = std::function<void(FormedMatch&)>;
+
+    MatchPipeline(Stage deliver, Stage persist, std::size_t capacity);
+    ~MatchPipeline();
+
+    MatchPipeline(const MatchPipeline&) = delete;
+    MatchPipeline& operator=(const MatchPipeline&) = delete;
+
+    void Start();
+    // Finishes every match already pushed, then joins the stage threads.
+    void Stop();
+
+    // The producer side: Push and Flush must come from one thread at a time, the one
+    // that drives the engine's ticks.
+    void Push(FormedMatch match);
+    // Returns once every pushed match has been through both stages.
+    void Flush();
+
+private:
+    void DeliveryLoop();
+    void PersistenceLoop();
+    void Finished();
+
+    Stage deliver_;
+    Stage persist_;
+    // An empty slot tells the next stage to stop.
+    SpscRing<std::optional<FormedMatch>> to_delivery_;
+    SpscRing<std::optional<FormedMatch>> to_persistence_;
+    std::uint64_t pushed_ = 0;
+    std::atomic<std::uint64_t> finished_{0};
+    bool running_ = false;
+    std::thread delivery_thread_;
+    std::thread persistence_thread_;
+};
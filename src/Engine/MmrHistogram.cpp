@@ -0,0 +1,46 @@
+#include "MmrHistogram.h"
+
+#include <algorithm>
+
+MmrHistogram::MmrHistogram()
+    : counts_(static_cast<std::size_t>(kMaxMmr / kBucketWidth) + 1, 0),
+      prefix_(counts_.size() + 1, 0) {}
+
+std::size_t MmrHistogram::Bucket(int mmr) {
+    return static_cast<std::size_t>(std::clamp(mmr, 0, kMaxMmr) / kBucketWidth);
+}
+
+void MmrHistogram::Add(int mmr) {
+    ++counts_[Bucket(mmr)];
+    ++total_;
+    dirty_ = true;
+}
+
+void MmrHistogram::Remove(int mmr) {
+    auto& count = counts_[Bucket(mmr)];
+    if (count == 0) {
+        return;
+    }
+    --count;
+    --total_;
+    dirty_ = true;
+}
+
+void MmrHistogram::Clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    dirty_ = true;
+}
+
+std::size_t MmrHistogram::CountInRange(int min_mmr, int max_mmr) const {
+    if (min_mmr > max_mmr) {
+        return 0;
+    }
+    if (dirty_) {
+        for (std::size_t b = 0; b < counts_.size(); ++b) {
+            prefix_[b + 1] = prefix_[b] + counts_[b];
+        }
+        dirty_ = false;
+    }
+    return prefix_[Bucket(max_mmr) + 1] - prefix_[Bucket(min_mmr)];
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Queued player counts in fixed-width MMR buckets. Updated on every enqueue, cancel and
+// match; range counts come from prefix sums rebuilt lazily after the first query that
+// follows an update, so a matching pass pays for one rebuild and then O(1) per query.
+class MmrHistogram {
+public:
+    static constexpr int kBucketWidth = 25;
+    // MMRs outside [0, kMaxMmr] are clamped into the edge buckets.
+    static constexpr int kMaxMmr = 10000;
+
+    MmrHistogram();
+
+    void Add(int mmr);
+    void Remove(int mmr);
+    void Clear();
+
+    std::size_t Total() const { return total_; }
+
+    // Upper bound on the players with MMR in [min_mmr, max_mmr]: partially covered
+    // buckets count in full.
+    std::size_t CountInRange(int min_mmr, int max_mmr) const;
+
+private:
+    static std::size_t Bucket(int mmr);
+
+    std::vector<std::size_t> counts_;
+    std::size_t total_ = 0;
+    // prefix_[b] is the number of players in buckets [0, b).
+    mutable std::vector<std::size_t> prefix_;
+    mutable bool dirty_ = true;
+};
@@ -0,0 +1,176 @@
+#include "PendingMatchStore.h"
+
+#include <algorithm>
+
+namespace {
+
+// Rough per-entry bookkeeping on top of the message itself: the entry, its wheel slot and
+// one key per player reference.
+constexpr std::size_t kEntryOverhead = 64;
+constexpr std::size_t kReferenceOverhead = 48;
+
+}  // namespace
+
+PendingMatch::PendingMatch(matchmaking::Match m)
+    : match(std::move(m)) {
+    match.SerializeToString(&wire);
+}
+
+PendingMatchStore::PendingMatchStore(std::chrono::milliseconds ttl, std::size_t max_bytes)
+    : ttl_(ttl),
+      max_bytes_(max_bytes),
+      wheel_(kSlotCount) {}
+
+void PendingMatchStore::SetLimits(std::chrono::milliseconds ttl, std::size_t max_bytes) {
+    ttl_ = ttl;
+    max_bytes_ = max_bytes;
+}
+
+std::int64_t PendingMatchStore::ToMs(time_point t) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+}
+
+void PendingMatchStore::Add(MatchHandle match, time_point now) {
+    if (!match || match->match.players_size() == 0) {
+        return;
+    }
+    if (wheel_slot_ < 0) {
+        wheel_slot_ = ToMs(now) / kSlotMs;
+    }
+
+    const std::uint64_t key = next_key_++;
+    Entry entry;
+    entry.bytes = match->match.SpaceUsedLong() + match->wire.size() + kEntryOverhead +
+                  kReferenceOverhead * static_cast<std::size_t>(match->match.players_size());
+    entry.undelivered = static_cast<std::size_t>(match->match.players_size());
+    entry.expires_ms = ToMs(now) + ttl_.count();
+    for (const auto& player : match->match.players()) {
+        by_player_[player.id()].push_back(key);
+    }
+    entry.match = std::move(match);
+
+    // Slots behind the cursor are not visited again until the next round.
+    const std::int64_t slot = std::max(entry.expires_ms / kSlotMs, wheel_slot_);
+    wheel_[static_cast<std::size_t>(slot) % kSlotCount].push_back(key);
+
+    stats_.matches += 1;
+    stats_.deliveries += entry.undelivered;
+    stats_.bytes += entry.bytes;
+    entries_.emplace(key, std::move(entry));
+
+    while (stats_.bytes > max_bytes_ && entries_.size() > 1) {
+        Drop(entries_.begin());
+        stats_.evicted_for_memory += 1;
+    }
+}
+
+std::vector<PendingMatchStore::MatchHandle> PendingMatchStore::Peek(const std::string& player_id) const {
+    std::vector<MatchHandle> result;
+    auto it = by_player_.find(player_id);
+    if (it == by_player_.end()) {
+        return result;
+    }
+    result.reserve(it->second.size());
+    for (std::uint64_t key : it->second) {
+        result.push_back(entries_.at(key).match);
+    }
+    return result;
+}
+
+bool PendingMatchStore::Acknowledge(const std::string& player_id, const std::string& match_id) {
+    auto it = by_player_.find(player_id);
+    if (it == by_player_.end()) {
+        return false;
+    }
+    for (std::uint64_t key : it->second) {
+        if (entries_.at(key).match->match.match_id() == match_id) {
+            Release(key, player_id);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<PendingMatchStore::MatchHandle> PendingMatchStore::Take(const std::string& player_id) {
+    std::vector<MatchHandle> result = Peek(player_id);
+    auto it = by_player_.find(player_id);
+    if (it == by_player_.end()) {
+        return result;
+    }
+    const std::vector<std::uint64_t> keys = it->second;
+    for (std::uint64_t key : keys) {
+        Release(key, player_id);
+    }
+    return result;
+}
+
+void PendingMatchStore::Release(std::uint64_t key, const std::string& player_id) {
+    auto refs = by_player_.find(player_id);
+    if (refs != by_player_.end()) {
+        auto& keys = refs->second;
+        keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+        if (keys.empty()) {
+            by_player_.erase(refs);
+        }
+    }
+
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return;
+    }
+    it->second.undelivered -= 1;
+    stats_.deliveries -= 1;
+    if (it->second.undelivered == 0) {
+        stats_.matches -= 1;
+        stats_.bytes -= it->second.bytes;
+        entries_.erase(it);
+    }
+}
+
+void PendingMatchStore::Drop(std::map<std::uint64_t, Entry>::iterator it) {
+    const std::uint64_t key = it->first;
+    const Entry& entry = it->second;
+    for (const auto& player : entry.match->match.players()) {
+        auto refs = by_player_.find(player.id());
+        if (refs == by_player_.end()) {
+            continue;
+        }
+        auto& keys = refs->second;
+        keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+        if (keys.empty()) {
+            by_player_.erase(refs);
+        }
+    }
+    stats_.matches -= 1;
+    stats_.deliveries -= entry.undelivered;
+    stats_.bytes -= entry.bytes;
+    entries_.erase(it);
+}
+
+void PendingMatchStore::Expire(time_point now) {
+    if (wheel_slot_ < 0) {
+        return;
+    }
+    const std::int64_t now_ms = ToMs(now);
+    const std::int64_t target = now_ms / kSlotMs;
+    // After a long idle gap one full turn visits every slot.
+    const std::int64_t first = std::max(wheel_slot_, target - static_cast<std::int64_t>(kSlotCount) + 1);
+    for (std::int64_t slot = first; slot <= target; ++slot) {
+        auto& keys = wheel_[static_cast<std::size_t>(slot) % kSlotCount];
+        std::size_t kept = 0;
+        for (std::uint64_t key : keys) {
+            auto it = entries_.find(key);
+            if (it == entries_.end()) {
+                continue;
+            }
+            if (it->second.expires_ms <= now_ms) {
+                Drop(it);
+                stats_.expired += 1;
+            } else {
+                keys[kept++] = key;
+            }
+        }
+        keys.resize(kept);
+    }
+    wheel_slot_ = target;
+}
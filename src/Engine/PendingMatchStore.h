@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "matchmaker.pb.h"
+
+struct PendingMatchStats {
+    // Matches with at least one player that has not acknowledged delivery.
+    std::size_t matches = 0;
+    // Outstanding (player, match) deliveries.
+    std::size_t deliveries = 0;
+    std::size_t bytes = 0;
+    // Totals since start of matches dropped before every player acknowledged them.
+    std::uint64_t expired = 0;
+    std::uint64_t evicted_for_memory = 0;
+};
+
+// A formed match and its wire encoding, serialized once and shared by every recipient.
+struct PendingMatch {
+    matchmaking::Match match;
+    std::string wire;
+
+    explicit PendingMatch(matchmaking::Match m);
+};
+
+// Formed matches awaiting delivery. Each match is stored once behind a shared handle;
+// players hold references to it until they acknowledge delivery. Undelivered matches
+// expire after a TTL tracked on a timer wheel, and the oldest are evicted early when
+// the store grows past its byte budget. Not thread-safe; the engine locks around it.
+class PendingMatchStore {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+    using MatchHandle = std::shared_ptr<const PendingMatch>;
+
+    PendingMatchStore(std::chrono::milliseconds ttl, std::size_t max_bytes);
+
+    // TTL applies to matches added afterwards; the byte budget applies on the next Add.
+    void SetLimits(std::chrono::milliseconds ttl, std::size_t max_bytes);
+
+    void Add(MatchHandle match, time_point now);
+
+    // Matches not yet acknowledged by `player_id`, oldest first.
+    std::vector<MatchHandle> Peek(const std::string& player_id) const;
+    bool Acknowledge(const std::string& player_id, const std::string& match_id);
+    // Peek and acknowledge everything in one step.
+    std::vector<MatchHandle> Take(const std::string& player_id);
+
+    // Drops matches whose TTL has passed.
+    void Expire(time_point now);
+
+    PendingMatchStats Stats() const { return stats_; }
+
+private:
+    static constexpr std::int64_t kSlotMs = 250;
+    static constexpr std::size_t kSlotCount = 512;
+
+    struct Entry {
+        MatchHandle match;
+        std::size_t bytes = 0;
+        std::size_t undelivered = 0;
+        std::int64_t expires_ms = 0;
+    };
+
+    std::int64_t ToMs(time_point t) const;
+    void Release(std::uint64_t key, const std::string& player_id);
+    void Drop(std::map<std::uint64_t, Entry>::iterator it);
+
+    std::chrono::milliseconds ttl_;
+    std::size_t max_bytes_;
+
+    // Keyed by insertion sequence, so begin() is the oldest match.
+    std::map<std::uint64_t, Entry> entries_;
+    std::unordered_map<std::string, std::vector<std::uint64_t>> by_player_;
+    std::uint64_t next_key_ = 0;
+
+    // Hashed timer wheel of entry keys by expiry slot. Keys already delivered or evicted
+    // are skipped when their slot comes round; entries due in a later round stay put.
+    std::vector<std::vector<std::uint64_t>> wheel_;
+    std::int64_t wheel_slot_ = -1;
+
+    PendingMatchStats stats_;
+};
@@ -1,13 +1,22 @@
 #pragma once
 
-#include <chrono>
-#include "matchmaker.pb.h"
+#include <cstdint>
+#include <type_traits>
 
+// One queued player as the matcher scans it. The Player message (id included) and its
+// resolved pings live in the owning PlayerQueue's side table under `handle`.
 struct PlayerEntry {
-    matchmaking::Player player;
-    std::chrono::steady_clock::time_point queuedAt;
+    static constexpr std::uint8_t kNoRegion = 0xff;
 
-    explicit PlayerEntry(const matchmaking::Player& p)
-        : player(p),
-          queuedAt(std::chrono::steady_clock::now()) {}
+    // Enqueue time in whole milliseconds on the queue's timeline; the engine's counts
+    // from its start.
+    std::int64_t queued_ms = 0;
+    std::uint32_t handle = 0;
+    std::int32_t mmr = 0;
+    // Home region's index in the region table the entry was last resolved against, or
+    // kNoRegion when the table does not list it.
+    std::uint8_t region = kNoRegion;
 };
+
+static_assert(std::is_trivially_copyable_v<PlayerEntry>);
+static_assert(sizeof(PlayerEntry) <= 32, "queue records should stay two to a cache line");
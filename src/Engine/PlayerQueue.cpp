@@ -0,0 +1,41 @@
+#include "PlayerQueue.h"
+
+PlayerEntry& PlayerQueue::Push(const matchmaking::Player& player, std::int64_t queued_ms) {
+    std::uint32_t handle;
+    if (!free_handles_.empty()) {
+        handle = free_handles_.back();
+        free_handles_.pop_back();
+        players_[handle] = player;
+        pings_keys_[handle] = 0;
+    } else {
+        handle = static_cast<std::uint32_t>(players_.size());
+        players_.push_back(player);
+        pings_.emplace_back();
+        pings_keys_.push_back(0);
+    }
+
+    PlayerEntry entry;
+    entry.queued_ms = queued_ms;
+    entry.handle = handle;
+    entry.mmr = player.mmr();
+    entries_.push_back(entry);
+    ++version_;
+    return entries_.back();
+}
+
+void PlayerQueue::ResolvePings(PlayerEntry& entry, const RegionTable& table) {
+    if (pings_keys_[entry.handle] == table.Key()) {
+        return;
+    }
+    const matchmaking::Player& player = players_[entry.handle];
+    pings_[entry.handle] = table.Resolve(player);
+    pings_keys_[entry.handle] = table.Key();
+    const int region = table.IndexOf(player.region());
+    entry.region = region < 0 ? PlayerEntry::kNoRegion : static_cast<std::uint8_t>(region);
+}
+
+void PlayerQueue::Release(std::uint32_t handle) {
+    // Clear keeps the message's string capacity for the next player given this handle.
+    players_[handle].Clear();
+    free_handles_.push_back(handle);
+}
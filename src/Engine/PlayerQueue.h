@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "matchmaker.pb.h"
+#include "PlayerEntry.h"
+#include "RegionTable.h"
+
+// A queue of players in enqueue order. The records the matcher scans are compact
+// PlayerEntry values; each player's message and resolved pings sit in dense side
+// arrays indexed by the record's handle and are only touched to check pings or to
+// materialize a match. Handles are reused once their player leaves.
+class PlayerQueue {
+public:
+    using iterator = std::deque<PlayerEntry>::iterator;
+    using const_iterator = std::deque<PlayerEntry>::const_iterator;
+
+    // Copies `player` into the side table and appends its record.
+    PlayerEntry& Push(const matchmaking::Player& player, std::int64_t queued_ms = 0);
+
+    std::size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    PlayerEntry& operator[](std::size_t i) { return entries_[i]; }
+    const PlayerEntry& operator[](std::size_t i) const { return entries_[i]; }
+    PlayerEntry& front() { return entries_.front(); }
+    const PlayerEntry& front() const { return entries_.front(); }
+    PlayerEntry& back() { return entries_.back(); }
+    const PlayerEntry& back() const { return entries_.back(); }
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+    // Bumped by every Push and every RemoveIf that removes something.
+    std::uint64_t Version() const { return version_; }
+
+    const matchmaking::Player& PlayerOf(const PlayerEntry& entry) const { return players_[entry.handle]; }
+    // Valid after ResolvePings with the table in use.
+    const RegionPings& PingsOf(const PlayerEntry& entry) const { return pings_[entry.handle]; }
+
+    // Resolves the entry's pings, ranks and home region against `table`; a no-op when
+    // they were already resolved against it.
+    void ResolvePings(PlayerEntry& entry, const RegionTable& table);
+
+    // Removes the entries `remove` selects, keeping the rest in order, and releases
+    // their handles. Returns how many were removed.
+    template <typename Pred>
+    std::size_t RemoveIf(Pred remove) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            if (remove(static_cast<const PlayerEntry&>(entries_[i]))) {
+                Release(entries_[i].handle);
+            } else {
+                entries_[kept++] = entries_[i];
+            }
+        }
+        const std::size_t removed = entries_.size() - kept;
+        entries_.resize(kept);
+        if (removed > 0) {
+            ++version_;
+        }
+        return removed;
+    }
+
+private:
+    void Release(std::uint32_t handle);
+
+    std::deque<PlayerEntry> entries_;
+    // Side table, indexed by handle.
+    std::vector<matchmaking::Player> players_;
+    std::vector<RegionPings> pings_;
+    // RegionTable::Key() each handle's pings were resolved against (0 = not resolved).
+    std::vector<std::uint64_t> pings_keys_;
+    std::vector<std::uint32_t> free_handles_;
+    std::uint64_t version_ = 0;
+};
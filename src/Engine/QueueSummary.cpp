@@ -0,0 +1,123 @@
+#include "QueueSummary.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+std::string MakePageToken(const QueueSummaryEntry& last) {
+    return std::to_string(last.queued_ms) + ":" + last.id;
+}
+
+// Index of the first entry after the token's position. If the player the token names
+// has left, resumes at the first player enqueued at the same instant: a page may then
+// repeat players but never skips one.
+std::size_t ResumeIndex(const QueueSummary& summary, const std::string& token) {
+    if (token.empty()) {
+        return 0;
+    }
+    auto colon = token.find(':');
+    if (colon == std::string::npos) {
+        return 0;
+    }
+    std::int64_t queued_ms = 0;
+    auto [end, ec] = std::from_chars(token.data(), token.data() + colon, queued_ms);
+    if (ec != std::errc() || end != token.data() + colon) {
+        return 0;
+    }
+    const std::string id = token.substr(colon + 1);
+
+    const auto& players = summary.players;
+    auto first = std::lower_bound(players.begin(), players.end(), queued_ms,
+                                  [](const QueueSummaryEntry& e, std::int64_t t) { return e.queued_ms < t; });
+    for (auto it = first; it != players.end() && it->queued_ms == queued_ms; ++it) {
+        if (it->id == id) {
+            return static_cast<std::size_t>(it - players.begin()) + 1;
+        }
+    }
+    return static_cast<std::size_t>(first - players.begin());
+}
+
+}  // namespace
+
+void FillQueuePage(const QueueSummary& summary, const QueueQuery& query, matchmaking::QueueSnapshot& out) {
+    out.set_version(summary.version);
+    out.set_total_players(summary.players.size());
+
+    auto matches = [&](const QueueSummaryEntry& e) {
+        return (query.region.empty() || e.region == query.region) &&
+               (query.queue_id.empty() || e.queue_id == query.queue_id) &&
+               e.mmr >= query.min_mmr && e.mmr <= query.max_mmr;
+    };
+
+    std::size_t matching = 0;
+    const QueueSummaryEntry* last = nullptr;
+    bool more = false;
+    const std::size_t start = ResumeIndex(summary, query.page_token);
+    for (std::size_t i = 0; i < summary.players.size(); ++i) {
+        const auto& entry = summary.players[i];
+        if (!matches(entry)) {
+            continue;
+        }
+        ++matching;
+        if (i < start) {
+            continue;
+        }
+        if (static_cast<std::size_t>(out.players_size()) == query.page_size) {
+            more = true;
+            continue;
+        }
+
+        const std::int64_t waited_ms = std::max<std::int64_t>(0, summary.taken_ms - entry.queued_ms);
+        auto* qp = out.add_players();
+        qp->set_id(entry.id);
+        qp->set_region(entry.region);
+        qp->set_queue_id(entry.queue_id);
+        qp->set_mmr(entry.mmr);
+        for (std::size_t r = 0; r < summary.regions.size(); ++r) {
+            const std::string& name = summary.regions[r];
+            const int ping = entry.pings.ping[r];
+            auto* dc = qp->add_pings();
+            dc->set_datacenter(name);
+            dc->set_ping_ms(ping);
+            if (name == "NA") {
+                qp->set_ping_na(ping);
+            } else if (name == "EU") {
+                qp->set_ping_eu(ping);
+            } else if (name == "ASIA") {
+                qp->set_ping_asia(ping);
+            }
+        }
+        qp->set_waited_seconds(static_cast<double>(waited_ms) / 1000.0);
+        last = &entry;
+    }
+
+    out.set_matching_players(matching);
+    if (more && last) {
+        out.set_next_page_token(MakePageToken(*last));
+    }
+}
+
+bool FillQueueStatus(const QueueSummary& summary, const std::string& player_id, std::int64_t now_ms,
+                     matchmaking::QueueStatus& out) {
+    auto it = summary.index.find(player_id);
+    if (it == summary.index.end()) {
+        return false;
+    }
+    const QueueSummaryEntry& entry = summary.players[it->second];
+    const std::int64_t waited_ms = now_ms - entry.queued_ms;
+    const std::int64_t age_ms = now_ms - summary.taken_ms;
+    out.set_queue_id(entry.queue_id);
+    out.set_region(entry.region);
+    out.set_position(entry.position);
+    out.set_queue_size(entry.region_queue);
+    out.set_waited_seconds(static_cast<double>(waited_ms) / 1000.0);
+    if (entry.estimated_wait_ms < 0) {
+        out.set_estimated_wait_seconds(-1.0);
+    } else {
+        const auto remaining_ms = std::max<std::int64_t>(0, entry.estimated_wait_ms - age_ms);
+        out.set_estimated_wait_seconds(static_cast<double>(remaining_ms) / 1000.0);
+    }
+    out.set_version(summary.version);
+    return true;
+}
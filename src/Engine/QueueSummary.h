@@ -0,0 +1,61 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "RegionTable.h"
+#include "matchmaker.pb.h"
+
+struct QueueSummaryEntry {
+    std::string id;
+    std::string queue_id;
+    std::string region;
+    int mmr = 0;
+    // Indexed like QueueSummary::regions.
+    RegionPings pings;
+    // Engine milliseconds, like taken_ms.
+    std::int64_t queued_ms = 0;
+    // 1-based place among the playlist's players from the same home region, longest
+    // wait first, and how many of them there are.
+    std::uint32_t position = 0;
+    std::uint32_t region_queue = 0;
+    // Remaining wait estimated when the summary was taken; -1 when there is no estimate.
+    std::int64_t estimated_wait_ms = -1;
+};
+
+// Immutable copy of the queues published by the tick thread; readers never see the live
+// queues. Entries of every playlist are merged in enqueue order.
+struct QueueSummary {
+    std::uint64_t version = 0;
+    // Milliseconds since the engine started.
+    std::int64_t taken_ms = 0;
+    std::vector<std::string> regions;
+    std::vector<QueueSummaryEntry> players;
+    // Player id -> index into players.
+    std::unordered_map<std::string, std::size_t> index;
+};
+
+struct QueueQuery {
+    // Empty matches every home region / playlist.
+    std::string region;
+    std::string queue_id;
+    int min_mmr = INT_MIN;
+    int max_mmr = INT_MAX;
+    std::size_t page_size = std::numeric_limits<std::size_t>::max();
+    // next_page_token of the previous page. Tokens name a queue position rather than an
+    // offset, so paging stays consistent while players join and leave between pages.
+    std::string page_token;
+};
+
+// Fills one page of players matching `query`, plus totals and the next page token.
+void FillQueuePage(const QueueSummary& summary, const QueueQuery& query, matchmaking::QueueSnapshot& out);
+
+// Fills `player_id`'s queue status as of `now_ms` (engine milliseconds), aging the
+// summary's wait estimate by the time since it was taken. Fails when the player was not
+// queued in the summary.
+bool FillQueueStatus(const QueueSummary& summary, const std::string& player_id, std::int64_t now_ms,
+                     matchmaking::QueueStatus& out);
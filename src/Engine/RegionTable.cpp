@@ -0,0 +1,178 @@
+#include "RegionTable.h"
+
+#include <algorithm>
+#include <limits>
+
+using matchmaking::Player;
+
+namespace {
+
+static_assert((kMaxRegions & (kMaxRegions - 1)) == 0, "the sorting network needs a power-of-two width");
+static_assert(kMaxRegions <= 256, "ranks and sort keys store region indices in 8 bits");
+
+struct Comparator {
+    std::uint8_t lo;
+    std::uint8_t hi;
+};
+
+// Batcher's odd-even merge sort over kMaxRegions lanes; calls emit(lo, hi) per comparator.
+template <typename Emit>
+constexpr void ForEachComparator(Emit&& emit) {
+    constexpr std::size_t n = kMaxRegions;
+    for (std::size_t p = 1; p < n; p <<= 1) {
+        for (std::size_t k = p; k >= 1; k >>= 1) {
+            for (std::size_t j = k % p; j + k < n; j += 2 * k) {
+                for (std::size_t i = 0; i < std::min(k, n - j - k); ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        emit(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+constexpr std::size_t ComparatorCount() {
+    std::size_t count = 0;
+    ForEachComparator([&](std::size_t, std::size_t) { ++count; });
+    return count;
+}
+
+constexpr auto kNetwork = [] {
+    std::array<Comparator, ComparatorCount()> network{};
+    std::size_t next = 0;
+    ForEachComparator([&](std::size_t lo, std::size_t hi) {
+        network[next++] = Comparator{static_cast<std::uint8_t>(lo), static_cast<std::uint8_t>(hi)};
+    });
+    return network;
+}();
+
+int LegacyPing(const Player& p, std::string_view region) {
+    if (region == "NA") {
+        return p.ping_na();
+    } else if (region == "EU") {
+        return p.ping_eu();
+    } else if (region == "ASIA") {
+        return p.ping_asia();
+    }
+    return 0;
+}
+
+}  // namespace
+
+RegionTable::RegionTable(std::vector<std::string> names)
+    : names_(std::move(names)) {
+    if (names_.size() > kMaxRegions) {
+        names_.resize(kMaxRegions);
+    }
+    std::uint64_t hash = 1469598103934665603ull;
+    for (const auto& name : names_) {
+        for (char c : name) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xffu) * 1099511628211ull;
+    }
+    key_ = hash == 0 ? 1 : hash;
+}
+
+int RegionTable::IndexOf(std::string_view name) const {
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+        if (names_[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+RegionPings RegionTable::Resolve(const Player& player) const {
+    RegionPings out;
+    // Sort keys are (ping << 8 | region index), so equal pings rank in table order;
+    // unused lanes sort last.
+    std::array<std::uint32_t, kMaxRegions> keys;
+    keys.fill(std::numeric_limits<std::uint32_t>::max());
+
+    for (std::size_t r = 0; r < names_.size(); ++r) {
+        int ping = 0;
+        for (const auto& dc : player.pings()) {
+            if (dc.datacenter() == names_[r]) {
+                ping = dc.ping_ms();
+                break;
+            }
+        }
+        if (ping <= 0) {
+            ping = LegacyPing(player, names_[r]);
+        }
+        if (ping <= 0) {
+            ping = player.ping();
+        }
+        ping = std::clamp(ping, 0, static_cast<int>(std::numeric_limits<std::uint16_t>::max()));
+        out.ping[r] = static_cast<std::uint16_t>(ping);
+        keys[r] = (static_cast<std::uint32_t>(ping) << 8) | static_cast<std::uint32_t>(r);
+    }
+
+    for (const Comparator& c : kNetwork) {
+        const std::uint32_t a = keys[c.lo];
+        const std::uint32_t b = keys[c.hi];
+        keys[c.lo] = std::min(a, b);
+        keys[c.hi] = std::max(a, b);
+    }
+    for (std::size_t position = 0; position < names_.size(); ++position) {
+        out.rank[keys[position] & 0xffu] = static_cast<std::uint8_t>(position);
+    }
+    return out;
+}
+
+bool RegionTable::IsValidName(std::string_view name) {
+    if (name.empty() || name.size() > 32) {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+    });
+}
+
+bool ParseDatacenterObjective(std::string_view name, DatacenterObjective& out) {
+    if (name == "max") {
+        out = DatacenterObjective::MaxPing;
+    } else if (name == "p90") {
+        out = DatacenterObjective::P90Ping;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+DatacenterChoice SelectDatacenter(const RegionPings* const* rows,
+                                  std::size_t row_count,
+                                  std::size_t region_count,
+                                  std::size_t preferred,
+                                  DatacenterObjective objective) {
+    // Lane-wise largest and second-largest ping across the rows. Every lane is updated
+    // with the same min/max sequence, so the loops vectorize over the fixed stride.
+    std::array<std::uint16_t, kMaxRegions> largest{};
+    std::array<std::uint16_t, kMaxRegions> second{};
+    for (std::size_t i = 0; i < row_count; ++i) {
+        const auto& ping = rows[i]->ping;
+        for (std::size_t r = 0; r < kMaxRegions; ++r) {
+            second[r] = std::max(second[r], std::min(largest[r], ping[r]));
+            largest[r] = std::max(largest[r], ping[r]);
+        }
+    }
+
+    // Nearest-rank p90 is the k-th largest ping with k = n - ceil(0.9 n) + 1: the maximum
+    // below 10 players and the second largest for 10-19. Larger groups fall back to the
+    // maximum.
+    const std::size_t k = row_count - (row_count * 9 + 9) / 10 + 1;
+    const auto& score = objective == DatacenterObjective::P90Ping && k == 2 ? second : largest;
+
+    DatacenterChoice best;
+    best.region = preferred < region_count ? preferred : 0;
+    best.ping_ms = region_count > 0 ? score[best.region] : 0;
+    for (std::size_t r = 0; r < region_count; ++r) {
+        if (score[r] < best.ping_ms) {
+            best.region = r;
+            best.ping_ms = score[r];
+        }
+    }
+    return best;
+}
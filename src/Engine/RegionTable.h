@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "matchmaker.pb.h"
+
+// Upper bound on configured datacenters; per-player ping rows have this fixed stride.
+constexpr std::size_t kMaxRegions = 16;
+
+// One player's ping to every configured region, in table order, and each region's rank
+// (0 = lowest ping) among them. Resolved once per player and region table.
+struct RegionPings {
+    std::array<std::uint16_t, kMaxRegions> ping{};
+    std::array<std::uint8_t, kMaxRegions> rank{};
+};
+
+// What a match's hosting datacenter minimizes: the worst player's ping, or the nearest-rank
+// p90, which for a 10-player match ignores the single worst ping.
+enum class DatacenterObjective {
+    MaxPing,
+    P90Ping,
+};
+
+bool ParseDatacenterObjective(std::string_view name, DatacenterObjective& out);
+
+struct DatacenterChoice {
+    std::size_t region = 0;
+    int ping_ms = 0;
+};
+
+// Picks the region whose objective ping over `rows` is lowest; ties go to `preferred`,
+// then to table order. Each row must be resolved against a table of `region_count`
+// regions.
+DatacenterChoice SelectDatacenter(const RegionPings* const* rows,
+                                  std::size_t row_count,
+                                  std::size_t region_count,
+                                  std::size_t preferred,
+                                  DatacenterObjective objective);
+
+// The configured datacenters. A player's ping to a region comes from the matching
+// Player.pings entry, then the legacy ping_na/ping_eu/ping_asia field for regions named
+// NA, EU or ASIA, then Player.ping; zero values fall through to the next source.
+class RegionTable {
+public:
+    explicit RegionTable(std::vector<std::string> names);
+
+    std::size_t size() const { return names_.size(); }
+    const std::vector<std::string>& Names() const { return names_; }
+    const std::string& Name(std::size_t index) const { return names_[index]; }
+    // -1 when `name` is not configured.
+    int IndexOf(std::string_view name) const;
+    // Equal for tables with the same regions in the same order; never 0.
+    std::uint64_t Key() const { return key_; }
+
+    RegionPings Resolve(const matchmaking::Player& player) const;
+
+    // Region names are 1-32 characters of [A-Za-z0-9_-].
+    static bool IsValidName(std::string_view name);
+
+private:
+    std::vector<std::string> names_;
+    std::uint64_t key_ = 0;
+};
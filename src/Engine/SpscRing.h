@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Bounded single-producer, single-consumer ring. Push blocks while the ring is full and
+// Pop while it is empty; both park on the other side's index with atomic wait, so an
+// idle consumer costs nothing and a notify with nobody waiting stays in user space.
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer thread only.
+    void Push(T item) {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == slots_.size()) {
+                head_.wait(cached_head_, std::memory_order_acquire);
+            }
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+    }
+
+    // Consumer thread only.
+    T Pop() {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        while (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (cached_tail_ == head) {
+                tail_.wait(cached_tail_, std::memory_order_acquire);
+            }
+        }
+        T item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return item;
+    }
+
+private:
+    static constexpr std::size_t kLine = 64;
+
+    std::vector<T> slots_;
+    std::uint64_t mask_ = 0;
+    // Each index and the other side's cached copy of it live on separate lines.
+    alignas(kLine) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t cached_tail_ = 0;
+    alignas(kLine) std::atomic<std::uint64_t> tail_{0};
+    std::uint64_t cached_head_ = 0;
+};
@@ -0,0 +1,124 @@
+#include "WaitEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Samples lose 5% of their weight every 10 s, a half-life of a little over two minutes.
+constexpr std::int64_t kDecayIntervalMs = 10000;
+constexpr double kDecay = 0.95;
+// Buckets whose weight decays below this are emptied.
+constexpr float kMinWeight = 1e-3f;
+
+}  // namespace
+
+WaitEstimator::WaitEstimator() {
+    Reset();
+}
+
+void WaitEstimator::Reset() {
+    buckets_.assign(kBuckets, Bucket{});
+    for (auto& bucket : buckets_) {
+        bucket.median_from.fill(-1);
+    }
+    last_decay_ms_ = -1;
+    decayed_window_ms_ = 0.0;
+    window_ms_ = 0.0;
+}
+
+std::size_t WaitEstimator::BucketOf(std::size_t region, int mmr) {
+    const auto bracket = static_cast<std::size_t>(std::clamp(mmr / kBracketWidth, 0, static_cast<int>(kBrackets) - 1));
+    return std::min(region, kRegionSlots - 1) * kBrackets + bracket;
+}
+
+void WaitEstimator::RecordMatched(std::size_t region, int mmr, std::int64_t wait_ms) {
+    Bucket& bucket = buckets_[BucketOf(region, mmr)];
+    const auto bin = static_cast<std::size_t>(std::max<std::int64_t>(wait_ms, 0) / kWaitBinMs);
+    bucket.waits[std::min(bin, kWaitBins - 1)] += 1.0f;
+    bucket.matched += 1.0f;
+    bucket.dirty = true;
+}
+
+void WaitEstimator::Refresh(std::int64_t now_ms) {
+    if (last_decay_ms_ < 0) {
+        last_decay_ms_ = now_ms;
+    }
+    const std::int64_t intervals = std::max<std::int64_t>(0, (now_ms - last_decay_ms_) / kDecayIntervalMs);
+    if (intervals > 0) {
+        // k decays at once: w_k = d^k w_0 + T d (1 - d^k) / (1 - d).
+        const double factor = std::pow(kDecay, static_cast<double>(intervals));
+        decayed_window_ms_ = factor * decayed_window_ms_ +
+                             static_cast<double>(kDecayIntervalMs) * kDecay * (1.0 - factor) / (1.0 - kDecay);
+        last_decay_ms_ += intervals * kDecayIntervalMs;
+        for (auto& bucket : buckets_) {
+            if (bucket.matched == 0.0f) {
+                continue;
+            }
+            // Uniform scaling leaves the medians alone; only emptied buckets need a rebuild.
+            bucket.matched *= static_cast<float>(factor);
+            for (float& weight : bucket.waits) {
+                weight *= static_cast<float>(factor);
+            }
+            if (bucket.matched < kMinWeight) {
+                bucket.waits.fill(0.0f);
+                bucket.matched = 0.0f;
+                bucket.dirty = true;
+            }
+        }
+    }
+    window_ms_ = decayed_window_ms_ + static_cast<double>(now_ms - last_decay_ms_);
+
+    for (auto& bucket : buckets_) {
+        if (bucket.dirty) {
+            Rebuild(bucket);
+            bucket.dirty = false;
+        }
+    }
+}
+
+void WaitEstimator::Rebuild(Bucket& bucket) {
+    // suffix[b] is the weight of bins b and later. The median of the samples from bin b
+    // on sits in the first bin m with suffix[m + 1] <= suffix[b] / 2, and m only moves
+    // right as b does.
+    std::array<double, kWaitBins + 1> suffix{};
+    for (std::size_t b = kWaitBins; b-- > 0;) {
+        suffix[b] = suffix[b + 1] + bucket.waits[b];
+    }
+    std::size_t m = 0;
+    for (std::size_t b = 0; b < kWaitBins; ++b) {
+        if (suffix[b] <= 0.0) {
+            bucket.median_from[b] = -1;
+            continue;
+        }
+        const double half = suffix[b] / 2.0;
+        m = std::max(m, b);
+        while (suffix[m + 1] > half) {
+            ++m;
+        }
+        // Interpolate within bin m.
+        const double before = suffix[b] - suffix[m];
+        const double fraction = bucket.waits[m] > 0.0f ? (half - before) / bucket.waits[m] : 0.5;
+        bucket.median_from[b] =
+            static_cast<std::int32_t>((static_cast<double>(m) + fraction) * static_cast<double>(kWaitBinMs));
+    }
+}
+
+std::int64_t WaitEstimator::Estimate(std::size_t region, int mmr, std::int64_t waited_ms, std::size_t ahead) const {
+    const Bucket& bucket = buckets_[BucketOf(region, mmr)];
+    if (bucket.matched == 0.0f) {
+        return -1;
+    }
+    waited_ms = std::max<std::int64_t>(waited_ms, 0);
+    const auto bin = std::min(static_cast<std::size_t>(waited_ms / kWaitBinMs), kWaitBins - 1);
+    std::int64_t by_history = 0;
+    if (bucket.median_from[bin] >= 0) {
+        by_history = std::max<std::int64_t>(0, bucket.median_from[bin] - waited_ms);
+    }
+    std::int64_t by_rate = 0;
+    if (window_ms_ > 0.0) {
+        const double matched_per_ms = static_cast<double>(bucket.matched) / window_ms_;
+        by_rate = static_cast<std::int64_t>(static_cast<double>(ahead + 1) / matched_per_ms);
+    }
+    return std::max(by_history, by_rate);
+}
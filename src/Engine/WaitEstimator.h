@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "RegionTable.h"
+
+// Estimated queue waits per (home region, MMR bracket), learned from players matched
+// recently. Each bucket keeps a decaying histogram of matched players' total waits and
+// a decaying count of them; Refresh() turns the histogram into a table of conditional
+// median waits, so Estimate() is a constant-time lookup. Not thread-safe; the engine
+// owns one per playlist on the tick thread.
+class WaitEstimator {
+public:
+    static constexpr int kBracketWidth = 250;
+    static constexpr std::size_t kBrackets = 16;
+    static constexpr std::int64_t kWaitBinMs = 5000;
+    static constexpr std::size_t kWaitBins = 128;
+    // Home regions outside the region table share the last slot.
+    static constexpr std::size_t kRegionSlots = kMaxRegions + 1;
+    static constexpr std::size_t kBuckets = kRegionSlots * kBrackets;
+
+    WaitEstimator();
+
+    // `region` indexes the engine's region table; anything larger counts as unknown.
+    void RecordMatched(std::size_t region, int mmr, std::int64_t wait_ms);
+    // Ages the samples and rebuilds the lookup tables of buckets that changed.
+    void Refresh(std::int64_t now_ms);
+    // Remaining wait for a player that has waited `waited_ms` with `ahead` players of
+    // the same bucket ahead of it, or -1 before the bucket has seen any match. The
+    // larger of two estimates: the median total wait of recent matches that waited at
+    // least as long, and the time the bucket's recent match rate needs to clear `ahead`.
+    std::int64_t Estimate(std::size_t region, int mmr, std::int64_t waited_ms, std::size_t ahead) const;
+
+    void Reset();
+
+    // Index of the (region, MMR bracket) bucket, in [0, kBuckets).
+    static std::size_t BucketOf(std::size_t region, int mmr);
+
+private:
+    struct Bucket {
+        std::array<float, kWaitBins> waits{};
+        float matched = 0.0f;
+        bool dirty = false;
+        // Median total wait of samples in bin b or later, -1 when there are none.
+        std::array<std::int32_t, kWaitBins> median_from{};
+    };
+
+    static void Rebuild(Bucket& bucket);
+
+    std::vector<Bucket> buckets_;
+    // -1 until the first Refresh.
+    std::int64_t last_decay_ms_ = -1;
+    // Span the decayed match counts cover, as of the last decay and as of the last
+    // Refresh; turns the counts into rates.
+    double decayed_window_ms_ = 0.0;
+    double window_ms_ = 0.0;
+};
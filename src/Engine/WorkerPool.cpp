@@ -0,0 +1,67 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(std::size_t threads) {
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::scoped_lock lock(mtx_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkerPool::Run(std::size_t count, const std::function<void(std::size_t)>& task) {
+    if (workers_.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    {
+        std::scoped_lock lock(mtx_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        busy_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+    Drain();
+
+    std::unique_lock lock(mtx_);
+    done_.wait(lock, [&] { return busy_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerPool::WorkerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mtx_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+        Drain();
+        std::scoped_lock lock(mtx_);
+        if (--busy_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Drain() {
+    for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+         i = next_.fetch_add(1, std::memory_order_relaxed)) {
+        (*task_)(i);
+    }
+}
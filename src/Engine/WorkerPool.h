@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads sharing one batch of tasks at a time. The thread calling Run()
+// takes tasks too, so a pool of one thread runs every batch inline.
+class WorkerPool {
+public:
+    explicit WorkerPool(std::size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    std::size_t Size() const { return workers_.size() + 1; }
+
+    // Runs task(0) .. task(count - 1), each exactly once, and returns
+    // once all of them finished. Not reentrant; call from one thread at a time.
+    void Run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+    void WorkerLoop();
+    void Drain();
+
+    std::vector<std::thread> workers_;
+    std::mutex mtx_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    // The current batch; published under mtx_ with a new generation.
+    const std::function<void(std::size_t)>* task_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::uint64_t generation_ = 0;
+    // Workers that have not finished the current batch.
+    std::size_t busy_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,226 @@
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "Engine/EngineConfig.h"
+#include "Engine/MatchPersistence.h"
+#include "common/ConfigParser.h"
+#include "server.h"
+#include "simulator/LoadGenerator.h"
+#include "simulator/PopulationModel.h"
+
+namespace {
+
+struct BenchOptions {
+    std::string config_path;
+    std::string matches_path = "bench_matches.jsonl";
+    double start_rate = 250.0;
+    double max_rate = 64000.0;
+    int seconds_per_step = 5;
+    int threads = 4;
+    int channels = 4;
+    int match_timeout_ms = 10000;
+    int call_timeout_ms = 5000;
+    double slo_p99_ms = 50.0;
+};
+
+void PrintUsage() {
+    std::cerr << "Usage: match_bench [--config <server_config.json>] [--matches-out <path>]\n"
+              << "                   [--start-rate N] [--max-rate N] [--seconds-per-step N]\n"
+              << "                   [--threads N] [--channels N] [--match-timeout-ms N] [--slo-p99-ms N]\n"
+              << "                   [--call-timeout-ms N]\n";
+}
+
+std::int64_t P99(std::vector<std::int64_t> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<std::size_t>(0.99 * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(idx), values.end());
+    return values[idx];
+}
+
+struct StepResult {
+    double rate = 0.0;
+    LoadReport report;
+    std::size_t persisted_matches = 0;
+    std::uintmax_t persisted_bytes = 0;
+    bool sustained = false;
+};
+
+std::uintmax_t FileSize(const std::string& path) {
+    struct stat st{};
+    return stat(path.c_str(), &st) == 0 ? static_cast<std::uintmax_t>(st.st_size) : 0;
+}
+
+std::size_t CountLines(const std::string& path) {
+    std::ifstream in(path);
+    std::size_t lines = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        ++lines;
+    }
+    return lines;
+}
+
+// One load step against a fresh server so queue leftovers do not carry between rates.
+StepResult RunStep(const BenchOptions& options, const EngineConfig& base_config, double rate) {
+    EngineConfig config = base_config;
+    config.matches_path = options.matches_path;
+    config.arrival_trace_path.clear();
+    std::remove(options.matches_path.c_str());
+
+    MatchmakerServiceImpl service(config, "");
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+
+    std::vector<std::shared_ptr<grpc::Channel>> channels;
+    for (int i = 0; i < std::max(1, options.channels); ++i) {
+        grpc::ChannelArguments args;
+        args.SetInt("matchmaker.bench_channel", i);
+        channels.push_back(server->InProcessChannel(args));
+    }
+
+    LoadOptions load;
+    load.rate = rate;
+    load.total_players = std::max(1, static_cast<int>(rate * options.seconds_per_step));
+    load.threads = options.threads;
+    load.pattern = ArrivalPattern::Poisson;
+    load.match_timeout_ms = options.match_timeout_ms;
+    load.call_timeout_ms = options.call_timeout_ms;
+    load.seed = static_cast<std::uint64_t>(rate);
+
+    auto population = std::make_shared<PopulationModel>(PopulationConfig(), load.seed);
+    const std::string prefix = "bench_" + std::to_string(static_cast<long long>(rate)) + "_";
+    LoadGenerator generator(channels, load, [population, &prefix](int index, double t_seconds) {
+        return population->MakeArrival(index, t_seconds, prefix);
+    });
+
+    StepResult step;
+    step.rate = rate;
+    step.report = generator.Run();
+
+    server->Shutdown();
+    server->Wait();
+
+    step.persisted_matches = CountLines(options.matches_path);
+    step.persisted_bytes = FileSize(options.matches_path);
+    const double achieved = step.report.achieved_qps;
+    step.sustained = step.report.enqueue_failed == 0 && step.report.enqueue_timeouts == 0 &&
+                     achieved >= 0.95 * step.report.offered_rate &&
+                     static_cast<double>(P99(step.report.enqueue_latency_us)) / 1000.0 <= options.slo_p99_ms;
+    return step;
+}
+
+// Raw append throughput of MatchPersistence, independent of the matcher.
+void BenchPersistence(const std::string& path, std::ostream& out) {
+    constexpr int kMatches = 20000;
+    std::remove(path.c_str());
+
+    PopulationModel population(PopulationConfig(), 7);
+    matchmaking::Match match;
+    match.set_match_id("bench_persistence");
+    for (int i = 0; i < 10; ++i) {
+        *match.add_players() = population.MakeArrival(i, 0.0, "p")[0].player;
+    }
+
+    MatchPersistence persistence(path);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kMatches; ++i) {
+        persistence.Append(match);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double mib = static_cast<double>(FileSize(path)) / (1024.0 * 1024.0);
+    std::remove(path.c_str());
+
+    out << "Persistence: " << kMatches << " matches in " << seconds << " s ("
+        << kMatches / seconds << " matches/s, " << mib / seconds << " MiB/s)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--config" && (value = next())) {
+            options.config_path = value;
+        } else if (arg == "--matches-out" && (value = next())) {
+            options.matches_path = value;
+        } else if (arg == "--start-rate" && (value = next())) {
+            options.start_rate = std::stod(value);
+        } else if (arg == "--max-rate" && (value = next())) {
+            options.max_rate = std::stod(value);
+        } else if (arg == "--seconds-per-step" && (value = next())) {
+            options.seconds_per_step = std::stoi(value);
+        } else if (arg == "--threads" && (value = next())) {
+            options.threads = std::stoi(value);
+        } else if (arg == "--channels" && (value = next())) {
+            options.channels = std::stoi(value);
+        } else if (arg == "--match-timeout-ms" && (value = next())) {
+            options.match_timeout_ms = std::stoi(value);
+        } else if (arg == "--call-timeout-ms" && (value = next())) {
+            options.call_timeout_ms = std::stoi(value);
+        } else if (arg == "--slo-p99-ms" && (value = next())) {
+            options.slo_p99_ms = std::stod(value);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    EngineConfig config;
+    if (!options.config_path.empty()) {
+        ConfigError error;
+        if (!EngineConfig::TryLoadFromFile(options.config_path, config, &error)) {
+            std::cerr << options.config_path << ": " << error.ToString() << "\n";
+            return 1;
+        }
+    }
+
+    // Per-match info records would interleave with the report; keep warnings only.
+    config.log_level = "warn";
+    std::ostream& report = std::cout;
+
+    double sustainable = 0.0;
+    for (double rate = options.start_rate; rate <= options.max_rate; rate *= 2.0) {
+        StepResult step = RunStep(options, config, rate);
+        const auto& enqueue = step.report.enqueue_latency_us;
+        const auto& match = step.report.match_latency_ms;
+
+        report << std::fixed << std::setprecision(1)
+             << "rate=" << rate << "/s achieved=" << step.report.achieved_qps << "/s"
+             << " enqueue_p99=" << static_cast<double>(P99(enqueue)) / 1000.0 << "ms"
+             << " match_p99=" << P99(match) << "ms"
+             << " matched=" << step.report.matched << "/" << step.report.enqueued
+             << " timed_out=" << step.report.enqueue_timeouts
+             << " persisted=" << step.persisted_matches << " matches ("
+             << static_cast<double>(step.persisted_bytes) / 1024.0 << " KiB, "
+             << static_cast<double>(step.persisted_matches) / std::max(step.report.elapsed_seconds, 1e-9)
+             << " matches/s)"
+             << (step.sustained ? "" : "  <- over SLO") << std::endl;
+
+        if (!step.sustained) {
+            break;
+        }
+        sustainable = rate;
+    }
+
+    report << "\nSustainable enqueue rate: " << sustainable << "/s (p99 enqueue <= "
+           << options.slo_p99_ms << " ms)\n";
+    BenchPersistence(options.matches_path, report);
+    return 0;
+}
@@ -0,0 +1,520 @@
+#include "common/ConfigParser.h"
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace {
+
+// Config files are a few levels deep at most; this only guards against runaway input.
+constexpr int kMaxDepth = 32;
+
+bool IsIntegral(double value) {
+    return std::isfinite(value) && std::floor(value) == value;
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+}  // namespace
+
+const char* ConfigErrorKindName(ConfigError::Kind kind) {
+    switch (kind) {
+        case ConfigError::Kind::None: return "none";
+        case ConfigError::Kind::Io: return "io";
+        case ConfigError::Kind::Syntax: return "syntax";
+        case ConfigError::Kind::DuplicateKey: return "duplicate_key";
+        case ConfigError::Kind::UnknownKey: return "unknown_key";
+        case ConfigError::Kind::TypeMismatch: return "type_mismatch";
+        case ConfigError::Kind::OutOfRange: return "out_of_range";
+    }
+    return "unknown";
+}
+
+std::string ConfigError::ToString() const {
+    if (line > 0) {
+        return "line " + std::to_string(line) + ": " + message;
+    }
+    return message;
+}
+
+const ConfigValue* ConfigValue::Find(const std::string& key) const {
+    for (const auto& member : members_) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+bool ConfigParser::Parse(const std::string& content, ConfigValue& out, ConfigError* error) {
+    ConfigParser parser(content);
+    parser.error_ = error;
+
+    ConfigValue root;
+    parser.SkipWhitespace();
+    if (parser.pos_ >= content.size() || content[parser.pos_] != '{') {
+        return parser.SyntaxError("config must be a JSON object");
+    }
+    if (!parser.ParseValue(root, 0)) {
+        return false;
+    }
+    parser.SkipWhitespace();
+    if (parser.pos_ != content.size()) {
+        return parser.SyntaxError("unexpected content after the top-level object");
+    }
+
+    out = std::move(root);
+    return true;
+}
+
+bool ConfigParser::ParseSingleValue(const std::string& content, ConfigValue& out, ConfigError* error) {
+    ConfigParser parser(content);
+    parser.error_ = error;
+
+    ConfigValue value;
+    if (!parser.ParseValue(value, 0)) {
+        return false;
+    }
+    parser.SkipWhitespace();
+    if (parser.pos_ != content.size()) {
+        return parser.SyntaxError("unexpected content after the value");
+    }
+
+    out = std::move(value);
+    return true;
+}
+
+bool ConfigParser::ParseFile(const std::string& path, ConfigValue& out, ConfigError* error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return config::Fail(error, ConfigError::Kind::Io, 0, "cannot open " + path);
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return Parse(content, out, error);
+}
+
+void ConfigParser::SkipWhitespace() {
+    while (pos_ < content_.size()) {
+        char c = content_[pos_];
+        if (c == '\n') {
+            ++line_;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            return;
+        }
+        ++pos_;
+    }
+}
+
+bool ConfigParser::SyntaxError(const std::string& message) {
+    return config::Fail(error_, ConfigError::Kind::Syntax, line_, message);
+}
+
+bool ConfigParser::ParseValue(ConfigValue& out, int depth) {
+    if (depth > kMaxDepth) {
+        return SyntaxError("nesting too deep");
+    }
+    SkipWhitespace();
+    if (pos_ >= content_.size()) {
+        return SyntaxError("unexpected end of input");
+    }
+
+    out.line_ = line_;
+    char c = content_[pos_];
+    switch (c) {
+        case '{':
+            return ParseObject(out, depth);
+        case '[':
+            return ParseArray(out, depth);
+        case '"':
+            out.type_ = ConfigValue::Type::String;
+            return ParseString(out.string_);
+        case 't':
+            out.type_ = ConfigValue::Type::Bool;
+            out.bool_ = true;
+            return ParseLiteral("true");
+        case 'f':
+            out.type_ = ConfigValue::Type::Bool;
+            out.bool_ = false;
+            return ParseLiteral("false");
+        case 'n':
+            out.type_ = ConfigValue::Type::Null;
+            return ParseLiteral("null");
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                return ParseNumber(out);
+            }
+            return SyntaxError(std::string("unexpected character '") + c + "'");
+    }
+}
+
+bool ConfigParser::ParseObject(ConfigValue& out, int depth) {
+    out.type_ = ConfigValue::Type::Object;
+    ++pos_;  // '{'
+
+    SkipWhitespace();
+    if (pos_ < content_.size() && content_[pos_] == '}') {
+        ++pos_;
+        return true;
+    }
+
+    for (;;) {
+        SkipWhitespace();
+        if (pos_ >= content_.size() || content_[pos_] != '"') {
+            return SyntaxError("expected a quoted key");
+        }
+        int key_line = line_;
+        std::string key;
+        if (!ParseString(key)) {
+            return false;
+        }
+        if (out.Find(key)) {
+            return config::Fail(error_, ConfigError::Kind::DuplicateKey, key_line,
+                                "duplicate key \"" + key + "\"");
+        }
+
+        SkipWhitespace();
+        if (pos_ >= content_.size() || content_[pos_] != ':') {
+            return SyntaxError("expected ':' after \"" + key + "\"");
+        }
+        ++pos_;
+
+        ConfigValue value;
+        if (!ParseValue(value, depth + 1)) {
+            return false;
+        }
+        out.members_.emplace_back(std::move(key), std::move(value));
+
+        SkipWhitespace();
+        if (pos_ >= content_.size()) {
+            return SyntaxError("unterminated object");
+        }
+        if (content_[pos_] == ',') {
+            ++pos_;
+            continue;
+        }
+        if (content_[pos_] == '}') {
+            ++pos_;
+            return true;
+        }
+        return SyntaxError("expected ',' or '}' in object");
+    }
+}
+
+bool ConfigParser::ParseArray(ConfigValue& out, int depth) {
+    out.type_ = ConfigValue::Type::Array;
+    ++pos_;  // '['
+
+    SkipWhitespace();
+    if (pos_ < content_.size() && content_[pos_] == ']') {
+        ++pos_;
+        return true;
+    }
+
+    for (;;) {
+        ConfigValue value;
+        if (!ParseValue(value, depth + 1)) {
+            return false;
+        }
+        out.elements_.push_back(std::move(value));
+
+        SkipWhitespace();
+        if (pos_ >= content_.size()) {
+            return SyntaxError("unterminated array");
+        }
+        if (content_[pos_] == ',') {
+            ++pos_;
+            continue;
+        }
+        if (content_[pos_] == ']') {
+            ++pos_;
+            return true;
+        }
+        return SyntaxError("expected ',' or ']' in array");
+    }
+}
+
+bool ConfigParser::ParseString(std::string& out) {
+    ++pos_;  // opening quote
+    out.clear();
+    while (pos_ < content_.size()) {
+        char c = content_[pos_++];
+        if (c == '"') {
+            return true;
+        }
+        if (c == '\n') {
+            return SyntaxError("newline inside string");
+        }
+        if (c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+        if (pos_ >= content_.size()) {
+            break;
+        }
+        char esc = content_[pos_++];
+        switch (esc) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                unsigned code = 0;
+                if (pos_ + 4 > content_.size()) {
+                    return SyntaxError("truncated \\u escape");
+                }
+                auto [ptr, ec] = std::from_chars(content_.data() + pos_, content_.data() + pos_ + 4, code, 16);
+                if (ec != std::errc() || ptr != content_.data() + pos_ + 4) {
+                    return SyntaxError("invalid \\u escape");
+                }
+                pos_ += 4;
+                // Config values are paths and addresses; encode the BMP code point as UTF-8.
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return SyntaxError(std::string("invalid escape '\\") + esc + "'");
+        }
+    }
+    return SyntaxError("unterminated string");
+}
+
+bool ConfigParser::ParseNumber(ConfigValue& out) {
+    out.type_ = ConfigValue::Type::Number;
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? only: from_chars on its own would also
+    // take "-inf", "-nan" and the like.
+    const std::size_t size = content_.size();
+    std::size_t p = pos_;
+    auto digits = [&] {
+        const std::size_t first = p;
+        while (p < size && IsDigit(content_[p])) {
+            ++p;
+        }
+        return p > first;
+    };
+    if (p < size && content_[p] == '-') {
+        ++p;
+    }
+    if (p < size && content_[p] == '0') {
+        ++p;
+    } else if (!digits()) {
+        return SyntaxError("invalid number");
+    }
+    if (p < size && content_[p] == '.') {
+        ++p;
+        if (!digits()) {
+            return SyntaxError("invalid number");
+        }
+    }
+    if (p < size && (content_[p] == 'e' || content_[p] == 'E')) {
+        ++p;
+        if (p < size && (content_[p] == '+' || content_[p] == '-')) {
+            ++p;
+        }
+        if (!digits()) {
+            return SyntaxError("invalid number");
+        }
+    }
+    if (p < size && (IsDigit(content_[p]) || content_[p] == '.' || std::isalpha(static_cast<unsigned char>(content_[p])))) {
+        return SyntaxError("invalid number");
+    }
+
+    const char* begin = content_.data() + pos_;
+    const char* end = content_.data() + p;
+    auto [ptr, ec] = std::from_chars(begin, end, out.number_);
+    if (ec == std::errc::result_out_of_range || (ec == std::errc() && !std::isfinite(out.number_))) {
+        return config::Fail(error_, ConfigError::Kind::OutOfRange, line_, "number out of range");
+    }
+    if (ec != std::errc() || ptr != end) {
+        return SyntaxError("invalid number");
+    }
+    pos_ = p;
+    return true;
+}
+
+bool ConfigParser::ParseLiteral(const char* literal) {
+    std::string_view expected(literal);
+    if (content_.compare(pos_, expected.size(), expected) != 0) {
+        return SyntaxError("invalid literal");
+    }
+    pos_ += expected.size();
+    return true;
+}
+
+namespace config {
+
+bool Fail(ConfigError* error, ConfigError::Kind kind, int line, std::string message) {
+    if (error) {
+        error->kind = kind;
+        error->line = line;
+        error->message = std::move(message);
+    }
+    return false;
+}
+
+std::string Quote(std::string_view value) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string quoted = "\"";
+    quoted.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\b': quoted += "\\b"; break;
+            case '\f': quoted += "\\f"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    quoted += "\\u00";
+                    quoted += kHex[(c >> 4) & 0xF];
+                    quoted += kHex[c & 0xF];
+                } else {
+                    quoted += c;
+                }
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+namespace {
+
+template <typename T>
+bool ReadInteger(const ConfigValue& object, const char* key, T& out, ConfigError* error, T min, T max) {
+    const ConfigValue* value = object.Find(key);
+    if (!value) {
+        return true;
+    }
+    if (value->type() != ConfigValue::Type::Number || !IsIntegral(value->AsNumber())) {
+        return Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                    std::string(key) + ": expected an integer");
+    }
+    double number = value->AsNumber();
+    if (number < static_cast<double>(min) || number > static_cast<double>(max)) {
+        return Fail(error, ConfigError::Kind::OutOfRange, value->line(),
+                    std::string(key) + ": " + std::to_string(static_cast<long long>(number)) +
+                        " is outside [" + std::to_string(min) + ", " + std::to_string(max) + "]");
+    }
+    out = static_cast<T>(number);
+    return true;
+}
+
+}  // namespace
+
+bool ReadInt(const ConfigValue& object, const char* key, int& out, ConfigError* error, int min, int max) {
+    return ReadInteger(object, key, out, error, min, max);
+}
+
+bool ReadInt64(const ConfigValue& object, const char* key, std::int64_t& out, ConfigError* error,
+               std::int64_t min, std::int64_t max) {
+    return ReadInteger(object, key, out, error, min, max);
+}
+
+bool ReadDouble(const ConfigValue& object, const char* key, double& out, ConfigError* error, double min, double max) {
+    const ConfigValue* value = object.Find(key);
+    if (!value) {
+        return true;
+    }
+    if (value->type() != ConfigValue::Type::Number || !std::isfinite(value->AsNumber())) {
+        return Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                    std::string(key) + ": expected a number");
+    }
+    double number = value->AsNumber();
+    if (number < min || number > max) {
+        return Fail(error, ConfigError::Kind::OutOfRange, value->line(),
+                    std::string(key) + ": " + std::to_string(number) +
+                        " is outside [" + std::to_string(min) + ", " + std::to_string(max) + "]");
+    }
+    out = number;
+    return true;
+}
+
+bool ReadString(const ConfigValue& object, const char* key, std::string& out, ConfigError* error) {
+    const ConfigValue* value = object.Find(key);
+    if (!value) {
+        return true;
+    }
+    if (value->type() != ConfigValue::Type::String) {
+        return Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                    std::string(key) + ": expected a string");
+    }
+    out = value->AsString();
+    return true;
+}
+
+bool ReadStringArray(const ConfigValue& object, const char* key, std::vector<std::string>& out, ConfigError* error) {
+    const ConfigValue* value = object.Find(key);
+    if (!value) {
+        return true;
+    }
+    if (!value->IsArray()) {
+        return Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                    std::string(key) + ": expected an array of strings");
+    }
+    std::vector<std::string> parsed;
+    parsed.reserve(value->Elements().size());
+    for (const auto& element : value->Elements()) {
+        if (element.type() != ConfigValue::Type::String) {
+            return Fail(error, ConfigError::Kind::TypeMismatch, element.line(),
+                        std::string(key) + ": expected an array of strings");
+        }
+        parsed.push_back(element.AsString());
+    }
+    out = std::move(parsed);
+    return true;
+}
+
+bool ReadBool(const ConfigValue& object, const char* key, bool& out, ConfigError* error) {
+    const ConfigValue* value = object.Find(key);
+    if (!value) {
+        return true;
+    }
+    if (value->type() != ConfigValue::Type::Bool) {
+        return Fail(error, ConfigError::Kind::TypeMismatch, value->line(),
+                    std::string(key) + ": expected true or false");
+    }
+    out = value->AsBool();
+    return true;
+}
+
+bool CheckKnownKeys(const ConfigValue& object,
+                    const std::vector<std::string>& known,
+                    ConfigError* error,
+                    const std::string& section) {
+    for (const auto& [key, value] : object.Members()) {
+        bool found = false;
+        for (const auto& name : known) {
+            if (name == key) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            std::string where = section.empty() ? "" : " in " + section;
+            return Fail(error, ConfigError::Kind::UnknownKey, value.line(),
+                        "unknown key \"" + key + "\"" + where);
+        }
+    }
+    return true;
+}
+
+}  // namespace config
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Single-pass parser for the JSON config files. Produces a small value tree that keeps
+// the source line of every value so schema errors can point at the offending line.
+
+struct ConfigError {
+    enum class Kind {
+        None,
+        Io,
+        Syntax,
+        DuplicateKey,
+        UnknownKey,
+        TypeMismatch,
+        OutOfRange,
+    };
+
+    Kind kind = Kind::None;
+    int line = 0;
+    std::string message;
+
+    // "line 7: max_mmr_window: expected an integer" style text for logs and RPC replies.
+    std::string ToString() const;
+};
+
+const char* ConfigErrorKindName(ConfigError::Kind kind);
+
+class ConfigValue {
+public:
+    enum class Type { Null, Bool, Number, String, Object, Array };
+
+    Type type() const { return type_; }
+    int line() const { return line_; }
+
+    bool IsObject() const { return type_ == Type::Object; }
+    bool IsArray() const { return type_ == Type::Array; }
+
+    bool AsBool() const { return bool_; }
+    double AsNumber() const { return number_; }
+    const std::string& AsString() const { return string_; }
+
+    // Object members in source order; array elements for arrays.
+    const std::vector<std::pair<std::string, ConfigValue>>& Members() const { return members_; }
+    const std::vector<ConfigValue>& Elements() const { return elements_; }
+
+    // Returns nullptr when the key is absent or this value is not an object.
+    const ConfigValue* Find(const std::string& key) const;
+
+private:
+    friend class ConfigParser;
+
+    Type type_ = Type::Null;
+    int line_ = 0;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<std::pair<std::string, ConfigValue>> members_;
+    std::vector<ConfigValue> elements_;
+};
+
+class ConfigParser {
+public:
+    static bool Parse(const std::string& content, ConfigValue& out, ConfigError* error = nullptr);
+    static bool ParseFile(const std::string& path, ConfigValue& out, ConfigError* error = nullptr);
+    // Parses `content` as exactly one JSON value of any type, e.g. "50" or "[1, 2]".
+    static bool ParseSingleValue(const std::string& content, ConfigValue& out, ConfigError* error = nullptr);
+
+private:
+    explicit ConfigParser(const std::string& content) : content_(content) {}
+
+    bool ParseValue(ConfigValue& out, int depth);
+    bool ParseObject(ConfigValue& out, int depth);
+    bool ParseArray(ConfigValue& out, int depth);
+    bool ParseString(std::string& out);
+    bool ParseNumber(ConfigValue& out);
+    bool ParseLiteral(const char* literal);
+    void SkipWhitespace();
+    bool SyntaxError(const std::string& message);
+
+    const std::string& content_;
+    std::size_t pos_ = 0;
+    int line_ = 1;
+    ConfigError* error_ = nullptr;
+};
+
+// Typed field readers. An absent key leaves `out` untouched and succeeds; a present key
+// of the wrong type or outside [min, max] fails with a line-numbered error.
+namespace config {
+
+bool ReadInt(const ConfigValue& object, const char* key, int& out, ConfigError* error,
+             int min = std::numeric_limits<int>::min(),
+             int max = std::numeric_limits<int>::max());
+bool ReadInt64(const ConfigValue& object, const char* key, std::int64_t& out, ConfigError* error,
+               std::int64_t min = -(std::int64_t{1} << 53),
+               std::int64_t max = std::int64_t{1} << 53);
+bool ReadDouble(const ConfigValue& object, const char* key, double& out, ConfigError* error,
+                double min = std::numeric_limits<double>::lowest(),
+                double max = std::numeric_limits<double>::max());
+bool ReadString(const ConfigValue& object, const char* key, std::string& out, ConfigError* error);
+bool ReadStringArray(const ConfigValue& object, const char* key, std::vector<std::string>& out, ConfigError* error);
+bool ReadBool(const ConfigValue& object, const char* key, bool& out, ConfigError* error);
+
+// Fails on the first member of `object` whose key is not in `known`, so typos in a
+// config file are reported instead of silently falling back to a default.
+bool CheckKnownKeys(const ConfigValue& object,
+                    const std::vector<std::string>& known,
+                    ConfigError* error,
+                    const std::string& section = "");
+
+bool Fail(ConfigError* error, ConfigError::Kind kind, int line, std::string message);
+
+// `value` as a JSON string literal, quotes included. Quotes, backslashes and control
+// characters are escaped, so anything written with it parses back to `value`.
+std::string Quote(std::string_view value);
+
+}  // namespace config
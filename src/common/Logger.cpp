@@ -0,0 +1,261 @@
+#include "Logger.h"
+
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+constexpr std::string_view kTruncationMark = "...";
+
+std::int64_t UnixNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "2026-10-18T09:30:00.123Z"
+std::size_t FormatTimestamp(std::int64_t unix_ns, char* out, std::size_t size) {
+    const std::time_t seconds = static_cast<std::time_t>(unix_ns / 1000000000);
+    const int millis = static_cast<int>((unix_ns / 1000000) % 1000);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    std::size_t n = std::strftime(out, size, "%Y-%m-%dT%H:%M:%S", &tm);
+    int extra = std::snprintf(out + n, size - n, ".%03dZ", millis);
+    return n + static_cast<std::size_t>(extra > 0 ? extra : 0);
+}
+
+}  // namespace
+
+const char* LogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warn: return "warn";
+        case LogLevel::Error: return "error";
+        case LogLevel::Off: return "off";
+    }
+    return "unknown";
+}
+
+bool ParseLogLevel(std::string_view name, LogLevel& out) {
+    for (LogLevel level : {LogLevel::Trace, LogLevel::Debug, LogLevel::Info,
+                           LogLevel::Warn, LogLevel::Error, LogLevel::Off}) {
+        if (name == LogLevelName(level)) {
+            out = level;
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger& Logger::Instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : cells_(new Cell[kCapacity]) {
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker_ = std::thread(&Logger::Run, this);
+}
+
+Logger::~Logger() {
+    running_.store(false, std::memory_order_release);
+    published_.fetch_add(1, std::memory_order_release);
+    published_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void Logger::SetSink(std::FILE* sink) {
+    Flush();
+    sink_.store(sink, std::memory_order_release);
+}
+
+bool Logger::ShouldLog(LogLevel level, LogSite& site) {
+    if (level < level_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    const std::uint32_t limit = rate_limit_.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return true;
+    }
+    const std::int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::int64_t window = site.window.load(std::memory_order_relaxed);
+    if (window != second && site.window.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+        site.count.store(0, std::memory_order_relaxed);
+    }
+    if (site.count.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::Push(const LogRecord& record) {
+    std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &cells_[pos % kCapacity];
+        const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            published_.fetch_add(1, std::memory_order_release);
+            published_.notify_one();
+            return;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = record;
+    cell->record.unix_ns = UnixNs();
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    published_.fetch_add(1, std::memory_order_release);
+    published_.notify_one();
+}
+
+bool Logger::Pop(LogRecord& record) {
+    Cell& cell = cells_[dequeue_pos_ % kCapacity];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+        return false;
+    }
+    record = cell.record;
+    cell.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+    ++dequeue_pos_;
+    return true;
+}
+
+void Logger::WriteRecord(const LogRecord& record) {
+    char line[LogRecord::kTextCapacity + 64];
+    std::size_t n = 0;
+    n += static_cast<std::size_t>(std::snprintf(line, sizeof(line), "ts="));
+    n += FormatTimestamp(record.unix_ns, line + n, sizeof(line) - n);
+    n += static_cast<std::size_t>(std::snprintf(line + n, sizeof(line) - n, " level=%s ", LogLevelName(record.level)));
+    std::FILE* sink = sink_.load(std::memory_order_acquire);
+    std::fwrite(line, 1, n, sink);
+    std::fwrite(record.text.data(), 1, record.length, sink);
+    std::fputc('\n', sink);
+}
+
+void Logger::Run() {
+    LogRecord record;
+    for (;;) {
+        // Read before draining: a record published after the drain changes it, so the
+        // wait below cannot miss it.
+        const std::uint32_t published = published_.load(std::memory_order_acquire);
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        std::uint64_t batch = 0;
+        while (Pop(record)) {
+            WriteRecord(record);
+            ++batch;
+        }
+
+        const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != dropped_reported_) {
+            LogRecord notice;
+            Builder builder(notice);
+            builder.Field("event", std::string_view("log_records_dropped"));
+            builder.Field("count", dropped - dropped_reported_);
+            notice.level = LogLevel::Warn;
+            notice.length = builder.Finish();
+            notice.unix_ns = UnixNs();
+            WriteRecord(notice);
+            dropped_reported_ = dropped;
+        }
+
+        if (batch > 0) {
+            std::fflush(sink_.load(std::memory_order_acquire));
+            {
+                std::scoped_lock lock(flush_mtx_);
+                written_.fetch_add(batch, std::memory_order_release);
+            }
+            flushed_.notify_all();
+        }
+        if (stopping) {
+            {
+                std::scoped_lock lock(flush_mtx_);
+                stopped_ = true;
+            }
+            flushed_.notify_all();
+            return;
+        }
+        if (batch == 0) {
+            published_.wait(published, std::memory_order_acquire);
+        }
+    }
+}
+
+void Logger::Flush() {
+    const std::uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+    std::unique_lock lock(flush_mtx_);
+    flushed_.wait(lock, [&] { return stopped_ || written_.load(std::memory_order_acquire) >= target; });
+}
+
+void Logger::Builder::Char(char c) {
+    if (used_ < record_.text.size()) {
+        record_.text[used_++] = c;
+    } else {
+        truncated_ = true;
+    }
+}
+
+void Logger::Builder::Text(std::string_view text) {
+    for (char c : text) {
+        Char(c);
+    }
+}
+
+void Logger::Builder::Key(std::string_view key) {
+    if (used_ > 0) {
+        Char(' ');
+    }
+    Text(key);
+    Char('=');
+}
+
+void Logger::Builder::Quoted(std::string_view text) {
+    bool needs_quotes = text.empty();
+    for (char c : text) {
+        if (c == ' ' || c == '"' || c == '=' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+            needs_quotes = true;
+            break;
+        }
+    }
+    if (!needs_quotes) {
+        Text(text);
+        return;
+    }
+    Char('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            Char('\\');
+            Char(c);
+        } else if (c == '\n') {
+            Text("\\n");
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            Char('?');
+        } else {
+            Char(c);
+        }
+    }
+    Char('"');
+}
+
+std::uint16_t Logger::Builder::Finish() {
+    if (truncated_) {
+        used_ = record_.text.size();
+        for (std::size_t i = 0; i < kTruncationMark.size(); ++i) {
+            record_.text[used_ - kTruncationMark.size() + i] = kTruncationMark[i];
+        }
+    }
+    return static_cast<std::uint16_t>(used_);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Asynchronous structured logger. Call sites format one logfmt line
+// ("level=info event=match_created region=NA players=10") into a fixed-size record
+// and push it onto a lock-free ring; a background thread writes records to the sink.
+// Nothing on the calling thread blocks or flushes. When the ring is full the record is
+// dropped and counted, and each call site is rate limited per second.
+//
+//     MM_LOG(Info, "match_created", "match_id", id, "players", n);
+//
+// Levels below MM_LOG_COMPILED_LEVEL are removed at compile time, arguments included.
+
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5,
+};
+
+#ifndef MM_LOG_COMPILED_LEVEL
+#define MM_LOG_COMPILED_LEVEL 1
+#endif
+
+const char* LogLevelName(LogLevel level);
+bool ParseLogLevel(std::string_view name, LogLevel& out);
+
+// Per-call-site state for rate limiting; one static instance per MM_LOG expansion.
+struct LogSite {
+    std::atomic<std::int64_t> window{-1};
+    std::atomic<std::uint32_t> count{0};
+    std::atomic<std::uint32_t> suppressed{0};
+};
+
+struct LogRecord {
+    static constexpr std::size_t kTextCapacity = 240;
+
+    std::int64_t unix_ns = 0;
+    LogLevel level = LogLevel::Info;
+    std::uint16_t length = 0;
+    std::array<char, kTextCapacity> text;
+};
+
+class Logger {
+public:
+    static Logger& Instance();
+
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void SetLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel Level() const { return level_.load(std::memory_order_relaxed); }
+    // Records per call site per second; 0 disables the limit.
+    void SetRateLimit(std::uint32_t per_site_per_second) {
+        rate_limit_.store(per_site_per_second, std::memory_order_relaxed);
+    }
+    // Records go to stdout unless redirected. The logger does not own `sink`.
+    void SetSink(std::FILE* sink);
+
+    bool ShouldLog(LogLevel level, LogSite& site);
+
+    template <typename... Fields>
+    void Write(LogLevel level, std::string_view event, LogSite& site, const Fields&... fields) {
+        static_assert(sizeof...(Fields) % 2 == 0, "MM_LOG fields are key/value pairs");
+        LogRecord record;
+        Builder builder(record);
+        builder.Field("event", event);
+        builder.Fields(fields...);
+        if (std::uint32_t suppressed = site.suppressed.exchange(0, std::memory_order_relaxed)) {
+            builder.Field("suppressed", suppressed);
+        }
+        record.level = level;
+        record.length = builder.Finish();
+        Push(record);
+    }
+
+    // Blocks until every record pushed before the call has been written, or until the
+    // sink thread has exited.
+    void Flush();
+
+    std::uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    Logger();
+
+    // Appends space-separated key=value pairs; values with spaces, quotes or '=' are quoted.
+    class Builder {
+    public:
+        explicit Builder(LogRecord& record) : record_(record) {}
+
+        void Fields() {}
+
+        template <typename K, typename V, typename... Rest>
+        void Fields(const K& key, const V& value, const Rest&... rest) {
+            static_assert(std::is_convertible_v<const K&, std::string_view>, "MM_LOG keys must be strings");
+            Field(std::string_view(key), value);
+            Fields(rest...);
+        }
+
+        template <typename T>
+        void Field(std::string_view key, const T& value) {
+            Key(key);
+            Value(value);
+        }
+
+        std::uint16_t Finish();
+
+    private:
+        void Key(std::string_view key);
+        void Text(std::string_view text);
+        void Char(char c);
+
+        template <typename T>
+        void Value(const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                Text(value ? "true" : "false");
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                char buffer[32];
+                auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                Text(ec == std::errc() ? std::string_view(buffer, static_cast<std::size_t>(end - buffer)) : "?");
+            } else if constexpr (std::is_enum_v<T>) {
+                Value(static_cast<std::underlying_type_t<T>>(value));
+            } else {
+                Quoted(std::string_view(value));
+            }
+        }
+
+        void Quoted(std::string_view text);
+
+        LogRecord& record_;
+        std::size_t used_ = 0;
+        bool truncated_ = false;
+    };
+
+    struct Cell {
+        std::atomic<std::uint64_t> sequence;
+        LogRecord record;
+    };
+
+    static constexpr std::size_t kCapacity = 4096;
+
+    void Push(const LogRecord& record);
+    bool Pop(LogRecord& record);
+    void Run();
+    void WriteRecord(const LogRecord& record);
+
+    std::atomic<LogLevel> level_{LogLevel::Info};
+    std::atomic<std::uint32_t> rate_limit_{100};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::uint64_t dropped_reported_ = 0;
+
+    // Bounded multi-producer ring (Vyukov); the sink thread is the only consumer.
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<std::uint64_t> enqueue_pos_{0};
+    std::uint64_t dequeue_pos_ = 0;
+    // Bumped after each record is published or dropped and at shutdown; the idle sink
+    // thread waits on it.
+    std::atomic<std::uint32_t> published_{0};
+
+    std::atomic<std::FILE*> sink_{stdout};
+    std::atomic<std::uint64_t> written_{0};
+    std::mutex flush_mtx_;
+    std::condition_variable flushed_;
+    // Set under flush_mtx_ once the sink thread has written its last record.
+    bool stopped_ = false;
+    std::atomic<bool> running_{true};
+    std::thread worker_;
+};
+
+#define MM_LOG(level, event, ...)                                                                   \
+    do {                                                                                            \
+        if constexpr (static_cast<int>(LogLevel::level) >= MM_LOG_COMPILED_LEVEL) {                 \
+            static LogSite mm_log_site_;                                                            \
+            if (Logger::Instance().ShouldLog(LogLevel::level, mm_log_site_)) {                      \
+                Logger::Instance().Write(LogLevel::level, event, mm_log_site_ __VA_OPT__(, ) __VA_ARGS__); \
+            }                                                                                       \
+        }                                                                                           \
+    } while (0)
@@ -1,21 +1,157 @@
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/resource_quota.h>
 #include "server.h"
 #include "Engine/EngineConfig.h"
+#include "Engine/MatchIdGenerator.h"
+#include "common/ConfigParser.h"
+#include "common/Logger.h"
 
 namespace {
 
-int RunServer() {
-    std::string server_address("0.0.0.0:50051");
-    MatchmakerServiceImpl service;
+struct ServerOptions {
+    std::string config_path = "config/server_config.json";
+    std::string listen_address = "0.0.0.0:50051";
+    // MatchmakerAdmin (ReloadConfig) listener; empty disables it.
+    std::string admin_listen_address = "127.0.0.1:50052";
+    // gRPC sync-server sizing; 0 keeps the gRPC default.
+    int completion_queues = 0;
+    int min_pollers = 0;
+    int max_pollers = 0;
+    int max_threads = 0;
+    bool headless = false;
+    // MM_* environment variables first, then --set, so the command line wins.
+    ConfigOverrides overrides;
+};
+
+void PrintUsage() {
+    std::cerr << "Usage: matchmaker_server [--headless] [--config <server_config.json>] [--listen <host:port>]\n"
+              << "                         [--admin-listen <host:port>] [--cqs N] [--min-pollers N]\n"
+              << "                         [--max-pollers N] [--max-threads N] [--set key=value ...]\n"
+              << "Environment: MM_CONFIG, MM_LISTEN, MM_ADMIN_LISTEN, and MM_<KEY> for any server_config.json key.\n";
+}
+
+bool ParseCount(const char* text, int& out) {
+    const char* end = text + std::char_traits<char>::length(text);
+    auto [ptr, ec] = std::from_chars(text, end, out);
+    return ec == std::errc() && ptr == end && out > 0;
+}
+
+// Flags and MM_* variables. Any flag selects headless startup.
+bool ParseOptions(int argc, char** argv, ServerOptions& options) {
+    if (const char* value = std::getenv("MM_CONFIG"); value && *value) {
+        options.config_path = value;
+    }
+    if (const char* value = std::getenv("MM_LISTEN"); value && *value) {
+        options.listen_address = value;
+    }
+    if (const char* value = std::getenv("MM_ADMIN_LISTEN")) {
+        options.admin_listen_address = value;
+    }
+    options.overrides = EngineConfig::EnvironmentOverrides();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        options.headless = true;
+        if (arg == "--headless") {
+            continue;
+        } else if (arg == "--config" && (value = next())) {
+            options.config_path = value;
+        } else if (arg == "--listen" && (value = next())) {
+            options.listen_address = value;
+        } else if (arg == "--admin-listen" && (value = next())) {
+            options.admin_listen_address = value;
+        } else if (arg == "--cqs" && (value = next())) {
+            if (!ParseCount(value, options.completion_queues)) {
+                return false;
+            }
+        } else if (arg == "--min-pollers" && (value = next())) {
+            if (!ParseCount(value, options.min_pollers)) {
+                return false;
+            }
+        } else if (arg == "--max-pollers" && (value = next())) {
+            if (!ParseCount(value, options.max_pollers)) {
+                return false;
+            }
+        } else if (arg == "--max-threads" && (value = next())) {
+            if (!ParseCount(value, options.max_threads)) {
+                return false;
+            }
+        } else if (arg == "--set" && (value = next())) {
+            std::string_view pair(value);
+            const std::size_t eq = pair.find('=');
+            if (eq == std::string_view::npos) {
+                return false;
+            }
+            options.overrides.emplace_back(std::string(pair.substr(0, eq)), std::string(pair.substr(eq + 1)));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int RunServer(const ServerOptions& options, const EngineConfig& file_config) {
+    EngineConfig config = file_config;
+    ConfigError error;
+    if (!EngineConfig::ApplyOverrides(options.overrides, config, &error)) {
+        std::cerr << error.ToString() << std::endl;
+        return 1;
+    }
+    // The host/pid fallback only makes match IDs probably unique; servers name their node.
+    if (config.node_id < 0) {
+        std::cerr << "node_id must be set to a value in [0, " << MatchIdGenerator::kMaxNode
+                  << "] to run the server (config file, MM_NODE_ID or --set node_id=N)" << std::endl;
+        return 1;
+    }
+    MatchmakerServiceImpl service(config, options.config_path, options.overrides);
 
     grpc::ServerBuilder builder;
-    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+    builder.AddListeningPort(options.listen_address, grpc::InsecureServerCredentials());
+    if (options.completion_queues > 0) {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS, options.completion_queues);
+    }
+    if (options.min_pollers > 0) {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, options.min_pollers);
+    }
+    if (options.max_pollers > 0) {
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, options.max_pollers);
+    }
+    if (options.max_threads > 0) {
+        grpc::ResourceQuota quota("matchmaker_server");
+        quota.SetMaxThreads(options.max_threads);
+        builder.SetResourceQuota(quota);
+    }
     builder.RegisterService(&service);
 
     std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
-    std::cout << "Matchmaker server running on " << server_address << std::endl;
+    if (!server) {
+        MM_LOG(Error, "server_start_failed", "address", options.listen_address);
+        Logger::Instance().Flush();
+        return 1;
+    }
+
+    // Operator RPCs get their own server so binding the player port publicly never exposes them.
+    MatchmakerAdminServiceImpl admin_service(service);
+    std::unique_ptr<grpc::Server> admin_server;
+    if (!options.admin_listen_address.empty()) {
+        grpc::ServerBuilder admin_builder;
+        admin_builder.AddListeningPort(options.admin_listen_address, grpc::InsecureServerCredentials());
+        admin_builder.RegisterService(&admin_service);
+        admin_server = admin_builder.BuildAndStart();
+        if (!admin_server) {
+            MM_LOG(Error, "server_start_failed", "address", options.admin_listen_address);
+            Logger::Instance().Flush();
+            return 1;
+        }
+    }
+    MM_LOG(Info, "server_started", "address", options.listen_address, "admin_address",
+           options.admin_listen_address, "config", options.config_path, "overrides", options.overrides.size());
     server->Wait();
 
     return 0;
@@ -113,9 +249,26 @@ void EditEngineConfig(EngineConfig& config) {
 
 }  // namespace
 
-int main() {
-    EngineConfig config = EngineConfig::LoadFromFile("config/server_config.json");
+int main(int argc, char** argv) {
+    ServerOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // A missing file means defaults; a broken one is reported rather than overwritten.
+    EngineConfig config;
+    ConfigError error;
+    if (!EngineConfig::TryLoadFromFile(options.config_path, config, &error) &&
+        error.kind != ConfigError::Kind::Io) {
+        std::cerr << options.config_path << ": " << error.ToString() << std::endl;
+        return 1;
+    }
+    if (options.headless) {
+        return RunServer(options, config);
+    }
 
+    // Menu edits are saved as they are made; starting the server never writes the file.
     for (;;) {
         std::cout << "\nMatchmaker server menu:\n";
         std::cout << "1) Run server\n";
@@ -127,8 +280,7 @@ int main() {
         int choice = 0;
         if (!(std::cin >> choice)) {
             if (std::cin.eof()) {
-                config.SaveToFile("config/server_config.json");
-                return RunServer();
+                return RunServer(options, config);
             }
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -136,14 +288,13 @@ int main() {
         }
 
         if (choice == 1) {
-            config.SaveToFile("config/server_config.json");
-            return RunServer();
+            return RunServer(options, config);
         } else if (choice == 2) {
             EditEngineConfig(config);
-            config.SaveToFile("config/server_config.json");
+            config.SaveToFile(options.config_path);
         } else if (choice == 3) {
             config = EngineConfig();
-            config.SaveToFile("config/server_config.json");
+            config.SaveToFile(options.config_path);
             std::cout << "Options reset to defaults.\n";
         } else if (choice == 4) {
             break;
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/ArrivalTrace.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineClock.h"
+#include "Engine/EngineConfig.h"
+#include "common/Logger.h"
+
+namespace {
+
+struct ReplayOptions {
+    std::string trace_path;
+    std::string config_path = "config/server_config.json";
+    std::string matches_out;
+    std::int64_t drain_ms = 60000;
+};
+
+bool ParseNonNegative(std::string_view text, std::int64_t& out) {
+    std::int64_t parsed = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (ec != std::errc() || end != text.data() + text.size() || parsed < 0) {
+        return false;
+    }
+    out = parsed;
+    return true;
+}
+
+void PrintUsage() {
+    std::cerr << "Usage: match_replay --trace <arrivals.jsonl> [--config <server_config.json>]\n"
+              << "                    [--matches-out <path>] [--drain-ms <ms>]\n";
+}
+
+double Percentile(const std::vector<std::int64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    std::size_t idx = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]) / 1000.0;
+}
+
+struct ReplayStats {
+    std::size_t enqueues = 0;
+    std::size_t cancels = 0;
+    std::size_t matches = 0;
+    std::size_t still_queued = 0;
+    std::vector<std::int64_t> waits_ms;
+    std::int64_t simulated_ms = 0;
+};
+
+// Replays one recording session on a fresh engine: each session started with an empty
+// queue and its own clock.
+void ReplaySession(const EngineConfig& config,
+                   std::vector<ArrivalEvent>::const_iterator begin,
+                   std::vector<ArrivalEvent>::const_iterator end,
+                   std::int64_t drain_ms,
+                   ReplayStats& stats) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    const auto origin = clock->Now();
+    Engine engine(config, clock);
+
+    const std::int64_t tick_ms = std::max(1, config.tick_interval_ms);
+    const std::int64_t end_ms = (begin == end ? 0 : std::prev(end)->t_ms) + drain_ms;
+
+    std::unordered_map<std::string, std::int64_t> enqueued_at;
+    std::vector<matchmaking::Match> formed;
+
+    auto set_time = [&](std::int64_t t_ms) {
+        clock->Set(origin + std::chrono::milliseconds(t_ms));
+    };
+
+    auto step = [&](std::int64_t t_ms) {
+        set_time(t_ms);
+        formed.clear();
+        stats.matches += engine.Step(&formed);
+        for (const auto& match : formed) {
+            for (int i = 0; i < match.players_size(); ++i) {
+                const std::string& id = match.players(i).id();
+                auto it = enqueued_at.find(id);
+                if (it != enqueued_at.end()) {
+                    stats.waits_ms.push_back(t_ms - it->second);
+                    enqueued_at.erase(it);
+                }
+                engine.GetMatchesForPlayer(id);
+            }
+        }
+    };
+
+    std::int64_t next_tick = tick_ms;
+    for (auto it = begin; it != end; ++it) {
+        const ArrivalEvent& event = *it;
+        while (next_tick <= event.t_ms) {
+            step(next_tick);
+            next_tick += tick_ms;
+        }
+        set_time(event.t_ms);
+        if (event.type == ArrivalEvent::Type::Enqueue) {
+            if (engine.AddPlayer(event.player)) {
+                enqueued_at[event.player.id()] = event.t_ms;
+                ++stats.enqueues;
+            }
+        } else if (engine.RemovePlayer(event.player.id())) {
+            enqueued_at.erase(event.player.id());
+            ++stats.cancels;
+        }
+    }
+    while (next_tick <= end_ms) {
+        step(next_tick);
+        next_tick += tick_ms;
+    }
+    stats.still_queued += enqueued_at.size();
+    stats.simulated_ms += end_ms;
+}
+
+int RunReplay(const ReplayOptions& options) {
+    std::vector<ArrivalEvent> events;
+    std::string error;
+    if (!ArrivalTraceReader::Load(options.trace_path, events, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    EngineConfig config = EngineConfig::LoadFromFile(options.config_path);
+    config.matches_path = options.matches_out;
+    config.arrival_trace_path.clear();
+
+    // Per-match info records would dominate replay time and bury the summary.
+    Logger::Instance().SetLevel(LogLevel::Warn);
+
+    const std::clock_t cpu_start = std::clock();
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    ReplayStats stats;
+    std::size_t sessions = 0;
+    for (auto begin = events.begin(); begin != events.end(); ++sessions) {
+        const auto end = std::find_if(begin, events.end(),
+                                      [&](const ArrivalEvent& e) { return e.session != begin->session; });
+        ReplaySession(config, begin, end, options.drain_ms, stats);
+        begin = end;
+    }
+
+    const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    const double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    std::vector<std::int64_t>& waits_ms = stats.waits_ms;
+    std::sort(waits_ms.begin(), waits_ms.end());
+    const double simulated_seconds = static_cast<double>(stats.simulated_ms) / 1000.0;
+
+    std::cout << "\n=== Replay summary ===\n";
+    std::cout << "Events: " << events.size() << " in " << sessions << " session(s)"
+              << " (enqueues=" << stats.enqueues << ", cancels=" << stats.cancels << ")\n";
+    std::cout << "Matches formed: " << stats.matches
+              << ", players matched: " << waits_ms.size()
+              << ", still queued: " << stats.still_queued << "\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << "Wait time (s): p50=" << Percentile(waits_ms, 0.50)
+              << " p90=" << Percentile(waits_ms, 0.90)
+              << " p99=" << Percentile(waits_ms, 0.99)
+              << " max=" << Percentile(waits_ms, 1.0) << "\n";
+    std::cout << "Simulated " << simulated_seconds << " s in " << wall_seconds << " s wall, "
+              << cpu_seconds << " s CPU";
+    if (simulated_seconds > 0.0) {
+        std::cout << " (" << (cpu_seconds * 1000.0) / simulated_seconds << " CPU ms per simulated second)";
+    }
+    std::cout << "\n";
+
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--trace" && (value = next())) {
+            options.trace_path = value;
+        } else if (arg == "--config" && (value = next())) {
+            options.config_path = value;
+        } else if (arg == "--matches-out" && (value = next())) {
+            options.matches_out = value;
+        } else if (arg == "--drain-ms" && (value = next())) {
+            if (!ParseNonNegative(value, options.drain_ms)) {
+                PrintUsage();
+                return 1;
+            }
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (options.trace_path.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    return RunReplay(options);
+}
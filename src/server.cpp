@@ -1,21 +1,235 @@
 #include "server.h"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include <grpcpp/alarm.h>
+
+#include "common/ConfigParser.h"
+#include "common/Logger.h"
+
 using grpc::ServerContext;
-using grpc::ServerWriter;
 using grpc::Status;
 using namespace matchmaking;
 
-MatchmakerServiceImpl::MatchmakerServiceImpl() {
+namespace {
+
+constexpr auto kMatchPollInterval = std::chrono::milliseconds(200);
+constexpr std::uint32_t kDefaultQueuePageSize = 100;
+constexpr std::uint32_t kMaxQueuePageSize = 1000;
+
+// Wraps a match's shared wire encoding in a ByteBuffer without copying it; the slice
+// keeps the match alive until gRPC has sent it.
+grpc::ByteBuffer WireBuffer(const PendingMatchStore::MatchHandle& match) {
+    auto* owner = new PendingMatchStore::MatchHandle(match);
+    grpc::Slice slice(const_cast<char*>((*owner)->wire.data()), (*owner)->wire.size(),
+                      [](void* p) { delete static_cast<PendingMatchStore::MatchHandle*>(p); },
+                      owner);
+    return grpc::ByteBuffer(&slice, 1);
+}
+
+// Polls the engine for a player's matches, writes every pending one and finishes.
+// Each match is acknowledged only once its write succeeds. While none is ready, a
+// QueueStatus is written every status interval the client asked for.
+class MatchStreamReactor final : public grpc::ServerWriteReactor<grpc::ByteBuffer> {
+public:
+    MatchStreamReactor(Engine& engine, const grpc::ByteBuffer* request)
+        : engine_(engine) {
+        grpc::ByteBuffer copy(*request);
+        PlayerID player;
+        if (!grpc::SerializationTraits<PlayerID>::Deserialize(&copy, &player).ok()) {
+            Finish(Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed PlayerID"));
+            return;
+        }
+        player_id_ = player.id();
+        if (player.status_interval_ms() > 0) {
+            status_interval_ = std::max<std::chrono::milliseconds>(
+                kMatchPollInterval, std::chrono::milliseconds(player.status_interval_ms()));
+        }
+        Poll();
+    }
+
+    void OnWriteDone(bool ok) override {
+        if (!ok) {
+            Finish(Status::OK);
+            return;
+        }
+        if (writing_status_) {
+            writing_status_ = false;
+            WaitForPoll();
+            return;
+        }
+        engine_.AcknowledgeMatch(player_id_, matches_[next_]->match.match_id());
+        ++next_;
+        WriteNext();
+    }
+
+    void OnCancel() override {
+        std::scoped_lock lock(mtx_);
+        cancelled_ = true;
+        alarm_.Cancel();
+    }
+
+    void OnDone() override { delete this; }
+
+private:
+    void Poll() {
+        matches_ = engine_.PeekMatchesForPlayer(player_id_);
+        next_ = 0;
+        if (!matches_.empty()) {
+            WriteNext();
+            return;
+        }
+        if (status_interval_.count() > 0 && std::chrono::steady_clock::now() >= next_status_) {
+            next_status_ = std::chrono::steady_clock::now() + status_interval_;
+            Match update;
+            if (engine_.GetQueueStatus(player_id_, *update.mutable_queue_status())) {
+                bool own_buffer = false;
+                buffer_.Clear();
+                grpc::SerializationTraits<Match>::Serialize(update, &buffer_, &own_buffer);
+                writing_status_ = true;
+                StartWrite(&buffer_);
+                return;
+            }
+        }
+        WaitForPoll();
+    }
+
+    void WaitForPoll() {
+        std::scoped_lock lock(mtx_);
+        if (cancelled_) {
+            Finish(Status::OK);
+            return;
+        }
+        alarm_.Set(std::chrono::system_clock::now() + kMatchPollInterval, [this](bool fired) {
+            if (fired) {
+                Poll();
+            } else {
+                Finish(Status::OK);
+            }
+        });
+    }
+
+    void WriteNext() {
+        if (next_ == matches_.size()) {
+            Finish(Status::OK);
+            return;
+        }
+        buffer_ = WireBuffer(matches_[next_]);
+        StartWrite(&buffer_);
+    }
+
+    Engine& engine_;
+    std::string player_id_;
+    std::vector<PendingMatchStore::MatchHandle> matches_;
+    std::size_t next_ = 0;
+    grpc::ByteBuffer buffer_;
+    grpc::Alarm alarm_;
+    std::mutex mtx_;
+    bool cancelled_ = false;
+    // Zero when the client asked for no status updates.
+    std::chrono::milliseconds status_interval_{0};
+    std::chrono::steady_clock::time_point next_status_;
+    bool writing_status_ = false;
+};
+
+// "ipv4:10.0.0.7:53412" -> "ipv4:10.0.0.7", so rate limits apply per client host rather
+// than per connection.
+std::string_view ClientAddress(std::string_view peer) {
+    const auto colon = peer.rfind(':');
+    const auto scheme = peer.find(':');
+    return colon != std::string_view::npos && colon != scheme ? peer.substr(0, colon) : peer;
+}
+
+// Keys an inline reload may not set: they name files the server opens for append.
+constexpr const char* kFilePathKeys[] = {"matches_path", "arrival_trace_path"};
+
+void ApplyLogLevel(const EngineConfig& config) {
+    LogLevel level;
+    if (ParseLogLevel(config.log_level, level)) {
+        Logger::Instance().SetLevel(level);
+    }
+}
+
+}  // namespace
+
+MatchmakerServiceImpl::MatchmakerServiceImpl(const EngineConfig& config, std::string config_path, ConfigOverrides overrides)
+    : config_path_(std::move(config_path)),
+      overrides_(std::move(overrides)),
+      applied_(config),
+      engine_(config, std::make_shared<SteadyEngineClock>()),
+      config_watcher_(config_path_, [this] { ReloadFromFile(); }) {
+    ApplyLogLevel(config);
     engine_.Start();
+    if (!config_path_.empty()) {
+        config_watcher_.Start();
+    }
 }
 
 MatchmakerServiceImpl::~MatchmakerServiceImpl() {
+    config_watcher_.Stop();
     engine_.Stop();
 }
 
-Status MatchmakerServiceImpl::Enqueue(ServerContext*, const Player* request, EnqueueResponse* response) {
-    engine_.AddPlayer(*request);
-    response->set_success(true);
+// Reads `json`, or the watched file when it is empty, and layers the startup overrides on top.
+// Inline JSON keeps the file paths of `applied_`; the caller holds reload_mtx_.
+bool MatchmakerServiceImpl::LoadReloadedConfig(const std::string& json, EngineConfig& config, std::string& error) const {
+    ConfigError parse_error;
+    bool ok;
+    if (json.empty()) {
+        ok = EngineConfig::TryLoadFromFile(config_path_, config, &parse_error);
+    } else {
+        ConfigValue root;
+        ok = ConfigParser::Parse(json, root, &parse_error);
+        for (const char* key : kFilePathKeys) {
+            if (ok && root.Find(key)) {
+                error = std::string(key) + " can only be changed in the config file";
+                return false;
+            }
+        }
+        ok = ok && EngineConfig::Parse(json, config, &parse_error);
+        config.matches_path = applied_.matches_path;
+        config.arrival_trace_path = applied_.arrival_trace_path;
+    }
+    ok = ok && EngineConfig::ApplyOverrides(overrides_, config, &parse_error);
+    if (!ok) {
+        error = parse_error.ToString();
+    }
+    return ok;
+}
+
+bool MatchmakerServiceImpl::Reload(const std::string& json, std::string& error) {
+    std::lock_guard lock(reload_mtx_);
+    EngineConfig config;
+    if (!LoadReloadedConfig(json, config, error) || !engine_.ReloadConfig(config, &error)) {
+        return false;
+    }
+    applied_ = config;
+    ApplyLogLevel(config);
+    return true;
+}
+
+void MatchmakerServiceImpl::ReloadFromFile() {
+    std::string error;
+    if (!Reload("", error)) {
+        MM_LOG(Warn, "config_reload_rejected", "path", config_path_, "error", error);
+        return;
+    }
+    MM_LOG(Info, "config_reloaded", "path", config_path_, "version", engine_.ConfigVersion());
+}
+
+Status MatchmakerServiceImpl::Enqueue(ServerContext* context, const Player* request, EnqueueResponse* response) {
+    const std::string peer = context->peer();
+    const AdmissionDecision admission = engine_.Admit(ClientAddress(peer), *request);
+    if (!admission.Admitted()) {
+        const std::string retry_after = std::to_string(admission.retry_after_ms);
+        context->AddTrailingMetadata("retry-after-ms", retry_after);
+        return Status(grpc::StatusCode::RESOURCE_EXHAUSTED, std::string("enqueue rejected (") +
+                                                                 AdmissionReasonName(admission.reason) +
+                                                                 "), retry after " + retry_after + " ms");
+    }
+    response->set_success(engine_.AddPlayer(*request));
     return Status::OK;
 }
 
@@ -24,27 +238,16 @@ Status MatchmakerServiceImpl::Cancel(ServerContext*, const PlayerID* request, Ca
     return Status::OK;
 }
 
-Status MatchmakerServiceImpl::StreamMatches(ServerContext* context, const PlayerID* request, ServerWriter<Match>* writer) {
-    const std::string player_id = request->id();
-
-    while (!context->IsCancelled()) {
-        auto matches = engine_.GetMatchesForPlayer(player_id);
-        for (auto& m : matches) {
-            writer->Write(m);
-        }
-        if (!matches.empty()) {
-            return Status::OK;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    }
-    return Status::OK;
+grpc::ServerWriteReactor<grpc::ByteBuffer>* MatchmakerServiceImpl::StreamMatches(grpc::CallbackServerContext*,
+                                                                                 const grpc::ByteBuffer* request) {
+    // A failed write leaves the match pending for a reconnect until its TTL.
+    return new MatchStreamReactor(engine_, request);
 }
 
 Status MatchmakerServiceImpl::GetMetrics(ServerContext*, const matchmaking::MetricsRequest*, matchmaking::MetricsResponse* response) {
     EngineMetrics snapshot = engine_.GetMetricsSnapshot();
 
-    const std::string regions[] = {"NA", "EU", "ASIA"};
-    for (const auto& region : regions) {
+    for (const auto& region : snapshot.regions) {
         matchmaking::RegionMetrics* rm = response->add_regions();
         rm->set_region(region);
 
@@ -66,11 +269,60 @@ Status MatchmakerServiceImpl::GetMetrics(ServerContext*, const matchmaking::Metr
     response->set_last_match_average_mmr(snapshot.last_match_average_mmr);
     response->set_last_match_mmr_spread(snapshot.last_match_mmr_spread);
     response->set_last_match_average_wait_seconds(snapshot.last_match_average_wait_seconds);
+    response->set_pending_matches(snapshot.pending.matches);
+    response->set_pending_deliveries(snapshot.pending.deliveries);
+    response->set_pending_bytes(snapshot.pending.bytes);
+    response->set_expired_matches(snapshot.pending.expired);
+    response->set_evicted_matches(snapshot.pending.evicted_for_memory);
+    response->set_snapshot_version(snapshot.version);
+    for (const auto& queue : snapshot.queues) {
+        matchmaking::QueueMetrics* qm = response->add_queues();
+        qm->set_queue_id(queue.id);
+        qm->set_team_size(queue.team_size);
+        qm->set_queue_size(queue.queue_size);
+        qm->set_matches(queue.matches);
+        qm->set_budget_exhausted_ticks(queue.budget_exhausted);
+    }
+    matchmaking::AdmissionMetrics* admission = response->mutable_admission();
+    admission->set_enqueues_per_second(snapshot.admission.enqueues_per_second);
+    admission->set_tick_lag_ms(engine_.TickLagMs());
+    admission->set_rejected_tick_lag(snapshot.admission.rejected_tick_lag);
+    admission->set_rejected_region_queue(snapshot.admission.rejected_region_queue);
+    admission->set_rejected_ingest_rate(snapshot.admission.rejected_ingest_rate);
+    admission->set_rejected_client_rate(snapshot.admission.rejected_client_rate);
 
     return Status::OK;
 }
 
-Status MatchmakerServiceImpl::GetQueue(ServerContext*, const matchmaking::MetricsRequest*, matchmaking::QueueSnapshot* response) {
-    engine_.FillQueueSnapshot(*response);
+Status MatchmakerServiceImpl::GetQueue(ServerContext*, const QueueRequest* request, QueueSnapshot* response) {
+    QueueQuery query;
+    query.region = request->region();
+    query.queue_id = request->queue_id();
+    if (request->has_min_mmr()) {
+        query.min_mmr = request->min_mmr();
+    }
+    if (request->has_max_mmr()) {
+        query.max_mmr = request->max_mmr();
+    }
+    query.page_size = request->page_size() == 0 ? kDefaultQueuePageSize
+                                                : std::min(request->page_size(), kMaxQueuePageSize);
+    query.page_token = request->page_token();
+    engine_.FillQueueSnapshot(*response, query);
+    return Status::OK;
+}
+
+Status MatchmakerAdminServiceImpl::ReloadConfig(ServerContext* context, const ReloadConfigRequest* request,
+                                                ReloadConfigResponse* response) {
+    std::string error;
+    const bool ok = matchmaker_.Reload(request->config_json(), error);
+    if (ok) {
+        MM_LOG(Info, "config_reloaded", "peer", context->peer(), "version", matchmaker_.ConfigVersion());
+    } else {
+        MM_LOG(Warn, "config_reload_rejected", "peer", context->peer(), "error", error);
+    }
+
+    response->set_success(ok);
+    response->set_error(error);
+    response->set_config_version(matchmaker_.ConfigVersion());
     return Status::OK;
 }
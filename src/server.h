@@ -1,11 +1,18 @@
 #pragma once
+#include <mutex>
 #include <grpcpp/grpcpp.h>
 #include "matchmaker.grpc.pb.h"
+#include "Engine/ConfigWatcher.h"
 #include "Engine/Engine.h"
 
-class MatchmakerServiceImpl final : public matchmaking::Matchmaker::Service {
+// StreamMatches is served through the raw callback API so every recipient of a match is
+// sent the same pre-serialized bytes.
+class MatchmakerServiceImpl final
+    : public matchmaking::Matchmaker::WithRawCallbackMethod_StreamMatches<matchmaking::Matchmaker::Service> {
 public:
-    MatchmakerServiceImpl();
+    // Runs the engine with `config`. Hot reload watches `config_path`; pass an empty path
+    // to disable it (benchmarks, tests). `overrides` are reapplied on top of every reload.
+    MatchmakerServiceImpl(const EngineConfig& config, std::string config_path, ConfigOverrides overrides = {});
     ~MatchmakerServiceImpl() override;
 
     grpc::Status Enqueue(grpc::ServerContext*,
@@ -16,18 +23,45 @@ public:
                         const matchmaking::PlayerID* request,
                         matchmaking::CancelResponse* response) override;
 
-    grpc::Status StreamMatches(grpc::ServerContext*,
-                               const matchmaking::PlayerID* request,
-                               grpc::ServerWriter<matchmaking::Match>* writer) override;
+    grpc::ServerWriteReactor<grpc::ByteBuffer>* StreamMatches(grpc::CallbackServerContext*,
+                                                              const grpc::ByteBuffer* request) override;
 
     grpc::Status GetMetrics(grpc::ServerContext*,
                             const matchmaking::MetricsRequest* request,
                             matchmaking::MetricsResponse* response) override;
 
     grpc::Status GetQueue(grpc::ServerContext*,
-                          const matchmaking::MetricsRequest* request,
+                          const matchmaking::QueueRequest* request,
                           matchmaking::QueueSnapshot* response) override;
 
+    // Applies `json`, or re-reads the config file when it is empty. Inline configs may not
+    // set file paths; the paths in effect are kept.
+    bool Reload(const std::string& json, std::string& error);
+    std::uint64_t ConfigVersion() const { return engine_.ConfigVersion(); }
+
 private:
+    void ReloadFromFile();
+    bool LoadReloadedConfig(const std::string& json, EngineConfig& config, std::string& error) const;
+
+    std::string config_path_;
+    ConfigOverrides overrides_;
+    // Serializes reloads from the watcher and the admin service; `applied_` is the last
+    // config the engine accepted.
+    std::mutex reload_mtx_;
+    EngineConfig applied_;
     Engine engine_;
+    ConfigWatcher config_watcher_;
+};
+
+// Operator RPCs, registered on their own listener so player-facing clients cannot reach them.
+class MatchmakerAdminServiceImpl final : public matchmaking::MatchmakerAdmin::Service {
+public:
+    explicit MatchmakerAdminServiceImpl(MatchmakerServiceImpl& matchmaker) : matchmaker_(matchmaker) {}
+
+    grpc::Status ReloadConfig(grpc::ServerContext*,
+                              const matchmaking::ReloadConfigRequest* request,
+                              matchmaking::ReloadConfigResponse* response) override;
+
+private:
+    MatchmakerServiceImpl& matchmaker_;
 };
@@ -0,0 +1,416 @@
+#include "simulator/LoadGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include <grpcpp/alarm.h>
+
+#include "matchmaker.grpc.pb.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PlayerSession;
+
+struct Tag {
+    enum class Op { EnqueueDone, StreamStarted, StreamRead, StreamFinished, PatienceExpired, CancelDone };
+    PlayerSession* session;
+    Op op;
+};
+
+// Everything one simulated player needs in flight. Lives until both the Enqueue call and
+// the StreamMatches stream have completed.
+struct PlayerSession {
+    Clock::time_point scheduled;
+    std::string player_id;
+    int pending_ops = 0;
+    bool matched = false;
+    bool cancelled = false;
+
+    grpc::ClientContext enqueue_context;
+    matchmaking::EnqueueResponse enqueue_response;
+    grpc::Status enqueue_status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<matchmaking::EnqueueResponse>> enqueue_call;
+
+    grpc::ClientContext stream_context;
+    matchmaking::Match match;
+    grpc::Status stream_status;
+    std::unique_ptr<grpc::ClientAsyncReader<matchmaking::Match>> stream;
+
+    grpc::Alarm patience;
+    grpc::ClientContext cancel_context;
+    matchmaking::CancelResponse cancel_response;
+    grpc::Status cancel_status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<matchmaking::CancelResponse>> cancel_call;
+    matchmaking::Matchmaker::Stub* cancel_stub = nullptr;
+
+    Tag enqueue_done{this, Tag::Op::EnqueueDone};
+    Tag stream_started{this, Tag::Op::StreamStarted};
+    Tag stream_read{this, Tag::Op::StreamRead};
+    Tag stream_finished{this, Tag::Op::StreamFinished};
+    Tag patience_expired{this, Tag::Op::PatienceExpired};
+    Tag cancel_done{this, Tag::Op::CancelDone};
+};
+
+struct ScheduledPlayer {
+    std::int64_t offset_us;
+    SimulatedArrival arrival;
+};
+
+struct WorkerResult {
+    std::size_t enqueued = 0;
+    std::size_t enqueue_failed = 0;
+    std::size_t enqueue_timeouts = 0;
+    std::size_t matched = 0;
+    std::size_t unmatched = 0;
+    std::size_t cancelled = 0;
+    std::size_t cancel_timeouts = 0;
+    std::vector<std::int64_t> enqueue_latency_us;
+    std::vector<std::int64_t> match_latency_ms;
+};
+
+// gRPC deadlines only accept system_clock time points.
+std::chrono::system_clock::time_point ToSystemDeadline(Clock::time_point deadline) {
+    return std::chrono::system_clock::now() +
+           std::chrono::duration_cast<std::chrono::system_clock::duration>(deadline - Clock::now());
+}
+
+std::chrono::system_clock::time_point CallDeadline(int timeout_ms) {
+    return std::chrono::system_clock::now() + std::chrono::milliseconds(timeout_ms);
+}
+
+std::int64_t Percentile(std::vector<std::int64_t>& values, double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(idx), values.end());
+    return values[idx];
+}
+
+void PrintPercentiles(std::ostream& out, const char* label, const char* unit, std::vector<std::int64_t> values) {
+    out << label << ": n=" << values.size();
+    if (!values.empty()) {
+        out << " p50=" << Percentile(values, 0.50) << unit
+            << " p90=" << Percentile(values, 0.90) << unit
+            << " p99=" << Percentile(values, 0.99) << unit
+            << " max=" << *std::max_element(values.begin(), values.end()) << unit;
+    }
+    out << "\n";
+}
+
+}  // namespace
+
+bool ParseArrivalPattern(const std::string& name, ArrivalPattern& out) {
+    if (name == "constant") {
+        out = ArrivalPattern::Constant;
+    } else if (name == "poisson") {
+        out = ArrivalPattern::Poisson;
+    } else if (name == "ramp") {
+        out = ArrivalPattern::Ramp;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* ArrivalPatternName(ArrivalPattern pattern) {
+    switch (pattern) {
+        case ArrivalPattern::Constant: return "constant";
+        case ArrivalPattern::Poisson: return "poisson";
+        case ArrivalPattern::Ramp: return "ramp";
+    }
+    return "unknown";
+}
+
+void LoadReport::Print(std::ostream& out) const {
+    out << "\n=== Load report ===\n";
+    out << "enqueued=" << enqueued << " failed=" << enqueue_failed << " timed_out=" << enqueue_timeouts
+        << " matched=" << matched << " unmatched=" << unmatched
+        << " cancelled=" << cancelled << " cancel_timed_out=" << cancel_timeouts << "\n";
+    out << "offered_rate=" << offered_rate << "/s achieved_qps=" << achieved_qps
+        << "/s elapsed_s=" << elapsed_seconds << "\n";
+    PrintPercentiles(out, "enqueue_latency", "us", enqueue_latency_us);
+    PrintPercentiles(out, "match_latency", "ms", match_latency_ms);
+}
+
+std::vector<std::int64_t> BuildArrivalSchedule(const LoadOptions& options) {
+    std::vector<std::int64_t> offsets;
+    if (options.total_players <= 0 || options.rate <= 0.0) {
+        return offsets;
+    }
+    offsets.reserve(static_cast<std::size_t>(options.total_players));
+
+    std::mt19937_64 rng(options.seed);
+    std::exponential_distribution<double> gap(options.rate);
+
+    const double n = options.total_players;
+    const double r0 = std::max(options.ramp_start_rate, 1e-3);
+    const double r1 = options.rate;
+    // A linear ramp r(t) = r0 + (r1 - r0) t / D delivers n arrivals when D = 2n / (r0 + r1).
+    const double ramp_duration = 2.0 * n / (r0 + r1);
+
+    double t = 0.0;
+    for (int i = 0; i < options.total_players; ++i) {
+        switch (options.pattern) {
+            case ArrivalPattern::Constant:
+                t = i / r1;
+                break;
+            case ArrivalPattern::Poisson:
+                t += gap(rng);
+                break;
+            case ArrivalPattern::Ramp: {
+                // Invert the cumulative arrivals r0 t + (r1 - r0) t^2 / 2D = i.
+                double a = (r1 - r0) / (2.0 * ramp_duration);
+                t = std::abs(a) < 1e-12 ? i / r0 : (-r0 + std::sqrt(r0 * r0 + 4.0 * a * i)) / (2.0 * a);
+                break;
+            }
+        }
+        offsets.push_back(static_cast<std::int64_t>(t * 1e6));
+    }
+
+    if (options.intensity) {
+        // Map operational time u to wall time t with integral_0^t intensity = u, stepping
+        // the integral in small increments. A floor keeps quiet hours from stalling the run.
+        constexpr double kStep = 0.01;
+        constexpr double kMinIntensity = 0.02;
+        double wall = 0.0;
+        double integral = 0.0;
+        for (auto& offset : offsets) {
+            const double target = static_cast<double>(offset) / 1e6;
+            while (integral < target) {
+                integral += std::max(kMinIntensity, options.intensity(wall)) * kStep;
+                wall += kStep;
+            }
+            offset = static_cast<std::int64_t>(wall * 1e6);
+        }
+    }
+    return offsets;
+}
+
+LoadGenerator::LoadGenerator(std::vector<std::shared_ptr<grpc::Channel>> channels,
+                             LoadOptions options,
+                             ArrivalFactory make_arrival)
+    : channels_(std::move(channels)),
+      options_(std::move(options)),
+      make_arrival_(std::move(make_arrival)) {}
+
+std::vector<std::shared_ptr<grpc::Channel>> LoadGenerator::CreateChannels(const std::string& target, int count) {
+    std::vector<std::shared_ptr<grpc::Channel>> channels;
+    for (int i = 0; i < std::max(1, count); ++i) {
+        grpc::ChannelArguments args;
+        // Distinct args keep channels from sharing one subchannel and hence one TCP connection.
+        args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        args.SetInt("matchmaker.load_channel", i);
+        channels.push_back(grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), args));
+    }
+    return channels;
+}
+
+LoadReport LoadGenerator::Run() {
+    const std::vector<std::int64_t> arrivals = BuildArrivalSchedule(options_);
+    const int thread_count = std::max(1, options_.threads);
+
+    // Built up front so the factory need not be thread-safe and its cost stays out of the run.
+    std::vector<ScheduledPlayer> schedule;
+    schedule.reserve(arrivals.size());
+    for (std::size_t i = 0; i < arrivals.size(); ++i) {
+        for (auto& arrival : make_arrival_(static_cast<int>(i), static_cast<double>(arrivals[i]) / 1e6)) {
+            schedule.push_back({arrivals[i], std::move(arrival)});
+        }
+    }
+
+    std::vector<std::unique_ptr<matchmaking::Matchmaker::Stub>> stubs;
+    for (const auto& channel : channels_) {
+        stubs.push_back(matchmaking::Matchmaker::NewStub(channel));
+    }
+
+    std::vector<WorkerResult> results(static_cast<std::size_t>(thread_count));
+    std::atomic<std::int64_t> last_issue_us{0};
+    const Clock::time_point start = Clock::now() + std::chrono::milliseconds(50);
+
+    auto worker = [&](int worker_index) {
+        WorkerResult& result = results[static_cast<std::size_t>(worker_index)];
+        grpc::CompletionQueue cq;
+        int in_flight = 0;
+        std::size_t next = static_cast<std::size_t>(worker_index);
+
+        auto start_player = [&](std::size_t index) {
+            auto* session = new PlayerSession();
+            const ScheduledPlayer& scheduled = schedule[index];
+            session->scheduled = start + std::chrono::microseconds(scheduled.offset_us);
+            auto& stub = stubs[index % stubs.size()];
+            const matchmaking::Player& player = scheduled.arrival.player;
+
+            matchmaking::PlayerID id;
+            id.set_id(player.id());
+            session->player_id = player.id();
+            session->stream_context.set_deadline(
+                ToSystemDeadline(session->scheduled + std::chrono::milliseconds(options_.match_timeout_ms)));
+            session->stream = stub->AsyncStreamMatches(&session->stream_context, id, &cq, &session->stream_started);
+
+            session->enqueue_context.set_deadline(CallDeadline(options_.call_timeout_ms));
+            session->enqueue_call = stub->AsyncEnqueue(&session->enqueue_context, player, &cq);
+            session->enqueue_call->Finish(&session->enqueue_response, &session->enqueue_status, &session->enqueue_done);
+
+            session->pending_ops = 2;
+            if (scheduled.arrival.cancel_after_ms > 0) {
+                session->patience.Set(&cq,
+                                      ToSystemDeadline(session->scheduled + std::chrono::milliseconds(scheduled.arrival.cancel_after_ms)),
+                                      &session->patience_expired);
+                session->cancel_stub = stub.get();
+                ++session->pending_ops;
+            }
+            ++in_flight;
+        };
+
+        auto finish_op = [&](PlayerSession* session) {
+            if (--session->pending_ops == 0) {
+                if (!session->matched && !session->cancelled) {
+                    ++result.unmatched;
+                }
+                delete session;
+                --in_flight;
+            }
+        };
+
+        for (;;) {
+            Clock::time_point wake = Clock::now() + std::chrono::milliseconds(100);
+            if (next < schedule.size()) {
+                wake = std::min(wake, start + std::chrono::microseconds(schedule[next].offset_us));
+            } else if (in_flight == 0) {
+                break;
+            }
+
+            void* raw_tag = nullptr;
+            bool ok = false;
+            auto status = cq.AsyncNext(&raw_tag, &ok, ToSystemDeadline(wake));
+            if (status == grpc::CompletionQueue::SHUTDOWN) {
+                break;
+            }
+
+            if (status == grpc::CompletionQueue::GOT_EVENT) {
+                auto* tag = static_cast<Tag*>(raw_tag);
+                PlayerSession* session = tag->session;
+                const auto now = Clock::now();
+                switch (tag->op) {
+                    case Tag::Op::EnqueueDone:
+                        if (ok && session->enqueue_status.ok() && session->enqueue_response.success()) {
+                            ++result.enqueued;
+                            result.enqueue_latency_us.push_back(
+                                std::chrono::duration_cast<std::chrono::microseconds>(now - session->scheduled).count());
+                        } else {
+                            if (session->enqueue_status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+                                ++result.enqueue_timeouts;
+                            } else {
+                                ++result.enqueue_failed;
+                            }
+                            session->stream_context.TryCancel();
+                        }
+                        finish_op(session);
+                        break;
+                    case Tag::Op::StreamStarted:
+                        if (ok) {
+                            session->stream->Read(&session->match, &session->stream_read);
+                        } else {
+                            session->stream->Finish(&session->stream_status, &session->stream_finished);
+                        }
+                        break;
+                    case Tag::Op::StreamRead:
+                        if (ok) {
+                            if (!session->matched) {
+                                session->matched = true;
+                                ++result.matched;
+                                result.match_latency_ms.push_back(
+                                    std::chrono::duration_cast<std::chrono::milliseconds>(now - session->scheduled).count());
+                            }
+                            session->stream->Read(&session->match, &session->stream_read);
+                        } else {
+                            session->stream->Finish(&session->stream_status, &session->stream_finished);
+                        }
+                        break;
+                    case Tag::Op::StreamFinished:
+                        if (session->cancel_stub) {
+                            // Matched or timed out first; the pending alarm then fires with ok=false.
+                            session->patience.Cancel();
+                        }
+                        finish_op(session);
+                        break;
+                    case Tag::Op::PatienceExpired:
+                        if (ok && !session->matched) {
+                            matchmaking::PlayerID id;
+                            id.set_id(session->player_id);
+                            session->cancel_context.set_deadline(CallDeadline(options_.call_timeout_ms));
+                            session->cancel_call = session->cancel_stub->AsyncCancel(&session->cancel_context, id, &cq);
+                            session->cancel_call->Finish(&session->cancel_response, &session->cancel_status, &session->cancel_done);
+                        } else {
+                            finish_op(session);
+                        }
+                        break;
+                    case Tag::Op::CancelDone:
+                        if (session->cancel_status.ok() && session->cancel_response.success()) {
+                            ++result.cancelled;
+                            session->cancelled = true;
+                            session->stream_context.TryCancel();
+                        } else if (session->cancel_status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+                            ++result.cancel_timeouts;
+                        }
+                        finish_op(session);
+                        break;
+                }
+            }
+
+            while (next < schedule.size() && Clock::now() >= start + std::chrono::microseconds(schedule[next].offset_us)) {
+                start_player(next);
+                std::int64_t issued = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+                std::int64_t prev = last_issue_us.load();
+                while (issued > prev && !last_issue_us.compare_exchange_weak(prev, issued)) {
+                }
+                next += static_cast<std::size_t>(thread_count);
+            }
+        }
+
+        cq.Shutdown();
+        void* ignored_tag = nullptr;
+        bool ignored_ok = false;
+        while (cq.Next(&ignored_tag, &ignored_ok)) {
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    LoadReport report;
+    for (auto& r : results) {
+        report.enqueued += r.enqueued;
+        report.enqueue_failed += r.enqueue_failed;
+        report.enqueue_timeouts += r.enqueue_timeouts;
+        report.matched += r.matched;
+        report.unmatched += r.unmatched;
+        report.cancelled += r.cancelled;
+        report.cancel_timeouts += r.cancel_timeouts;
+        report.enqueue_latency_us.insert(report.enqueue_latency_us.end(), r.enqueue_latency_us.begin(), r.enqueue_latency_us.end());
+        report.match_latency_ms.insert(report.match_latency_ms.end(), r.match_latency_ms.begin(), r.match_latency_ms.end());
+    }
+
+    report.elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const double issue_seconds = static_cast<double>(last_issue_us.load()) / 1e6;
+    if (!schedule.empty() && schedule.back().offset_us > 0) {
+        report.offered_rate = static_cast<double>(schedule.size()) / (static_cast<double>(schedule.back().offset_us) / 1e6);
+    }
+    if (issue_seconds > 0.0) {
+        report.achieved_qps = static_cast<double>(report.enqueued) / issue_seconds;
+    }
+    return report;
+}
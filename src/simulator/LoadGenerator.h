@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include "matchmaker.pb.h"
+#include "simulator/PopulationModel.h"
+
+enum class ArrivalPattern {
+    Constant,
+    Poisson,
+    Ramp,
+};
+
+bool ParseArrivalPattern(const std::string& name, ArrivalPattern& out);
+const char* ArrivalPatternName(ArrivalPattern pattern);
+
+struct LoadOptions {
+    // Number of arrivals; an arrival is one player or one party.
+    int total_players = 1000;
+    int threads = 4;
+    // Open-loop target in enqueues per second. With Ramp the rate climbs linearly from
+    // ramp_start_rate to rate over the run.
+    double rate = 500.0;
+    double ramp_start_rate = 50.0;
+    ArrivalPattern pattern = ArrivalPattern::Poisson;
+    // Streams still waiting for a match after this long are closed and counted as unmatched.
+    int match_timeout_ms = 120000;
+    // Deadline of each Enqueue and Cancel call, from when it is issued.
+    int call_timeout_ms = 5000;
+    std::uint64_t seed = 1;
+    // Optional relative arrival intensity over time (e.g. a diurnal curve). The schedule
+    // is time-warped so that arrivals bunch where the intensity is high.
+    std::function<double(double t_seconds)> intensity;
+};
+
+struct LoadReport {
+    std::size_t enqueued = 0;
+    // Rejected or failed Enqueue calls, not counting those that hit call_timeout_ms.
+    std::size_t enqueue_failed = 0;
+    std::size_t enqueue_timeouts = 0;
+    std::size_t matched = 0;
+    std::size_t unmatched = 0;
+    // Players that gave up and whose Cancel removed them from the queue.
+    std::size_t cancelled = 0;
+    std::size_t cancel_timeouts = 0;
+    double offered_rate = 0.0;
+    double achieved_qps = 0.0;
+    double elapsed_seconds = 0.0;
+    // Both measured from each player's scheduled arrival time, so a client that falls
+    // behind the schedule shows up as latency rather than as a lower offered rate.
+    std::vector<std::int64_t> enqueue_latency_us;
+    std::vector<std::int64_t> match_latency_ms;
+
+    void Print(std::ostream& out) const;
+};
+
+// Offsets in microseconds from the start of the run at which each player arrives.
+std::vector<std::int64_t> BuildArrivalSchedule(const LoadOptions& options);
+
+// Drives a matchmaker with open-loop arrivals: each worker thread owns a completion queue
+// and issues async Enqueue plus StreamMatches for its share of the schedule, spreading
+// players over the supplied channels. Players with a cancel_after_ms send Cancel if still
+// unmatched by then.
+class LoadGenerator {
+public:
+    // Returns the players of arrival `index`, scheduled at t_seconds into the run.
+    using ArrivalFactory = std::function<std::vector<SimulatedArrival>(int index, double t_seconds)>;
+
+    LoadGenerator(std::vector<std::shared_ptr<grpc::Channel>> channels,
+                  LoadOptions options,
+                  ArrivalFactory make_arrival);
+
+    LoadReport Run();
+
+    static std::vector<std::shared_ptr<grpc::Channel>> CreateChannels(const std::string& target, int count);
+
+private:
+    std::vector<std::shared_ptr<grpc::Channel>> channels_;
+    LoadOptions options_;
+    ArrivalFactory make_arrival_;
+};
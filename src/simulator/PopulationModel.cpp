@@ -0,0 +1,298 @@
+#include "simulator/PopulationModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <ostream>
+
+#include "common/ConfigParser.h"
+
+const std::array<const char*, PopulationConfig::kRegionCount> PopulationConfig::kRegions = {"NA", "EU", "ASIA"};
+
+namespace {
+
+bool ReadRegionTable(const ConfigValue& section,
+                     const char* key,
+                     std::array<double, PopulationConfig::kRegionCount>& out,
+                     ConfigError* error,
+                     double min,
+                     double max) {
+    const ConfigValue* table = section.Find(key);
+    if (!table) {
+        return true;
+    }
+    if (!table->IsObject()) {
+        return config::Fail(error, ConfigError::Kind::TypeMismatch, table->line(),
+                            std::string(key) + ": expected an object keyed by region");
+    }
+    std::vector<std::string> regions(PopulationConfig::kRegions.begin(), PopulationConfig::kRegions.end());
+    if (!config::CheckKnownKeys(*table, regions, error, key)) {
+        return false;
+    }
+    for (std::size_t r = 0; r < PopulationConfig::kRegionCount; ++r) {
+        if (!config::ReadDouble(*table, PopulationConfig::kRegions[r], out[r], error, min, max)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteRegionTable(std::ostream& out,
+                      const std::array<double, PopulationConfig::kRegionCount>& table) {
+    out << "{";
+    for (std::size_t r = 0; r < PopulationConfig::kRegionCount; ++r) {
+        out << (r == 0 ? " " : ", ") << "\"" << PopulationConfig::kRegions[r] << "\": " << table[r];
+    }
+    out << " }";
+}
+
+}  // namespace
+
+bool ParseMmrModel(const std::string& name, MmrModel& out) {
+    if (name == "uniform") {
+        out = MmrModel::Uniform;
+    } else if (name == "normal") {
+        out = MmrModel::Normal;
+    } else if (name == "bimodal") {
+        out = MmrModel::Bimodal;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* MmrModelName(MmrModel model) {
+    switch (model) {
+        case MmrModel::Uniform: return "uniform";
+        case MmrModel::Normal: return "normal";
+        case MmrModel::Bimodal: return "bimodal";
+    }
+    return "unknown";
+}
+
+bool ReadPopulationConfig(const ConfigValue& section, PopulationConfig& out, ConfigError* error) {
+    if (!section.IsObject()) {
+        return config::Fail(error, ConfigError::Kind::TypeMismatch, section.line(), "population: expected an object");
+    }
+
+    const std::vector<std::string> keys = {
+        "mmr_model", "mmr_min", "mmr_max", "mmr_mean", "mmr_stddev", "mmr_second_mean", "mmr_second_weight",
+        "tail_fraction", "tail_alpha", "tail_start_mmr", "tail_max_mmr",
+        "region_weights", "region_utc_offset_hours",
+        "diurnal_amplitude", "diurnal_peak_hour", "day_length_seconds",
+        "party_size_weights", "cancel_fraction", "mean_patience_seconds",
+    };
+
+    PopulationConfig parsed = out;
+    std::string model_name = MmrModelName(parsed.mmr_model);
+    bool ok = config::CheckKnownKeys(section, keys, error, "population") &&
+              config::ReadString(section, "mmr_model", model_name, error) &&
+              config::ReadInt(section, "mmr_min", parsed.mmr_min, error, 0) &&
+              config::ReadInt(section, "mmr_max", parsed.mmr_max, error, 0) &&
+              config::ReadDouble(section, "mmr_mean", parsed.mmr_mean, error, 0.0) &&
+              config::ReadDouble(section, "mmr_stddev", parsed.mmr_stddev, error, 0.0) &&
+              config::ReadDouble(section, "mmr_second_mean", parsed.mmr_second_mean, error, 0.0) &&
+              config::ReadDouble(section, "mmr_second_weight", parsed.mmr_second_weight, error, 0.0, 1.0) &&
+              config::ReadDouble(section, "tail_fraction", parsed.tail_fraction, error, 0.0, 1.0) &&
+              config::ReadDouble(section, "tail_alpha", parsed.tail_alpha, error, 0.1) &&
+              config::ReadInt(section, "tail_start_mmr", parsed.tail_start_mmr, error, 1) &&
+              config::ReadInt(section, "tail_max_mmr", parsed.tail_max_mmr, error, 1) &&
+              ReadRegionTable(section, "region_weights", parsed.region_weights, error, 0.0, 1e9) &&
+              ReadRegionTable(section, "region_utc_offset_hours", parsed.region_utc_offset_hours, error, -24.0, 24.0) &&
+              config::ReadDouble(section, "diurnal_amplitude", parsed.diurnal_amplitude, error, 0.0, 1.0) &&
+              config::ReadDouble(section, "diurnal_peak_hour", parsed.diurnal_peak_hour, error, 0.0, 24.0) &&
+              config::ReadDouble(section, "day_length_seconds", parsed.day_length_seconds, error, 1.0) &&
+              config::ReadDouble(section, "cancel_fraction", parsed.cancel_fraction, error, 0.0, 1.0) &&
+              config::ReadDouble(section, "mean_patience_seconds", parsed.mean_patience_seconds, error, 0.001);
+    if (!ok) {
+        return false;
+    }
+
+    if (!ParseMmrModel(model_name, parsed.mmr_model)) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, section.Find("mmr_model")->line(),
+                            "mmr_model must be uniform, normal or bimodal");
+    }
+    if (parsed.mmr_max < parsed.mmr_min || parsed.tail_max_mmr < parsed.tail_start_mmr) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, section.line(),
+                            "population: mmr_max must be >= mmr_min and tail_max_mmr >= tail_start_mmr");
+    }
+
+    double total_weight = 0.0;
+    for (double w : parsed.region_weights) {
+        total_weight += w;
+    }
+    if (total_weight <= 0.0) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, section.Find("region_weights")->line(),
+                            "region_weights: at least one region needs a positive weight");
+    }
+
+    if (const ConfigValue* parties = section.Find("party_size_weights")) {
+        if (!parties->IsArray() || parties->Elements().empty()) {
+            return config::Fail(error, ConfigError::Kind::TypeMismatch, parties->line(),
+                                "party_size_weights: expected a non-empty array of weights");
+        }
+        parsed.party_size_weights.clear();
+        for (const auto& element : parties->Elements()) {
+            if (element.type() != ConfigValue::Type::Number || element.AsNumber() < 0.0) {
+                return config::Fail(error, ConfigError::Kind::TypeMismatch, element.line(),
+                                    "party_size_weights: weights must be non-negative numbers");
+            }
+            parsed.party_size_weights.push_back(element.AsNumber());
+        }
+    }
+
+    out = parsed;
+    return true;
+}
+
+void WritePopulationConfig(std::ostream& out, const PopulationConfig& config, const std::string& indent) {
+    const std::string in = indent + "  ";
+    out << "{\n";
+    out << in << "\"mmr_model\": \"" << MmrModelName(config.mmr_model) << "\",\n";
+    out << in << "\"mmr_min\": " << config.mmr_min << ",\n";
+    out << in << "\"mmr_max\": " << config.mmr_max << ",\n";
+    out << in << "\"mmr_mean\": " << config.mmr_mean << ",\n";
+    out << in << "\"mmr_stddev\": " << config.mmr_stddev << ",\n";
+    out << in << "\"mmr_second_mean\": " << config.mmr_second_mean << ",\n";
+    out << in << "\"mmr_second_weight\": " << config.mmr_second_weight << ",\n";
+    out << in << "\"tail_fraction\": " << config.tail_fraction << ",\n";
+    out << in << "\"tail_alpha\": " << config.tail_alpha << ",\n";
+    out << in << "\"tail_start_mmr\": " << config.tail_start_mmr << ",\n";
+    out << in << "\"tail_max_mmr\": " << config.tail_max_mmr << ",\n";
+    out << in << "\"region_weights\": ";
+    WriteRegionTable(out, config.region_weights);
+    out << ",\n";
+    out << in << "\"region_utc_offset_hours\": ";
+    WriteRegionTable(out, config.region_utc_offset_hours);
+    out << ",\n";
+    out << in << "\"diurnal_amplitude\": " << config.diurnal_amplitude << ",\n";
+    out << in << "\"diurnal_peak_hour\": " << config.diurnal_peak_hour << ",\n";
+    out << in << "\"day_length_seconds\": " << config.day_length_seconds << ",\n";
+    out << in << "\"party_size_weights\": [";
+    for (std::size_t i = 0; i < config.party_size_weights.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << config.party_size_weights[i];
+    }
+    out << "],\n";
+    out << in << "\"cancel_fraction\": " << config.cancel_fraction << ",\n";
+    out << in << "\"mean_patience_seconds\": " << config.mean_patience_seconds << "\n";
+    out << indent << "}";
+}
+
+PopulationModel::PopulationModel(PopulationConfig config, std::uint64_t seed)
+    : config_(std::move(config)),
+      rng_(seed) {}
+
+double PopulationModel::RegionIntensity(std::size_t region, double t_seconds) const {
+    double weight = config_.region_weights[region];
+    if (config_.diurnal_amplitude <= 0.0) {
+        return weight;
+    }
+    double utc_hour = std::fmod(t_seconds / config_.day_length_seconds * 24.0, 24.0);
+    double local_hour = utc_hour + config_.region_utc_offset_hours[region];
+    double phase = 2.0 * std::numbers::pi * (local_hour - config_.diurnal_peak_hour) / 24.0;
+    return weight * std::max(0.0, 1.0 + config_.diurnal_amplitude * std::cos(phase));
+}
+
+double PopulationModel::Intensity(double t_seconds) const {
+    double total = 0.0;
+    double weights = 0.0;
+    for (std::size_t r = 0; r < PopulationConfig::kRegionCount; ++r) {
+        total += RegionIntensity(r, t_seconds);
+        weights += config_.region_weights[r];
+    }
+    return weights > 0.0 ? total / weights : 1.0;
+}
+
+int PopulationModel::DrawMmr() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    if (config_.tail_fraction > 0.0 && unit(rng_) < config_.tail_fraction) {
+        // Pareto: scarce high-MMR players whose density falls off as mmr^-(alpha + 1).
+        double u = std::max(unit(rng_), 1e-12);
+        double mmr = config_.tail_start_mmr * std::pow(u, -1.0 / config_.tail_alpha);
+        return static_cast<int>(std::min<double>(mmr, config_.tail_max_mmr));
+    }
+
+    double mmr = 0.0;
+    switch (config_.mmr_model) {
+        case MmrModel::Uniform:
+            return std::uniform_int_distribution<int>(config_.mmr_min, config_.mmr_max)(rng_);
+        case MmrModel::Normal:
+            mmr = std::normal_distribution<double>(config_.mmr_mean, config_.mmr_stddev)(rng_);
+            break;
+        case MmrModel::Bimodal: {
+            double mean = unit(rng_) < config_.mmr_second_weight ? config_.mmr_second_mean : config_.mmr_mean;
+            mmr = std::normal_distribution<double>(mean, config_.mmr_stddev)(rng_);
+            break;
+        }
+    }
+    return static_cast<int>(std::clamp<double>(mmr, config_.mmr_min, config_.mmr_max));
+}
+
+std::size_t PopulationModel::DrawRegion(double t_seconds) {
+    std::array<double, PopulationConfig::kRegionCount> weights{};
+    for (std::size_t r = 0; r < PopulationConfig::kRegionCount; ++r) {
+        weights[r] = RegionIntensity(r, t_seconds);
+    }
+    if (weights[0] + weights[1] + weights[2] <= 0.0) {
+        weights = config_.region_weights;
+    }
+    return std::discrete_distribution<std::size_t>(weights.begin(), weights.end())(rng_);
+}
+
+int PopulationModel::DrawPartySize() {
+    if (config_.party_size_weights.size() <= 1) {
+        return 1;
+    }
+    const auto& w = config_.party_size_weights;
+    return 1 + static_cast<int>(std::discrete_distribution<std::size_t>(w.begin(), w.end())(rng_));
+}
+
+std::vector<SimulatedArrival> PopulationModel::MakeArrival(int index, double t_seconds, const std::string& id_prefix) {
+    std::uniform_int_distribution<int> base_ping_dist(20, 60);
+    std::uniform_int_distribution<int> extra_ping_dist(60, 140);
+    std::normal_distribution<double> party_spread(0.0, 75.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const std::size_t home = DrawRegion(t_seconds);
+    const int leader_mmr = DrawMmr();
+    const int party_size = DrawPartySize();
+
+    int cancel_after_ms = 0;
+    if (config_.cancel_fraction > 0.0 && unit(rng_) < config_.cancel_fraction) {
+        double patience = std::exponential_distribution<double>(1.0 / config_.mean_patience_seconds)(rng_);
+        cancel_after_ms = std::max(1, static_cast<int>(patience * 1000.0));
+    }
+
+    std::vector<SimulatedArrival> arrivals;
+    arrivals.reserve(static_cast<std::size_t>(party_size));
+    for (int member = 0; member < party_size; ++member) {
+        SimulatedArrival arrival;
+        matchmaking::Player& player = arrival.player;
+
+        std::string id = id_prefix + std::to_string(index);
+        if (member > 0) {
+            id += "_" + std::to_string(member);
+        }
+        player.set_id(id);
+
+        int mmr = leader_mmr;
+        if (member > 0) {
+            mmr = static_cast<int>(std::max(0.0, leader_mmr + party_spread(rng_)));
+        }
+        player.set_mmr(mmr);
+
+        int base_ping = base_ping_dist(rng_);
+        for (std::size_t r = 0; r < PopulationConfig::kRegionCount; ++r) {
+            auto* dc = player.add_pings();
+            dc->set_datacenter(PopulationConfig::kRegions[r]);
+            dc->set_ping_ms(base_ping + (r == home ? 0 : extra_ping_dist(rng_)));
+        }
+        player.set_ping(base_ping);
+        player.set_region(PopulationConfig::kRegions[home]);
+
+        arrival.cancel_after_ms = cancel_after_ms;
+        arrivals.push_back(std::move(arrival));
+    }
+    return arrivals;
+}
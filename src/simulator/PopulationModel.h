@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "matchmaker.pb.h"
+
+class ConfigValue;
+struct ConfigError;
+
+enum class MmrModel {
+    Uniform,
+    Normal,
+    Bimodal,
+};
+
+// The "population" section of sim_config.json. Defaults reproduce the original
+// simulator: uniform MMR in [800, 2400], equal region mix, flat load, solo players that
+// never cancel.
+struct PopulationConfig {
+    static constexpr std::size_t kRegionCount = 3;
+    static const std::array<const char*, kRegionCount> kRegions;
+
+    MmrModel mmr_model = MmrModel::Uniform;
+    int mmr_min = 800;
+    int mmr_max = 2400;
+    double mmr_mean = 1500.0;
+    double mmr_stddev = 250.0;
+    // Bimodal: a second normal peak drawn with this probability.
+    double mmr_second_mean = 2000.0;
+    double mmr_second_weight = 0.3;
+
+    // Pareto tail above tail_start_mmr (capped at tail_max_mmr) for this fraction of players.
+    double tail_fraction = 0.0;
+    double tail_alpha = 2.5;
+    int tail_start_mmr = 2200;
+    int tail_max_mmr = 3500;
+
+    std::array<double, kRegionCount> region_weights = {1.0, 1.0, 1.0};
+    std::array<double, kRegionCount> region_utc_offset_hours = {-5.0, 1.0, 8.0};
+    // 0 disables the diurnal curve; 1 swings each region between no load and twice its mean.
+    double diurnal_amplitude = 0.0;
+    double diurnal_peak_hour = 20.0;
+    // Simulated seconds per day, so a full day can be compressed into a short run.
+    double day_length_seconds = 86400.0;
+
+    // Relative weights of party sizes 1, 2, 3, ...
+    std::vector<double> party_size_weights = {1.0};
+
+    // Fraction of players that give up if not matched within an exponential patience.
+    double cancel_fraction = 0.0;
+    double mean_patience_seconds = 60.0;
+};
+
+bool ParseMmrModel(const std::string& name, MmrModel& out);
+const char* MmrModelName(MmrModel model);
+
+bool ReadPopulationConfig(const ConfigValue& section, PopulationConfig& out, ConfigError* error);
+void WritePopulationConfig(std::ostream& out, const PopulationConfig& config, const std::string& indent);
+
+// One player of an arrival group; parties arrive together and share a home region.
+struct SimulatedArrival {
+    matchmaking::Player player;
+    // 0 means the player never cancels.
+    int cancel_after_ms = 0;
+};
+
+// Generates players from a PopulationConfig. Not thread-safe; callers draw from one thread.
+class PopulationModel {
+public:
+    PopulationModel(PopulationConfig config, std::uint64_t seed);
+
+    // Arrival intensity at simulated time t relative to the daily mean (1.0 when flat).
+    double Intensity(double t_seconds) const;
+
+    // Players arriving together as arrival `index` at simulated time t. Ids are
+    // id_prefix + index, with "_<n>" appended for party members after the first.
+    std::vector<SimulatedArrival> MakeArrival(int index, double t_seconds, const std::string& id_prefix);
+
+private:
+    double RegionIntensity(std::size_t region, double t_seconds) const;
+    int DrawMmr();
+    std::size_t DrawRegion(double t_seconds);
+    int DrawPartySize();
+
+    PopulationConfig config_;
+    std::mt19937_64 rng_;
+};
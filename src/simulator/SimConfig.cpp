@@ -2,93 +2,78 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <string>
+#include <vector>
 
-namespace {
-
-bool ExtractInt(const std::string& content, const std::string& key, int& out) {
-    std::size_t key_pos = content.find("\"" + key + "\"");
-    if (key_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t colon_pos = content.find(':', key_pos);
-    if (colon_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t start = colon_pos + 1;
-    while (start < content.size() && (content[start] == ' ' || content[start] == '\t' || content[start] == '\n' || content[start] == '\r')) {
-        ++start;
-    }
-    std::size_t end = start;
-    while (end < content.size() && (content[end] == '-' || (content[end] >= '0' && content[end] <= '9'))) {
-        ++end;
-    }
-    if (start == end) {
-        return false;
-    }
-    try {
-        out = std::stoi(content.substr(start, end - start));
-    } catch (...) {
-        return false;
-    }
-    return true;
-}
-
-bool ExtractString(const std::string& content, const std::string& key, std::string& out) {
-    std::size_t key_pos = content.find("\"" + key + "\"");
-    if (key_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t colon_pos = content.find(':', key_pos);
-    if (colon_pos == std::string::npos) {
-        return false;
-    }
-    std::size_t start = content.find('"', colon_pos + 1);
-    if (start == std::string::npos) {
-        return false;
-    }
-    ++start;
-    std::size_t end = content.find('"', start);
-    if (end == std::string::npos) {
-        return false;
-    }
-    out = content.substr(start, end - start);
-    return true;
-}
-
-}  // namespace
+#include "common/ConfigParser.h"
+#include "simulator/LoadGenerator.h"
 
 SimConfig SimConfig::LoadFromFile(const std::string& path) {
     SimConfig config;
+    ConfigError error;
+    if (!TryLoadFromFile(path, config, &error) && error.kind != ConfigError::Kind::Io) {
+        std::cerr << path << ": " << error.ToString() << "; using defaults" << std::endl;
+    }
 
-    std::ifstream in(path);
-    if (!in.is_open()) {
-        return config;
+    const char* env_target = std::getenv("SIM_TARGET_ADDRESS");
+    if (env_target && *env_target) {
+        config.target_address = env_target;
     }
 
-    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return config;
+}
 
-    int total_value = config.total_players;
-    if (ExtractInt(content, "total_players", total_value)) {
-        config.total_players = total_value;
+bool SimConfig::TryLoadFromFile(const std::string& path, SimConfig& out, ConfigError* error) {
+    ConfigValue root;
+    if (!ConfigParser::ParseFile(path, root, error)) {
+        return false;
     }
 
-    int delay_value = config.delay_ms_between_players;
-    if (ExtractInt(content, "delay_ms_between_players", delay_value)) {
-        config.delay_ms_between_players = delay_value;
+    SimConfig parsed;
+    const std::vector<std::string> keys = {
+        "target_address",
+        "total_players",
+        "delay_ms_between_players",
+        "load_threads",
+        "load_channels",
+        "load_rate_per_second",
+        "load_ramp_start_rate",
+        "load_arrival",
+        "match_timeout_ms",
+        "load_call_timeout_ms",
+        "population",
+    };
+    bool ok = config::CheckKnownKeys(root, keys, error) &&
+              config::ReadString(root, "target_address", parsed.target_address, error) &&
+              config::ReadInt(root, "total_players", parsed.total_players, error, 0) &&
+              config::ReadInt(root, "delay_ms_between_players", parsed.delay_ms_between_players, error, 0) &&
+              config::ReadInt(root, "load_threads", parsed.load_threads, error, 1, 1024) &&
+              config::ReadInt(root, "load_channels", parsed.load_channels, error, 1, 1024) &&
+              config::ReadInt(root, "load_rate_per_second", parsed.load_rate_per_second, error, 1) &&
+              config::ReadInt(root, "load_ramp_start_rate", parsed.load_ramp_start_rate, error, 1) &&
+              config::ReadString(root, "load_arrival", parsed.load_arrival, error) &&
+              config::ReadInt(root, "match_timeout_ms", parsed.match_timeout_ms, error, 1) &&
+              config::ReadInt(root, "load_call_timeout_ms", parsed.load_call_timeout_ms, error, 1);
+    if (!ok) {
+        return false;
     }
-
-    std::string address_value = config.target_address;
-    if (ExtractString(content, "target_address", address_value)) {
-        config.target_address = address_value;
+    if (const ConfigValue* population = root.Find("population")) {
+        if (!ReadPopulationConfig(*population, parsed.population, error)) {
+            return false;
+        }
     }
-
-    const char* env_target = std::getenv("SIM_TARGET_ADDRESS");
-    if (env_target && *env_target) {
-        config.target_address = env_target;
+    ArrivalPattern pattern;
+    if (!ParseArrivalPattern(parsed.load_arrival, pattern)) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, root.Find("load_arrival")->line(),
+                            "load_arrival must be constant, poisson or ramp");
     }
-
-    return config;
+    if (parsed.target_address.empty()) {
+        return config::Fail(error, ConfigError::Kind::OutOfRange, root.Find("target_address")->line(),
+                            "target_address must not be empty");
+    }
+    out = parsed;
+    return true;
 }
 
 bool SimConfig::SaveToFile(const std::string& path) const {
@@ -98,9 +83,19 @@ bool SimConfig::SaveToFile(const std::string& path) const {
     }
 
     out << "{\n";
-    out << "  \"target_address\": \"" << target_address << "\",\n";
+    out << "  \"target_address\": " << config::Quote(target_address) << ",\n";
     out << "  \"total_players\": " << total_players << ",\n";
-    out << "  \"delay_ms_between_players\": " << delay_ms_between_players << "\n";
+    out << "  \"delay_ms_between_players\": " << delay_ms_between_players << ",\n";
+    out << "  \"load_threads\": " << load_threads << ",\n";
+    out << "  \"load_channels\": " << load_channels << ",\n";
+    out << "  \"load_rate_per_second\": " << load_rate_per_second << ",\n";
+    out << "  \"load_ramp_start_rate\": " << load_ramp_start_rate << ",\n";
+    out << "  \"load_arrival\": " << config::Quote(load_arrival) << ",\n";
+    out << "  \"match_timeout_ms\": " << match_timeout_ms << ",\n";
+    out << "  \"load_call_timeout_ms\": " << load_call_timeout_ms << ",\n";
+    out << "  \"population\": ";
+    WritePopulationConfig(out, population, "  ");
+    out << "\n";
     out << "}\n";
 
     return true;
@@ -2,12 +2,29 @@
 
 #include <string>
 
+#include "simulator/PopulationModel.h"
+
+struct ConfigError;
+
 struct SimConfig {
     int total_players = 100;
     int delay_ms_between_players = 10;
     std::string target_address = "localhost:50051";
 
+    // Load mode (match_simulator --load): open-loop async arrivals over a channel pool.
+    int load_threads = 4;
+    int load_channels = 4;
+    int load_rate_per_second = 500;
+    int load_ramp_start_rate = 50;
+    std::string load_arrival = "poisson";
+    int match_timeout_ms = 120000;
+    int load_call_timeout_ms = 5000;
+
+    PopulationConfig population;
+
+    // Falls back to defaults when the file is missing or invalid (the latter is logged).
     static SimConfig LoadFromFile(const std::string& path);
+    static bool TryLoadFromFile(const std::string& path, SimConfig& out, ConfigError* error = nullptr);
     bool SaveToFile(const std::string& path) const;
 };
 
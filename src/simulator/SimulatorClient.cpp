@@ -76,33 +76,46 @@ bool SimulatorClient::PrintMetrics() {
               << ", mmr_spread=" << response.last_match_mmr_spread()
               << ", avg_wait_s=" << response.last_match_average_wait_seconds()
               << "\n";
+    std::cout << "Undelivered: matches=" << response.pending_matches()
+              << ", deliveries=" << response.pending_deliveries()
+              << ", bytes=" << response.pending_bytes()
+              << ", expired=" << response.expired_matches()
+              << ", evicted=" << response.evicted_matches()
+              << "\n";
 
     return true;
 }
 
 bool SimulatorClient::PrintQueue() {
-    matchmaking::MetricsRequest request;
-    matchmaking::QueueSnapshot response;
-    grpc::ClientContext context;
-
-    grpc::Status status = stub_->GetQueue(&context, request, &response);
-    if (!status.ok()) {
-        std::cerr << "GetQueue RPC failed: " << status.error_message() << "\n";
-        return false;
-    }
+    matchmaking::QueueRequest request;
+    request.set_page_size(1000);
 
     std::cout << "\n=== Queue snapshot ===\n";
-    for (int i = 0; i < response.players_size(); ++i) {
-        const auto& qp = response.players(i);
-        std::cout << "Player " << qp.id()
-                  << " region=" << qp.region()
-                  << " mmr=" << qp.mmr()
-                  << " ping_na=" << qp.ping_na()
-                  << " ping_eu=" << qp.ping_eu()
-                  << " ping_asia=" << qp.ping_asia()
-                  << " waited_s=" << qp.waited_seconds()
-                  << "\n";
-    }
+    do {
+        matchmaking::QueueSnapshot response;
+        grpc::ClientContext context;
+
+        grpc::Status status = stub_->GetQueue(&context, request, &response);
+        if (!status.ok()) {
+            std::cerr << "GetQueue RPC failed: " << status.error_message() << "\n";
+            return false;
+        }
+
+        for (int i = 0; i < response.players_size(); ++i) {
+            const auto& qp = response.players(i);
+            std::cout << "Player " << qp.id()
+                      << " region=" << qp.region()
+                      << " mmr=" << qp.mmr();
+            for (const auto& dc : qp.pings()) {
+                std::cout << " ping_" << dc.datacenter() << "=" << dc.ping_ms();
+            }
+            std::cout << " waited_s=" << qp.waited_seconds() << "\n";
+        }
+        if (response.next_page_token().empty()) {
+            std::cout << response.total_players() << " players (snapshot " << response.version() << ")\n";
+        }
+        request.set_page_token(response.next_page_token());
+    } while (!request.page_token().empty());
 
     return true;
 }
@@ -1,69 +1,45 @@
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <limits>
-#include <random>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "simulator/LoadGenerator.h"
+#include "simulator/PopulationModel.h"
 #include "simulator/SimulatorClient.h"
 #include "simulator/SimConfig.h"
 #include "matchmaker.pb.h"
 
 namespace {
 
-matchmaking::Player MakeDummyPlayer(int index) {
-    static std::mt19937 rng(std::random_device{}());
-
-    std::uniform_int_distribution<int> mmr_dist(800, 2400);
-    std::uniform_int_distribution<int> base_ping_dist(20, 60);
-    std::uniform_int_distribution<int> extra_ping_dist(60, 140);
-
-    matchmaking::Player player;
-    player.set_id("player_" + std::to_string(index));
-    player.set_mmr(mmr_dist(rng));
-
-    const std::vector<std::string> regions = {"NA", "EU", "ASIA"};
-    std::uniform_int_distribution<std::size_t> home_dist(0, regions.size() - 1);
-    std::size_t home_index = home_dist(rng);
-
-    int base_ping = base_ping_dist(rng);
-
-    int ping_na = base_ping + (home_index == 0 ? 0 : extra_ping_dist(rng));
-    int ping_eu = base_ping + (home_index == 1 ? 0 : extra_ping_dist(rng));
-    int ping_asia = base_ping + (home_index == 2 ? 0 : extra_ping_dist(rng));
-
-    player.set_ping_na(ping_na);
-    player.set_ping_eu(ping_eu);
-    player.set_ping_asia(ping_asia);
-
-    std::string home_region = regions[home_index];
-    int best_ping = base_ping;
-
-    player.set_ping(best_ping);
-    player.set_region(home_region);
-
-    return player;
+std::uint64_t RunSeed() {
+    return static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
 }
 
 int RunSimulator(const SimConfig& config) {
     std::cout << "Starting match_simulator, target=" << config.target_address
               << ", total_players=" << config.total_players << std::endl;
 
+    PopulationModel population(config.population, RunSeed());
     for (int i = 0; i < config.total_players; ++i) {
-        auto player = MakeDummyPlayer(i);
-
-        SimulatorClient client(config.target_address);
-        bool ok = client.Enqueue(player);
-        if (!ok) {
-            std::cerr << "Failed to enqueue player " << player.id() << "\n";
-        } else {
-            std::cout << "Enqueued player " << player.id()
-                      << " (mmr=" << player.mmr()
-                      << ", ping_na=" << player.ping_na()
-                      << ", ping_eu=" << player.ping_eu()
-                      << ", ping_asia=" << player.ping_asia()
-                      << ", home_region=" << player.region() << ")\n";
+        const double t_seconds = static_cast<double>(i) * config.delay_ms_between_players / 1000.0;
+        for (const auto& arrival : population.MakeArrival(i, t_seconds, "player_")) {
+            const auto& player = arrival.player;
+
+            SimulatorClient client(config.target_address);
+            bool ok = client.Enqueue(player);
+            if (!ok) {
+                std::cerr << "Failed to enqueue player " << player.id() << "\n";
+            } else {
+                std::cout << "Enqueued player " << player.id() << " (mmr=" << player.mmr();
+                for (const auto& dc : player.pings()) {
+                    std::cout << ", ping_" << dc.datacenter() << "=" << dc.ping_ms();
+                }
+                std::cout << ", home_region=" << player.region() << ")\n";
+            }
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(config.delay_ms_between_players));
@@ -74,6 +50,38 @@ int RunSimulator(const SimConfig& config) {
     return 0;
 }
 
+int RunLoad(const SimConfig& config) {
+    LoadOptions options;
+    options.total_players = config.total_players;
+    options.threads = config.load_threads;
+    options.rate = config.load_rate_per_second;
+    options.ramp_start_rate = config.load_ramp_start_rate;
+    options.match_timeout_ms = config.match_timeout_ms;
+    options.call_timeout_ms = config.load_call_timeout_ms;
+    ParseArrivalPattern(config.load_arrival, options.pattern);
+    options.seed = RunSeed();
+
+    auto population = std::make_shared<PopulationModel>(config.population, options.seed);
+    options.intensity = [population](double t_seconds) { return population->Intensity(t_seconds); };
+
+    std::cout << "Starting load test, target=" << config.target_address
+              << ", players=" << options.total_players
+              << ", rate=" << options.rate << "/s (" << ArrivalPatternName(options.pattern) << ")"
+              << ", threads=" << options.threads
+              << ", channels=" << config.load_channels << std::endl;
+
+    // Ids must not collide with players left in the queue by an earlier run.
+    const std::string prefix = "load_" + std::to_string(options.seed % 1000000) + "_";
+    LoadGenerator generator(LoadGenerator::CreateChannels(config.target_address, config.load_channels),
+                            options,
+                            [&prefix, population](int index, double t_seconds) {
+                                return population->MakeArrival(index, t_seconds, prefix);
+                            });
+    LoadReport report = generator.Run();
+    report.Print(std::cout);
+    return report.enqueue_failed == 0 ? 0 : 1;
+}
+
 void EditSimConfig(SimConfig& config) {
     for (;;) {
         std::cout << "\nCurrent simulator configuration:\n";
@@ -122,17 +130,22 @@ void EditSimConfig(SimConfig& config) {
 
 }  // namespace
 
-int main() {
+int main(int argc, char** argv) {
     SimConfig config = SimConfig::LoadFromFile("config/sim_config.json");
 
+    if (argc > 1 && std::string(argv[1]) == "--load") {
+        return RunLoad(config);
+    }
+
     for (;;) {
         std::cout << "\nMatch simulator menu:\n";
         std::cout << "1) Run simulator\n";
-        std::cout << "2) Change options\n";
-        std::cout << "3) View metrics\n";
-        std::cout << "4) View queue\n";
-        std::cout << "5) Reset options to defaults\n";
-        std::cout << "6) Exit\n";
+        std::cout << "2) Run load test\n";
+        std::cout << "3) Change options\n";
+        std::cout << "4) View metrics\n";
+        std::cout << "5) View queue\n";
+        std::cout << "6) Reset options to defaults\n";
+        std::cout << "7) Exit\n";
         std::cout << "Select option: ";
 
         int choice = 0;
@@ -150,19 +163,22 @@ int main() {
             config.SaveToFile("config/sim_config.json");
             RunSimulator(config);
         } else if (choice == 2) {
-            EditSimConfig(config);
             config.SaveToFile("config/sim_config.json");
+            RunLoad(config);
         } else if (choice == 3) {
+            EditSimConfig(config);
+            config.SaveToFile("config/sim_config.json");
+        } else if (choice == 4) {
             SimulatorClient client(config.target_address);
             client.PrintMetrics();
-        } else if (choice == 4) {
+        } else if (choice == 5) {
             SimulatorClient client(config.target_address);
             client.PrintQueue();
-        } else if (choice == 5) {
+        } else if (choice == 6) {
             config = SimConfig();
             config.SaveToFile("config/sim_config.json");
             std::cout << "Options reset to defaults.\n";
-        } else if (choice == 6) {
+        } else if (choice == 7) {
             break;
         }
     }
@@ -0,0 +1,335 @@
+#include "tools/MatchLogReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::int64_t kMsPerMinute = 60 * 1000;
+
+// Per-record scratch state. Regions are counted in a tiny flat array because a
+// match only ever mixes a handful of them.
+struct RecordState {
+    struct RegionCount {
+        std::string_view region;
+        int count;
+    };
+
+    int players = 0;
+    int min_mmr = std::numeric_limits<int>::max();
+    int max_mmr = std::numeric_limits<int>::min();
+    std::int64_t created_at_ms = -1;
+    RegionCount regions[16];
+    int region_count = 0;
+
+    void AddRegion(std::string_view region) {
+        for (int i = 0; i < region_count; ++i) {
+            if (regions[i].region == region) {
+                ++regions[i].count;
+                return;
+            }
+        }
+        if (region_count < static_cast<int>(std::size(regions))) {
+            regions[region_count++] = RegionCount{region, 1};
+        }
+    }
+};
+
+const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+// Returns the position of the closing quote for a string starting after `p`, or nullptr.
+const char* FindStringEnd(const char* p, const char* end) {
+    for (;;) {
+        const void* hit = std::memchr(p, '"', static_cast<std::size_t>(end - p));
+        if (!hit) {
+            return nullptr;
+        }
+        const char* q = static_cast<const char*>(hit);
+        // A quote is escaped when preceded by an odd number of backslashes.
+        const char* b = q;
+        while (b > p && b[-1] == '\\') {
+            --b;
+        }
+        if (((q - b) & 1) == 0) {
+            return q;
+        }
+        p = q + 1;
+    }
+}
+
+template <typename T>
+bool ParseNumber(const char*& p, const char* end, T& out) {
+    auto [next, ec] = std::from_chars(p, end, out);
+    if (ec != std::errc()) {
+        return false;
+    }
+    p = next;
+    return true;
+}
+
+void ScanRange(std::string_view data, MatchLogStats& stats) {
+    const char* p = data.data();
+    const char* end = p + data.size();
+    while (p < end) {
+        const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+        const char* line_end = nl ? static_cast<const char*>(nl) : end;
+        std::string_view line(p, static_cast<std::size_t>(line_end - p));
+        const char* first = SkipSpaces(line.data(), line_end);
+        if (first != line_end) {
+            if (!MatchLogReader::ScanRecord(line, stats)) {
+                ++stats.malformed_records;
+            }
+        }
+        p = line_end + 1;
+    }
+}
+
+}  // namespace
+
+MappedFile::~MappedFile() {
+    if (data_ && size_ > 0) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+bool MappedFile::Open(const std::string& path, std::string* error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        if (error) *error = "cannot stat " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        if (error) *error = "cannot mmap " + path + ": " + std::strerror(errno);
+        size_ = 0;
+        return false;
+    }
+    madvise(mapped, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapped);
+    return true;
+}
+
+void MatchLogStats::Merge(const MatchLogStats& other) {
+    matches += other.matches;
+    players += other.players;
+    malformed_records += other.malformed_records;
+    for (std::size_t i = 0; i < kSpreadBuckets; ++i) {
+        spread_histogram[i] += other.spread_histogram[i];
+    }
+    spread_sum += other.spread_sum;
+    spread_max = std::max(spread_max, other.spread_max);
+    for (const auto& [region, count] : other.players_per_region) {
+        players_per_region[region] += count;
+    }
+    for (const auto& [region, count] : other.matches_per_majority_region) {
+        matches_per_majority_region[region] += count;
+    }
+    for (const auto& [minute, count] : other.matches_per_minute) {
+        matches_per_minute[minute] += count;
+    }
+}
+
+int MatchLogStats::SpreadPercentile(double fraction) const {
+    if (matches == 0) {
+        return 0;
+    }
+    auto target = static_cast<std::uint64_t>(fraction * static_cast<double>(matches));
+    if (target == 0) {
+        target = 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kSpreadBuckets; ++i) {
+        seen += spread_histogram[i];
+        if (seen >= target) {
+            if (i + 1 == kSpreadBuckets) {
+                return spread_max;
+            }
+            return static_cast<int>((i + 1) * kSpreadBucketWidth) - 1;
+        }
+    }
+    return spread_max;
+}
+
+MatchLogFormat MatchLogReader::DetectFormat(std::string_view data) {
+    for (char c : data) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        return c == '{' ? MatchLogFormat::Jsonl : MatchLogFormat::Unknown;
+    }
+    return MatchLogFormat::Jsonl;
+}
+
+bool MatchLogReader::ScanRecord(std::string_view line, MatchLogStats& stats) {
+    const char* p = SkipSpaces(line.data(), line.data() + line.size());
+    const char* end = line.data() + line.size();
+    if (p == end || *p != '{') {
+        return false;
+    }
+
+    RecordState record;
+    // Bracket depth outside strings. A record cut short (e.g. by a crash mid-write) can
+    // still hold whole players; only records that close every bracket are counted.
+    int depth = 0;
+    while (p < end) {
+        const void* hit = std::memchr(p, '"', static_cast<std::size_t>(end - p));
+        for (const char* q = p; q < (hit ? static_cast<const char*>(hit) : end); ++q) {
+            depth += (*q == '{' || *q == '[') - (*q == '}' || *q == ']');
+        }
+        if (!hit) {
+            break;
+        }
+        const char* key_begin = static_cast<const char*>(hit) + 1;
+        const char* key_end = FindStringEnd(key_begin, end);
+        if (!key_end) {
+            return false;
+        }
+        std::string_view key(key_begin, static_cast<std::size_t>(key_end - key_begin));
+        p = SkipSpaces(key_end + 1, end);
+        if (p == end || *p != ':') {
+            // A string that is not followed by ':' is a value we are not interested in.
+            continue;
+        }
+        p = SkipSpaces(p + 1, end);
+        if (p == end) {
+            return false;
+        }
+
+        if (key == "mmr") {
+            int mmr = 0;
+            if (!ParseNumber(p, end, mmr)) {
+                return false;
+            }
+            ++record.players;
+            record.min_mmr = std::min(record.min_mmr, mmr);
+            record.max_mmr = std::max(record.max_mmr, mmr);
+        } else if (key == "created_at_ms") {
+            if (!ParseNumber(p, end, record.created_at_ms)) {
+                return false;
+            }
+        } else if (*p == '"') {
+            const char* value_begin = p + 1;
+            const char* value_end = FindStringEnd(value_begin, end);
+            if (!value_end) {
+                return false;
+            }
+            if (key == "region") {
+                record.AddRegion(std::string_view(value_begin, static_cast<std::size_t>(value_end - value_begin)));
+            }
+            p = value_end + 1;
+        }
+    }
+
+    if (record.players == 0 || depth != 0) {
+        return false;
+    }
+
+    ++stats.matches;
+    stats.players += static_cast<std::uint64_t>(record.players);
+
+    int spread = record.max_mmr - record.min_mmr;
+    std::size_t bucket = static_cast<std::size_t>(spread / MatchLogStats::kSpreadBucketWidth);
+    if (bucket >= MatchLogStats::kSpreadBuckets) {
+        bucket = MatchLogStats::kSpreadBuckets - 1;
+    }
+    ++stats.spread_histogram[bucket];
+    stats.spread_sum += static_cast<std::uint64_t>(spread);
+    stats.spread_max = std::max(stats.spread_max, spread);
+
+    int majority = -1;
+    for (int i = 0; i < record.region_count; ++i) {
+        const auto& rc = record.regions[i];
+        auto it = stats.players_per_region.find(rc.region);
+        if (it == stats.players_per_region.end()) {
+            it = stats.players_per_region.emplace(std::string(rc.region), 0).first;
+        }
+        it->second += static_cast<std::uint64_t>(rc.count);
+        if (majority < 0 || rc.count > record.regions[majority].count) {
+            majority = i;
+        }
+    }
+    if (majority >= 0) {
+        std::string_view region = record.regions[majority].region;
+        auto it = stats.matches_per_majority_region.find(region);
+        if (it == stats.matches_per_majority_region.end()) {
+            it = stats.matches_per_majority_region.emplace(std::string(region), 0).first;
+        }
+        ++it->second;
+    }
+
+    if (record.created_at_ms >= 0) {
+        ++stats.matches_per_minute[record.created_at_ms / kMsPerMinute];
+    }
+
+    return true;
+}
+
+MatchLogStats MatchLogReader::ScanParallel(std::string_view data, unsigned threads) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    // Tiny inputs are not worth a thread each.
+    constexpr std::size_t kMinChunkBytes = 1 << 20;
+    std::size_t max_chunks = std::max<std::size_t>(1, data.size() / kMinChunkBytes);
+    std::size_t chunks = std::min<std::size_t>(threads, max_chunks);
+
+    std::vector<std::string_view> ranges;
+    ranges.reserve(chunks);
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < chunks && begin < data.size(); ++i) {
+        std::size_t end = (i + 1 == chunks) ? data.size() : data.size() * (i + 1) / chunks;
+        if (end < begin) {
+            end = begin;
+        }
+        std::size_t nl = data.find('\n', end);
+        end = (nl == std::string_view::npos) ? data.size() : nl + 1;
+        ranges.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<MatchLogStats> partial(ranges.size());
+    std::vector<std::thread> workers;
+    workers.reserve(ranges.size());
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        workers.emplace_back([&, i] { ScanRange(ranges[i], partial[i]); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    MatchLogStats total;
+    for (const auto& stats : partial) {
+        total.Merge(stats);
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file. The mapping is released on destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, std::string* error);
+
+    std::string_view Data() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+enum class MatchLogFormat {
+    Jsonl,
+    Unknown,
+};
+
+struct MatchLogStats {
+    static constexpr int kSpreadBucketWidth = 50;
+    static constexpr std::size_t kSpreadBuckets = 21;  // last bucket collects everything above
+
+    std::uint64_t matches = 0;
+    std::uint64_t players = 0;
+    std::uint64_t malformed_records = 0;
+
+    std::array<std::uint64_t, kSpreadBuckets> spread_histogram{};
+    std::uint64_t spread_sum = 0;
+    int spread_max = 0;
+
+    std::map<std::string, std::uint64_t, std::less<>> players_per_region;
+    std::map<std::string, std::uint64_t, std::less<>> matches_per_majority_region;
+
+    // Keyed by minutes since the Unix epoch; only filled for records carrying created_at_ms.
+    std::map<std::int64_t, std::uint64_t> matches_per_minute;
+
+    void Merge(const MatchLogStats& other);
+    // Returns the smallest spread s such that at least `fraction` of matches have spread <= s,
+    // resolved to the upper edge of the histogram bucket.
+    int SpreadPercentile(double fraction) const;
+};
+
+class MatchLogReader {
+public:
+    static MatchLogFormat DetectFormat(std::string_view data);
+
+    // Scans one JSONL record in place and folds it into `stats`. Returns false on malformed
+    // input, including records cut short before their closing brackets.
+    static bool ScanRecord(std::string_view line, MatchLogStats& stats);
+
+    // Splits `data` into newline-aligned chunks and scans them on `threads` worker threads.
+    static MatchLogStats ScanParallel(std::string_view data, unsigned threads);
+};
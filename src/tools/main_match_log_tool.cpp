@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "tools/MatchLogReader.h"
+
+namespace {
+
+void PrintUsage() {
+    std::cerr << "Usage: match_log_tool [path] [--threads N]\n"
+              << "  path defaults to matches.jsonl\n";
+}
+
+bool ParseCount(std::string_view text, unsigned& out) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size() && out > 0;
+}
+
+void PrintReport(const MatchLogStats& stats, std::size_t bytes, double seconds) {
+    std::cout << "\n=== Match log summary ===\n";
+    std::cout << "Matches: " << stats.matches
+              << ", players: " << stats.players
+              << ", malformed records: " << stats.malformed_records << "\n";
+
+    double mib = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(2)
+              << "Scanned " << mib << " MiB in " << seconds * 1000.0 << " ms";
+    if (seconds > 0.0) {
+        std::cout << " (" << mib / seconds << " MiB/s)";
+    }
+    std::cout << "\n";
+
+    if (stats.matches == 0) {
+        return;
+    }
+
+    std::cout << "\nMMR spread: avg="
+              << static_cast<double>(stats.spread_sum) / static_cast<double>(stats.matches)
+              << " p50<=" << stats.SpreadPercentile(0.50)
+              << " p90<=" << stats.SpreadPercentile(0.90)
+              << " p99<=" << stats.SpreadPercentile(0.99)
+              << " max=" << stats.spread_max << "\n";
+    for (std::size_t i = 0; i < MatchLogStats::kSpreadBuckets; ++i) {
+        if (stats.spread_histogram[i] == 0) {
+            continue;
+        }
+        int low = static_cast<int>(i) * MatchLogStats::kSpreadBucketWidth;
+        std::cout << "  " << std::setw(5) << low;
+        if (i + 1 == MatchLogStats::kSpreadBuckets) {
+            std::cout << "+     ";
+        } else {
+            std::cout << "-" << std::setw(5) << std::left << (low + MatchLogStats::kSpreadBucketWidth - 1) << std::right;
+        }
+        double share = 100.0 * static_cast<double>(stats.spread_histogram[i]) / static_cast<double>(stats.matches);
+        std::cout << " " << std::setw(8) << stats.spread_histogram[i] << "  " << share << "%\n";
+    }
+
+    std::cout << "\nRegion mix (players by home region):\n";
+    for (const auto& [region, count] : stats.players_per_region) {
+        double share = 100.0 * static_cast<double>(count) / static_cast<double>(stats.players);
+        std::cout << "  " << region << ": " << count << " (" << share << "%)\n";
+    }
+    std::cout << "Matches by majority region:\n";
+    for (const auto& [region, count] : stats.matches_per_majority_region) {
+        std::cout << "  " << region << ": " << count << "\n";
+    }
+
+    if (stats.matches_per_minute.empty()) {
+        std::cout << "\nMatches per minute: unavailable (records have no created_at_ms)\n";
+        return;
+    }
+    std::uint64_t timed = 0;
+    std::uint64_t peak = 0;
+    for (const auto& [minute, count] : stats.matches_per_minute) {
+        timed += count;
+        peak = std::max(peak, count);
+    }
+    auto span_minutes = stats.matches_per_minute.rbegin()->first - stats.matches_per_minute.begin()->first + 1;
+    std::cout << "\nMatches per minute: avg="
+              << static_cast<double>(timed) / static_cast<double>(span_minutes)
+              << " peak=" << peak
+              << " over " << span_minutes << " minute(s)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string path = "matches.jsonl";
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            if (i + 1 >= argc || !ParseCount(argv[++i], threads)) {
+                PrintUsage();
+                return 1;
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            PrintUsage();
+            return 1;
+        } else {
+            path = arg;
+        }
+    }
+
+    MappedFile file;
+    std::string error;
+    if (!file.Open(path, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    if (MatchLogReader::DetectFormat(file.Data()) != MatchLogFormat::Jsonl) {
+        std::cerr << "Unrecognized match log format in " << path << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MatchLogStats stats = MatchLogReader::ScanParallel(file.Data(), threads);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    PrintReport(stats, file.Data().size(), elapsed);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "Engine/AdmissionController.h"
+
+TEST(AdmissionControllerTests, AdmitsEverythingWithDefaultLimits) {
+    AdmissionController admission(AdmissionLimits{});
+    AdmissionSignals overloaded;
+    overloaded.tick_lag_ms = 60000;
+    overloaded.region_queue = 1000000;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(admission.Admit("ipv4:10.0.0.1", overloaded, 0).Admitted());
+    }
+}
+
+TEST(AdmissionControllerTests, ShedsOnTickLagAndRegionDepth) {
+    AdmissionLimits limits;
+    limits.max_tick_lag_ms = 500;
+    limits.max_region_queue = 100;
+    limits.retry_after_ms = 250;
+    AdmissionController admission(limits);
+
+    AdmissionSignals signals;
+    signals.tick_lag_ms = 500;
+    signals.region_queue = 99;
+    EXPECT_TRUE(admission.Admit("a", signals, 0).Admitted());
+
+    signals.tick_lag_ms = 800;
+    AdmissionDecision lagging = admission.Admit("a", signals, 0);
+    EXPECT_EQ(lagging.reason, AdmissionReason::TickLag);
+    // A lagging engine asks for at least as long as it is behind.
+    EXPECT_EQ(lagging.retry_after_ms, 800);
+
+    signals.tick_lag_ms = 0;
+    signals.region_queue = 100;
+    AdmissionDecision full = admission.Admit("a", signals, 0);
+    EXPECT_EQ(full.reason, AdmissionReason::RegionQueue);
+    EXPECT_EQ(full.retry_after_ms, 250);
+
+    AdmissionStats stats = admission.Stats(0);
+    EXPECT_EQ(stats.rejected_tick_lag, 1u);
+    EXPECT_EQ(stats.rejected_region_queue, 1u);
+}
+
+TEST(AdmissionControllerTests, ClientBucketsAllowABurstThenTheirRate) {
+    AdmissionLimits limits;
+    limits.client_enqueues_per_second = 10;
+    limits.client_enqueue_burst = 3;
+    AdmissionController admission(limits);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(admission.Admit("a", {}, 0).Admitted());
+    }
+    AdmissionDecision limited = admission.Admit("a", {}, 0);
+    EXPECT_EQ(limited.reason, AdmissionReason::ClientRate);
+    EXPECT_EQ(limited.retry_after_ms, 100);
+    // Other clients have their own bucket.
+    EXPECT_TRUE(admission.Admit("b", {}, 0).Admitted());
+
+    EXPECT_FALSE(admission.Admit("a", {}, 99).Admitted());
+    EXPECT_TRUE(admission.Admit("a", {}, 150).Admitted());
+    EXPECT_FALSE(admission.Admit("a", {}, 150).Admitted());
+    EXPECT_EQ(admission.Stats(150).rejected_client_rate, 3u);
+}
+
+TEST(AdmissionControllerTests, IngestLimitRefundsTheClientToken) {
+    AdmissionLimits limits;
+    limits.max_enqueues_per_second = 2;
+    limits.client_enqueues_per_second = 1;
+    AdmissionController admission(limits);
+
+    EXPECT_TRUE(admission.Admit("a", {}, 0).Admitted());
+    EXPECT_TRUE(admission.Admit("b", {}, 0).Admitted());
+    AdmissionDecision shed = admission.Admit("c", {}, 0);
+    EXPECT_EQ(shed.reason, AdmissionReason::IngestRate);
+    EXPECT_EQ(shed.retry_after_ms, 500);
+
+    // Client c was turned away by the global limit, so its own bucket is still full.
+    EXPECT_TRUE(admission.Admit("c", {}, 500).Admitted());
+}
+
+TEST(AdmissionControllerTests, ReportsTheAdmittedRate) {
+    AdmissionController admission(AdmissionLimits{});
+    for (int i = 0; i < 50; ++i) {
+        admission.Admit("a", {}, 1000 + i * 20);
+    }
+    EXPECT_DOUBLE_EQ(admission.Stats(2000).enqueues_per_second, 50.0);
+}
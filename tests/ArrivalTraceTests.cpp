@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/ArrivalTrace.h"
+
+using matchmaking::Player;
+
+namespace {
+
+std::string WriteLines(const std::string& name, const std::vector<std::string>& lines) {
+    const std::string path = ::testing::TempDir() + name;
+    std::ofstream out(path, std::ios::trunc);
+    for (const auto& line : lines) {
+        out << line << "\n";
+    }
+    return path;
+}
+
+}  // namespace
+
+TEST(ArrivalTraceTests, EscapedStringsRoundTrip) {
+    const std::string path = ::testing::TempDir() + "escaped_trace.jsonl";
+    std::remove(path.c_str());
+
+    Player player;
+    player.set_id("p\"1\\x");
+    player.set_mmr(1500);
+    player.set_ping(40);
+    player.set_region("E\"U");
+    player.set_queue_id("ranked\n");
+    auto* dc = player.add_pings();
+    dc->set_datacenter("F\"R,A:1");
+    dc->set_ping_ms(23);
+    {
+        ArrivalTraceWriter writer(path);
+        ASSERT_TRUE(writer.IsOpen());
+        writer.RecordEnqueue(10, player);
+        writer.RecordCancel(20, player.id());
+    }
+
+    std::vector<ArrivalEvent> events;
+    std::string error;
+    ASSERT_TRUE(ArrivalTraceReader::Load(path, events, &error)) << error;
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, ArrivalEvent::Type::Enqueue);
+    EXPECT_EQ(events[0].t_ms, 10);
+    EXPECT_EQ(events[0].player.id(), player.id());
+    EXPECT_EQ(events[0].player.region(), player.region());
+    EXPECT_EQ(events[0].player.queue_id(), player.queue_id());
+    EXPECT_EQ(events[0].player.mmr(), 1500);
+    ASSERT_EQ(events[0].player.pings_size(), 1);
+    EXPECT_EQ(events[0].player.pings(0).datacenter(), "F\"R,A:1");
+    EXPECT_EQ(events[0].player.pings(0).ping_ms(), 23);
+    EXPECT_EQ(events[1].type, ArrivalEvent::Type::Cancel);
+    EXPECT_EQ(events[1].player.id(), player.id());
+}
+
+TEST(ArrivalTraceTests, AppendedSessionsLoadSeparately) {
+    const std::string path = ::testing::TempDir() + "two_session_trace.jsonl";
+    std::remove(path.c_str());
+
+    Player first;
+    first.set_id("first");
+    Player second;
+    second.set_id("second");
+    {
+        ArrivalTraceWriter writer(path);
+        ASSERT_TRUE(writer.IsOpen());
+        writer.RecordEnqueue(0, first);
+        writer.RecordCancel(500, first.id());
+    }
+    {
+        ArrivalTraceWriter writer(path);
+        ASSERT_TRUE(writer.IsOpen());
+    }
+    {
+        ArrivalTraceWriter writer(path);
+        ASSERT_TRUE(writer.IsOpen());
+        writer.RecordEnqueue(0, second);
+        writer.RecordCancel(100, second.id());
+    }
+
+    std::vector<ArrivalEvent> events;
+    std::string error;
+    ASSERT_TRUE(ArrivalTraceReader::Load(path, events, &error)) << error;
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].player.id(), "first");
+    EXPECT_EQ(events[1].player.id(), "first");
+    EXPECT_EQ(events[1].t_ms, 500);
+    EXPECT_EQ(events[0].session, 0u);
+    EXPECT_EQ(events[1].session, 0u);
+    EXPECT_EQ(events[2].player.id(), "second");
+    EXPECT_EQ(events[2].type, ArrivalEvent::Type::Enqueue);
+    EXPECT_EQ(events[3].player.id(), "second");
+    EXPECT_EQ(events[3].t_ms, 100);
+    // The empty session in between does not take a number.
+    EXPECT_EQ(events[2].session, 1u);
+    EXPECT_EQ(events[3].session, 1u);
+}
+
+TEST(ArrivalTraceTests, MalformedEventsNameTheirLine) {
+    const std::vector<std::string> bad = {
+        R"({"t_ms":5 "op":"enqueue","id":"a"})",
+        R"({"t_ms":5,"op":"enqueue","id":"a)",
+        R"({"t_ms":5,"op":"join","id":"a"})",
+        R"({"t_ms":5,"op":"enqueue"})",
+        R"({"t_ms":5,"op":"enqueue","id":"a","mmr":"high"})",
+        R"({"t_ms":5,"op":"enqueue","id":"a","pings":{"FRA":-nan}})",
+        R"({"t_ms":5,"op":"enqueue","id":"a","pings":"FRA:23,IAD:95"})",
+    };
+    for (std::size_t i = 0; i < bad.size(); ++i) {
+        const std::string path = WriteLines("bad_trace.jsonl", {R"({"t_ms":1,"op":"cancel","id":"ok"})", bad[i]});
+        std::vector<ArrivalEvent> events;
+        std::string error;
+        EXPECT_FALSE(ArrivalTraceReader::Load(path, events, &error)) << bad[i];
+        EXPECT_NE(error.find("bad_trace.jsonl:2:"), std::string::npos) << error;
+    }
+}
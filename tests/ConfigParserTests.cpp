@@ -0,0 +1,231 @@
+#include <cstdlib>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common/ConfigParser.h"
+#include "Engine/EngineConfig.h"
+
+TEST(ConfigParserTests, ParsesNestedSectionsWithLines) {
+    const std::string content =
+        "{\n"
+        "  \"name\": \"ranked\",\n"
+        "  \"regions\": {\n"
+        "    \"EU\": { \"max_ping_ms\": 60 }\n"
+        "  },\n"
+        "  \"queues\": [ { \"id\": \"duo\" }, { \"id\": \"solo\" } ]\n"
+        "}\n";
+
+    ConfigValue root;
+    ConfigError error;
+    ASSERT_TRUE(ConfigParser::Parse(content, root, &error)) << error.ToString();
+
+    const ConfigValue* regions = root.Find("regions");
+    ASSERT_NE(regions, nullptr);
+    ASSERT_TRUE(regions->IsObject());
+    const ConfigValue* eu = regions->Find("EU");
+    ASSERT_NE(eu, nullptr);
+    EXPECT_EQ(eu->line(), 4);
+
+    int max_ping = 0;
+    EXPECT_TRUE(config::ReadInt(*eu, "max_ping_ms", max_ping, &error));
+    EXPECT_EQ(max_ping, 60);
+
+    const ConfigValue* queues = root.Find("queues");
+    ASSERT_NE(queues, nullptr);
+    ASSERT_TRUE(queues->IsArray());
+    ASSERT_EQ(queues->Elements().size(), 2u);
+    EXPECT_EQ(queues->Elements()[1].Find("id")->AsString(), "solo");
+}
+
+TEST(ConfigParserTests, KeysAreMatchedExactly) {
+    // The old substring search picked up "max_ping_ms" from "max_ping_ms_cap".
+    EngineConfig config;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::Parse("{\"max_ping_ms_cap\": 250}", config, &error)) << error.ToString();
+    EXPECT_EQ(config.max_ping_ms, EngineConfig().max_ping_ms);
+    EXPECT_EQ(config.max_ping_ms_cap, 250);
+}
+
+TEST(ConfigParserTests, ReportsSyntaxErrorLine) {
+    ConfigValue root;
+    ConfigError error;
+    EXPECT_FALSE(ConfigParser::Parse("{\n  \"a\": 1,\n  \"b\" 2\n}\n", root, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::Syntax);
+    EXPECT_EQ(error.line, 3);
+}
+
+TEST(ConfigParserTests, NumbersFollowJsonGrammarAndMustBeFinite) {
+    ConfigValue root;
+    ConfigError error;
+    for (const char* number : {"-nan", "nan", "-inf", "inf", "-infinity", "+1", "01", "1.", ".5", "1e", "1e+",
+                               "0x10", "1.5.2", "-"}) {
+        const std::string content = std::string("{\"rate\": ") + number + "}";
+        EXPECT_FALSE(ConfigParser::Parse(content, root, &error)) << number;
+        EXPECT_EQ(error.kind, ConfigError::Kind::Syntax) << number;
+    }
+    EXPECT_FALSE(ConfigParser::Parse("{\"rate\": 1e400}", root, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::OutOfRange);
+
+    ASSERT_TRUE(ConfigParser::Parse("{\"a\": -0.5e-3, \"b\": 1E+2, \"c\": 0, \"d\": -12.25}", root, &error))
+        << error.ToString();
+    EXPECT_DOUBLE_EQ(root.Find("a")->AsNumber(), -0.0005);
+    EXPECT_DOUBLE_EQ(root.Find("b")->AsNumber(), 100.0);
+    EXPECT_DOUBLE_EQ(root.Find("d")->AsNumber(), -12.25);
+
+    EngineConfig config;
+    EXPECT_FALSE(EngineConfig::Parse("{\"client_enqueues_per_second\": -nan}", config, &error));
+}
+
+TEST(ConfigParserTests, SavedStringsAreEscaped) {
+    EngineConfig config;
+    config.matches_path = "out/\"quoted\" \\ dir\n/matches.jsonl";
+    config.arrival_trace_path = "trace\t\x01.jsonl";
+    const std::string path = ::testing::TempDir() + "escaped_strings.json";
+    ASSERT_TRUE(config.SaveToFile(path));
+
+    EngineConfig reloaded;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::TryLoadFromFile(path, reloaded, &error)) << error.ToString();
+    EXPECT_EQ(reloaded.matches_path, config.matches_path);
+    EXPECT_EQ(reloaded.arrival_trace_path, config.arrival_trace_path);
+    EXPECT_EQ(config::Quote("a\"b\\c\x1f"), "\"a\\\"b\\\\c\\u001f\"");
+}
+
+TEST(ConfigParserTests, ReportsTypedSchemaErrors) {
+    EngineConfig config;
+    ConfigError error;
+
+    EXPECT_FALSE(EngineConfig::Parse("{\n\"tick_interval_ms\": \"fast\"\n}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::TypeMismatch);
+    EXPECT_EQ(error.line, 2);
+
+    EXPECT_FALSE(EngineConfig::Parse("{\"tick_interval_ms\": 0}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::OutOfRange);
+
+    EXPECT_FALSE(EngineConfig::Parse("{\n\n\"max_mmr_windwo\": 10}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::UnknownKey);
+    EXPECT_EQ(error.line, 3);
+
+    EXPECT_FALSE(EngineConfig::Parse("{\"tick_interval_ms\": 1, \"tick_interval_ms\": 2}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::DuplicateKey);
+}
+
+TEST(ConfigParserTests, ValidatesCrossFieldRanges) {
+    EngineConfig config;
+    config.tick_interval_ms = 42;
+    ConfigError error;
+    EXPECT_FALSE(EngineConfig::Parse("{\"base_mmr_window\": 500, \"max_mmr_window\": 400}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::OutOfRange);
+    EXPECT_EQ(config.tick_interval_ms, 42);
+}
+
+TEST(ConfigParserTests, OverridesAreCheckedLikeFileValues) {
+    EngineConfig config;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::ApplyOverrides({{"tick_interval_ms", "25"}, {"matches_path", "a \"b\".jsonl"}},
+                                             config, &error))
+        << error.ToString();
+    EXPECT_EQ(config.tick_interval_ms, 25);
+    EXPECT_EQ(config.matches_path, "a \"b\".jsonl");
+    EXPECT_EQ(config.max_ping_ms, EngineConfig().max_ping_ms);
+
+    EXPECT_FALSE(EngineConfig::ApplyOverrides({{"max_ping_ms", "90"}, {"base_mmr_window", "fast"}}, config, &error));
+    EXPECT_EQ(error.line, 0);
+    EXPECT_NE(error.message.find("override base_mmr_window"), std::string::npos) << error.message;
+    EXPECT_EQ(config.max_ping_ms, EngineConfig().max_ping_ms);
+
+    EXPECT_FALSE(EngineConfig::ApplyOverrides({{"tick_rate", "5"}}, config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::UnknownKey);
+}
+
+TEST(ConfigParserTests, OverrideValuesCannotAddKeys) {
+    EngineConfig config;
+    ConfigError error;
+    EXPECT_FALSE(EngineConfig::ApplyOverrides(
+        {{"max_ping_ms", "90"}, {"tick_interval_ms", R"(50, "matches_path": "/etc/x")"}}, config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::Syntax);
+    EXPECT_EQ(error.line, 0);
+    EXPECT_NE(error.message.find("override tick_interval_ms"), std::string::npos) << error.message;
+    EXPECT_EQ(config.matches_path, EngineConfig().matches_path);
+    EXPECT_EQ(config.max_ping_ms, EngineConfig().max_ping_ms);
+
+    EXPECT_FALSE(EngineConfig::ApplyOverrides({{"regions", "[\"FRA\"], \"node_id\": 3"}}, config, &error));
+    EXPECT_NE(error.message.find("override regions"), std::string::npos) << error.message;
+
+    // A multi-line value still names its own override when the schema rejects it.
+    EXPECT_FALSE(EngineConfig::ApplyOverrides({{"regions", "[\n\"FRA\",\n1]"}, {"max_ping_ms", "90"}}, config, &error));
+    EXPECT_NE(error.message.find("override regions"), std::string::npos) << error.message;
+}
+
+TEST(ConfigParserTests, EnvironmentOverridesUseUpperCaseKeys) {
+    setenv("MM_TICK_INTERVAL_MS", "40", 1);
+    setenv("MM_LOG_LEVEL", "warn", 1);
+    ConfigOverrides overrides = EngineConfig::EnvironmentOverrides();
+    unsetenv("MM_TICK_INTERVAL_MS");
+    unsetenv("MM_LOG_LEVEL");
+
+    EngineConfig config;
+    ASSERT_TRUE(EngineConfig::ApplyOverrides(overrides, config));
+    EXPECT_EQ(config.tick_interval_ms, 40);
+    EXPECT_EQ(config.log_level, "warn");
+}
+
+TEST(ConfigParserTests, RegionsAreReadAsAValidatedList) {
+    EngineConfig config;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::Parse("{\"regions\": [\"FRA\", \"IAD\", \"SIN\"]}", config, &error)) << error.ToString();
+    EXPECT_EQ(config.regions, (std::vector<std::string>{"FRA", "IAD", "SIN"}));
+
+    EXPECT_FALSE(EngineConfig::Parse("{\"regions\": []}", config, &error));
+    EXPECT_FALSE(EngineConfig::Parse("{\"regions\": [\"FRA\", \"FRA\"]}", config, &error));
+    EXPECT_FALSE(EngineConfig::Parse("{\"regions\": [\"FRA\", 3]}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::TypeMismatch);
+
+    ASSERT_TRUE(EngineConfig::ApplyOverrides({{"regions", "AMS,NRT"}}, config, &error)) << error.ToString();
+    EXPECT_EQ(config.regions, (std::vector<std::string>{"AMS", "NRT"}));
+}
+
+TEST(ConfigParserTests, DatacenterObjectiveMustBeMaxOrP90) {
+    EngineConfig config;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::Parse("{\"datacenter_objective\": \"p90\"}", config, &error)) << error.ToString();
+    EXPECT_EQ(config.datacenter_objective, "p90");
+    EXPECT_FALSE(EngineConfig::Parse("{\"datacenter_objective\": \"mean\"}", config, &error));
+}
+
+TEST(ConfigParserTests, QueuesOverrideMatchingKeysPerPlaylist) {
+    const std::string json =
+        "{\n"
+        "  \"max_ping_ms\": 70,\n"
+        "  \"queues\": {\n"
+        "    \"ranked\": {\"max_allowed_mmr_diff\": 50},\n"
+        "    \"duel\": {\"team_size\": 1, \"datacenter_objective\": \"p90\"}\n"
+        "  }\n"
+        "}\n";
+    EngineConfig config;
+    ConfigError error;
+    ASSERT_TRUE(EngineConfig::Parse(json, config, &error)) << error.ToString();
+    ASSERT_EQ(config.queues.size(), 2u);
+    EXPECT_EQ(config.queues[1].id, "duel");
+
+    EngineConfig duel;
+    ASSERT_TRUE(config.ResolveQueue(config.queues[1], duel, &error)) << error.ToString();
+    EXPECT_EQ(duel.team_size, 1);
+    EXPECT_EQ(duel.datacenter_objective, "p90");
+    EXPECT_EQ(duel.max_ping_ms, 70);
+    EXPECT_TRUE(duel.queues.empty());
+
+    const std::string path = ::testing::TempDir() + "queues_round_trip.json";
+    ASSERT_TRUE(config.SaveToFile(path));
+    EngineConfig reloaded;
+    ASSERT_TRUE(EngineConfig::TryLoadFromFile(path, reloaded, &error)) << error.ToString();
+    ASSERT_EQ(reloaded.queues.size(), 2u);
+    EXPECT_EQ(reloaded.queues[1].rules, config.queues[1].rules);
+
+    EXPECT_FALSE(EngineConfig::Parse("{\"queues\": {\"duel\": {\n\"node_id\": 3}}}", config, &error));
+    EXPECT_EQ(error.kind, ConfigError::Kind::UnknownKey);
+    EXPECT_EQ(error.line, 2);
+    EXPECT_FALSE(EngineConfig::Parse("{\"queues\": {\"duel\": {\"team_size\": 9}}}", config, &error));
+    EXPECT_NE(error.message.find("queues.duel"), std::string::npos) << error.message;
+}
@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/Engine.h"
+#include "Engine/EngineClock.h"
+#include "Engine/EngineConfig.h"
+#include "common/ConfigParser.h"
+
+using matchmaking::Match;
+using matchmaking::Player;
+
+namespace {
+
+EngineConfig EngineTestConfig() {
+    EngineConfig cfg;
+    cfg.matches_path = "";
+    cfg.min_wait_before_match_ms = 0;
+    cfg.max_allowed_mmr_diff = 1000;
+    cfg.max_relaxed_mmr_diff = 1000;
+    return cfg;
+}
+
+Player MakePlayer(const std::string& id, int mmr) {
+    Player p;
+    p.set_id(id);
+    p.set_mmr(mmr);
+    p.set_ping(40);
+    p.set_region("NA");
+    return p;
+}
+
+}  // namespace
+
+TEST(EngineTests, StepFormsMatchWithoutTickThread) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    Engine engine(EngineTestConfig(), clock);
+
+    for (int i = 0; i < 10; ++i) {
+        engine.AddPlayer(MakePlayer("p" + std::to_string(i), 1000 + i));
+    }
+
+    std::vector<Match> formed;
+    EXPECT_EQ(engine.Step(&formed), 1u);
+    ASSERT_EQ(formed.size(), 1u);
+    EXPECT_EQ(formed[0].players_size(), 10);
+
+    matchmaking::QueueSnapshot snapshot;
+    engine.FillQueueSnapshot(snapshot);
+    EXPECT_EQ(snapshot.players_size(), 0);
+}
+
+TEST(EngineTests, PendingMatchIsDeliveredOnce) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    Engine engine(EngineTestConfig(), clock);
+
+    for (int i = 0; i < 10; ++i) {
+        engine.AddPlayer(MakePlayer("p" + std::to_string(i), 1500));
+    }
+    engine.Step();
+
+    EXPECT_EQ(engine.GetMatchesForPlayer("p3").size(), 1u);
+    EXPECT_TRUE(engine.GetMatchesForPlayer("p3").empty());
+}
+
+TEST(EngineTests, UnclaimedMatchesExpireAndAreReportedInMetrics) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.pending_match_ttl_ms = 1000;
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        engine.AddPlayer(MakePlayer("p" + std::to_string(i), 1500));
+    }
+    engine.Step();
+    ASSERT_EQ(engine.PeekMatchesForPlayer("p1").size(), 1u);
+    EXPECT_TRUE(engine.AcknowledgeMatch("p1", engine.PeekMatchesForPlayer("p1")[0]->match.match_id()));
+    engine.Step();
+    EXPECT_EQ(engine.GetMetricsSnapshot().pending.deliveries, 9u);
+
+    clock->Advance(std::chrono::seconds(2));
+    engine.Step();
+
+    EXPECT_TRUE(engine.GetMatchesForPlayer("p3").empty());
+    EngineMetrics metrics = engine.GetMetricsSnapshot();
+    EXPECT_EQ(metrics.pending.matches, 0u);
+    EXPECT_EQ(metrics.pending.expired, 1u);
+}
+
+TEST(EngineTests, QueueWaitFollowsInjectedClock) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    Engine engine(EngineTestConfig(), clock);
+
+    engine.AddPlayer(MakePlayer("waiting", 1200));
+    clock->Advance(std::chrono::seconds(5));
+    engine.Step();
+
+    matchmaking::QueueSnapshot snapshot;
+    engine.FillQueueSnapshot(snapshot);
+    ASSERT_EQ(snapshot.players_size(), 1);
+    EXPECT_DOUBLE_EQ(snapshot.players(0).waited_seconds(), 5.0);
+}
+
+TEST(EngineTests, WaitRelaxationUsesVirtualTime) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.max_ping_ms = 80;
+    config.ping_relax_per_second = 10;
+    config.max_ping_ms_cap = 200;
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        Player p = MakePlayer("p" + std::to_string(i), 1500);
+        p.set_ping(150);
+        engine.AddPlayer(p);
+    }
+
+    EXPECT_EQ(engine.Step(), 0u);
+
+    clock->Advance(std::chrono::seconds(10));
+    EXPECT_EQ(engine.Step(), 1u);
+}
+
+TEST(EngineTests, ReloadConfigIsAdoptedOnNextStep) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig strict = EngineTestConfig();
+    strict.max_allowed_mmr_diff = 100;
+    strict.max_relaxed_mmr_diff = 100;
+    Engine engine(strict, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        engine.AddPlayer(MakePlayer("p" + std::to_string(i), 1000 + i * 16));
+    }
+    EXPECT_EQ(engine.Step(), 0u);
+
+    EngineConfig invalid = EngineTestConfig();
+    invalid.max_mmr_window = invalid.base_mmr_window - 1;
+    std::string error;
+    EXPECT_FALSE(engine.ReloadConfig(invalid, &error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(engine.ConfigVersion(), 0u);
+    EXPECT_EQ(engine.Step(), 0u);
+
+    ASSERT_TRUE(engine.ReloadConfig(EngineTestConfig(), &error));
+    EXPECT_EQ(engine.ConfigVersion(), 1u);
+    EXPECT_EQ(engine.Step(), 1u);
+}
+
+TEST(EngineTests, ReloadRestartsASuspendedSearch) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig strict = EngineTestConfig();
+    strict.max_allowed_mmr_diff = 0;
+    strict.max_relaxed_mmr_diff = 0;
+    strict.tick_budget_ms = 1;
+    Engine engine(strict, clock);
+
+    // p0 waited longest, so a match with it beats every match without it. Its only MMR
+    // neighbours joined last, after enough players that a pass runs past the budget: no
+    // match is possible yet, and the search suspends somewhere after seed p0.
+    engine.AddPlayer(MakePlayer("p0", 1000));
+    clock->Advance(std::chrono::seconds(10));
+    for (int i = 0; i < 20000; ++i) {
+        engine.AddPlayer(MakePlayer("f" + std::to_string(i), 2000 + i % 2500));
+    }
+    for (int i = 1; i < 10; ++i) {
+        engine.AddPlayer(MakePlayer("p" + std::to_string(i), 1000 + i));
+    }
+    EXPECT_EQ(engine.Step(), 0u);
+    if (engine.GetMetricsSnapshot().queues[0].budget_exhausted == 0) {
+        GTEST_SKIP() << "the first pass finished within its budget";
+    }
+
+    // The new rules and region order start a new search, so p0 is tried as a seed again
+    // rather than skipped as one the old search already tried.
+    EngineConfig relaxed = strict;
+    relaxed.regions = {"EU", "NA"};
+    relaxed.max_allowed_mmr_diff = 100;
+    relaxed.max_relaxed_mmr_diff = 100;
+    relaxed.base_mmr_window = 100;
+    relaxed.max_mmr_window = 100;
+    ASSERT_TRUE(engine.ReloadConfig(relaxed));
+    std::vector<Match> formed;
+    ASSERT_GE(engine.Step(&formed), 1u);
+    const auto& players = formed[0].players();
+    EXPECT_TRUE(std::any_of(players.begin(), players.end(), [](const Player& p) { return p.id() == "p0"; }));
+}
+
+TEST(EngineTests, QueueSnapshotIsFilteredAndPagedFromPublishedCopy) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.queue_snapshot_interval_ms = 0;
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 9; ++i) {
+        Player p = MakePlayer("p" + std::to_string(i), 1000 + i * 100);
+        p.set_region(i % 3 == 0 ? "EU" : "NA");
+        engine.AddPlayer(p);
+        clock->Advance(std::chrono::milliseconds(1));
+    }
+
+    matchmaking::QueueSnapshot before_step;
+    engine.FillQueueSnapshot(before_step);
+    EXPECT_EQ(before_step.total_players(), 0u);
+
+    engine.Step();
+
+    QueueQuery query;
+    query.region = "NA";
+    query.min_mmr = 1100;
+    query.max_mmr = 1700;
+    query.page_size = 2;
+
+    std::vector<std::string> ids;
+    for (int page = 0; page < 10; ++page) {
+        matchmaking::QueueSnapshot snapshot;
+        engine.FillQueueSnapshot(snapshot, query);
+        if (page == 0) {
+            EXPECT_EQ(snapshot.total_players(), 9u);
+            EXPECT_EQ(snapshot.matching_players(), 5u);
+        }
+        for (const auto& player : snapshot.players()) {
+            ids.push_back(player.id());
+        }
+        if (snapshot.next_page_token().empty()) {
+            break;
+        }
+        query.page_token = snapshot.next_page_token();
+        if (page == 0) {
+            // Players leaving between pages do not shift the next page.
+            engine.RemovePlayer("p1");
+            engine.RemovePlayer("p2");
+            engine.Step();
+        }
+    }
+    EXPECT_EQ(ids, (std::vector<std::string>{"p1", "p2", "p4", "p5", "p7"}));
+}
+
+TEST(EngineTests, QueueSnapshotIsRepublishedAfterInterval) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.queue_snapshot_interval_ms = 1000;
+    Engine engine(config, clock);
+
+    engine.Step();
+    engine.AddPlayer(MakePlayer("late", 1500));
+    clock->Advance(std::chrono::milliseconds(500));
+    engine.Step();
+    EXPECT_EQ(engine.GetQueueSummary()->players.size(), 0u);
+    EXPECT_EQ(engine.GetMetricsSnapshot().version, 2u);
+
+    clock->Advance(std::chrono::milliseconds(500));
+    engine.Step();
+    EXPECT_EQ(engine.GetQueueSummary()->players.size(), 1u);
+    EXPECT_EQ(engine.GetQueueSummary()->version, 3u);
+}
+
+TEST(EngineTests, PlaylistsAreMatchedWithTheirOwnRules) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.matching_threads = 2;
+    config.queues = {{"ranked", {}}, {"duel", {{"team_size", "1"}}}};
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(engine.AddPlayer(MakePlayer("r" + std::to_string(i), 1500)));
+    }
+    for (int i = 0; i < 3; ++i) {
+        Player p = MakePlayer("d" + std::to_string(i), 1500);
+        p.set_queue_id("duel");
+        ASSERT_TRUE(engine.AddPlayer(p));
+    }
+    Player unknown = MakePlayer("x", 1500);
+    unknown.set_queue_id("arena");
+    EXPECT_FALSE(engine.AddPlayer(unknown));
+
+    std::vector<Match> formed;
+    EXPECT_EQ(engine.Step(&formed), 2u);
+    ASSERT_EQ(formed.size(), 2u);
+    EXPECT_EQ(formed[0].queue_id(), "ranked");
+    EXPECT_EQ(formed[0].players_size(), 10);
+    EXPECT_EQ(formed[1].queue_id(), "duel");
+    EXPECT_EQ(formed[1].players_size(), 2);
+
+    EngineMetrics metrics = engine.GetMetricsSnapshot();
+    ASSERT_EQ(metrics.queues.size(), 2u);
+    EXPECT_EQ(metrics.queues[1].id, "duel");
+    EXPECT_EQ(metrics.queues[1].team_size, 1);
+    EXPECT_EQ(metrics.queues[1].queue_size, 1u);
+    EXPECT_EQ(metrics.queues[1].matches, 1u);
+}
+
+TEST(EngineTests, MatchesPerTickAreCappedPerPlaylist) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.queues = {{"hot", {{"max_matches_per_tick", "1"}}}, {"cold", {}}};
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 30; ++i) {
+        engine.AddPlayer(MakePlayer("h" + std::to_string(i), 1500));
+    }
+    for (int i = 0; i < 10; ++i) {
+        Player p = MakePlayer("c" + std::to_string(i), 1500);
+        p.set_queue_id("cold");
+        engine.AddPlayer(p);
+    }
+
+    std::vector<Match> formed;
+    EXPECT_EQ(engine.Step(&formed), 2u);
+    EXPECT_EQ(engine.Step(), 1u);
+    EXPECT_EQ(engine.Step(), 1u);
+    EXPECT_EQ(engine.Step(), 0u);
+}
+
+TEST(EngineTests, DroppedPlaylistDrainsButTakesNoNewPlayers) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig config = EngineTestConfig();
+    config.queues = {{"ranked", {}}, {"event", {}}};
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        Player p = MakePlayer("e" + std::to_string(i), 1000 + i * 200);
+        p.set_queue_id("event");
+        engine.AddPlayer(p);
+    }
+    EXPECT_EQ(engine.Step(), 0u);
+
+    EngineConfig without_event = EngineTestConfig();
+    without_event.queues = {{"ranked", {}}};
+    without_event.emergency_match_wait_ms = 1000;
+    ASSERT_TRUE(engine.ReloadConfig(without_event));
+    EXPECT_EQ(engine.Step(), 0u);
+
+    Player late = MakePlayer("late", 1500);
+    late.set_queue_id("event");
+    EXPECT_FALSE(engine.AddPlayer(late));
+    EXPECT_EQ(engine.GetMetricsSnapshot().queues.size(), 2u);
+
+    // The retired playlist keeps its old rules: no emergency matching.
+    clock->Advance(std::chrono::seconds(2));
+    EXPECT_EQ(engine.Step(), 0u);
+    EXPECT_TRUE(engine.RemovePlayer("e0"));
+    for (int i = 1; i < 10; ++i) {
+        engine.RemovePlayer("e" + std::to_string(i));
+    }
+    engine.Step();
+    engine.Step();
+    EXPECT_EQ(engine.GetMetricsSnapshot().queues.size(), 1u);
+}
+
+TEST(EngineTests, AdmissionShedsOnTickLagAndPublishedRegionDepth) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig cfg = EngineTestConfig();
+    cfg.tick_interval_ms = 100;
+    cfg.admission_max_tick_lag_ms = 400;
+    cfg.admission_max_region_queue = 3;
+    Engine engine(cfg, clock);
+
+    for (int i = 0; i < 3; ++i) {
+        Player p = MakePlayer("p" + std::to_string(i), 1000);
+        ASSERT_TRUE(engine.Admit("ipv4:10.0.0.1", p).Admitted());
+        engine.AddPlayer(p);
+    }
+    // Region depth comes from the snapshot, which the next tick publishes.
+    EXPECT_TRUE(engine.Admit("ipv4:10.0.0.1", MakePlayer("p3", 1000)).Admitted());
+    engine.Step();
+    EXPECT_EQ(engine.Admit("ipv4:10.0.0.1", MakePlayer("p3", 1000)).reason, AdmissionReason::RegionQueue);
+    Player eu = MakePlayer("e0", 1000);
+    eu.set_region("EU");
+    EXPECT_TRUE(engine.Admit("ipv4:10.0.0.1", eu).Admitted());
+
+    clock->Advance(std::chrono::milliseconds(600));
+    EXPECT_EQ(engine.TickLagMs(), 500);
+    AdmissionDecision lagging = engine.Admit("ipv4:10.0.0.1", eu);
+    EXPECT_EQ(lagging.reason, AdmissionReason::TickLag);
+    EXPECT_EQ(lagging.retry_after_ms, 1000);
+
+    engine.Step();
+    EXPECT_EQ(engine.TickLagMs(), 0);
+    EXPECT_EQ(engine.GetMetricsSnapshot().admission.rejected_tick_lag, 1u);
+    EXPECT_EQ(engine.GetMetricsSnapshot().admission.rejected_region_queue, 1u);
+}
+
+TEST(EngineTests, QueueStatusReportsPositionAndEstimatedWait) {
+    auto clock = std::make_shared<ManualEngineClock>();
+    EngineConfig cfg = EngineTestConfig();
+    cfg.team_size = 2;
+    Engine engine(cfg, clock);
+
+    for (int i = 0; i < 4; ++i) {
+        engine.AddPlayer(MakePlayer("m" + std::to_string(i), 1000));
+    }
+    clock->Advance(std::chrono::seconds(20));
+    ASSERT_EQ(engine.Step(), 1u);
+
+    engine.AddPlayer(MakePlayer("a", 1000));
+    clock->Advance(std::chrono::seconds(1));
+    engine.AddPlayer(MakePlayer("b", 1000));
+    engine.AddPlayer(MakePlayer("c", 1000));
+    ASSERT_EQ(engine.Step(), 0u);
+
+    matchmaking::QueueStatus status;
+    ASSERT_TRUE(engine.GetQueueStatus("b", status));
+    EXPECT_EQ(status.region(), "NA");
+    EXPECT_EQ(status.position(), 2u);
+    EXPECT_EQ(status.queue_size(), 3u);
+    // Four players matched after 20 s; b has just arrived.
+    EXPECT_DOUBLE_EQ(status.estimated_wait_seconds(), 22.5);
+
+    clock->Advance(std::chrono::milliseconds(500));
+    ASSERT_TRUE(engine.GetQueueStatus("a", status));
+    EXPECT_EQ(status.position(), 1u);
+    EXPECT_DOUBLE_EQ(status.waited_seconds(), 1.5);
+    EXPECT_DOUBLE_EQ(status.estimated_wait_seconds(), 21.0);
+
+    EXPECT_FALSE(engine.GetQueueStatus("m0", status));
+}
+
+TEST(EngineTests, EnqueueKeepsOneResolvedPingPerDatacenterAndMatchLogIsEscaped) {
+    EngineConfig config = EngineTestConfig();
+    config.matches_path = ::testing::TempDir() + "escaped_matches.jsonl";
+    std::remove(config.matches_path.c_str());
+    auto clock = std::make_shared<ManualEngineClock>();
+    Engine engine(config, clock);
+
+    for (int i = 0; i < 10; ++i) {
+        Player p = MakePlayer("p\"" + std::to_string(i) + "\\", 1000 + i);
+        for (int j = 0; j < 100; ++j) {
+            auto* dc = p.add_pings();
+            dc->set_datacenter("X\"" + std::to_string(j));
+            dc->set_ping_ms(1);
+        }
+        auto* eu = p.add_pings();
+        eu->set_datacenter("EU");
+        eu->set_ping_ms(90);
+        auto* again = p.add_pings();
+        again->set_datacenter("EU");
+        again->set_ping_ms(5);
+        engine.AddPlayer(p);
+    }
+
+    std::vector<Match> formed;
+    ASSERT_EQ(engine.Step(&formed), 1u);
+    const Player& player = formed[0].players(0);
+    ASSERT_EQ(player.pings_size(), 3);
+    EXPECT_EQ(player.pings(0).datacenter(), "NA");
+    EXPECT_EQ(player.pings(0).ping_ms(), 40);
+    EXPECT_EQ(player.pings(1).datacenter(), "EU");
+    EXPECT_EQ(player.pings(1).ping_ms(), 90);
+    EXPECT_EQ(player.pings(2).datacenter(), "ASIA");
+
+    std::ifstream in(config.matches_path);
+    std::string line;
+    ASSERT_TRUE(std::getline(in, line));
+    ConfigValue root;
+    ConfigError error;
+    ASSERT_TRUE(ConfigParser::Parse(line, root, &error)) << error.ToString();
+    const ConfigValue* players = root.Find("players");
+    ASSERT_NE(players, nullptr);
+    ASSERT_EQ(players->Elements().size(), 10u);
+    const ConfigValue* id = players->Elements()[0].Find("id");
+    ASSERT_NE(id, nullptr);
+    EXPECT_EQ(id->AsString(), player.id());
+    const ConfigValue* pings = players->Elements()[0].Find("pings");
+    ASSERT_NE(pings, nullptr);
+    EXPECT_EQ(pings->Members().size(), 3u);
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "simulator/LoadGenerator.h"
+
+namespace {
+
+LoadOptions ScheduleOptions(ArrivalPattern pattern, int players, double rate) {
+    LoadOptions options;
+    options.pattern = pattern;
+    options.total_players = players;
+    options.rate = rate;
+    return options;
+}
+
+}  // namespace
+
+TEST(LoadGeneratorTests, ConstantScheduleIsEvenlySpaced) {
+    const auto offsets = BuildArrivalSchedule(ScheduleOptions(ArrivalPattern::Constant, 5, 100.0));
+    EXPECT_EQ(offsets, (std::vector<std::int64_t>{0, 10000, 20000, 30000, 40000}));
+    EXPECT_TRUE(BuildArrivalSchedule(ScheduleOptions(ArrivalPattern::Constant, 0, 100.0)).empty());
+}
+
+TEST(LoadGeneratorTests, PoissonScheduleIsSeededAndOffersTheRate) {
+    LoadOptions options = ScheduleOptions(ArrivalPattern::Poisson, 20000, 500.0);
+    const auto offsets = BuildArrivalSchedule(options);
+    ASSERT_EQ(offsets.size(), 20000u);
+    EXPECT_TRUE(std::is_sorted(offsets.begin(), offsets.end()));
+    // 20000 arrivals at 500/s take 40 s; the sum of exponential gaps is within a few percent.
+    EXPECT_NEAR(static_cast<double>(offsets.back()) / 1e6, 40.0, 1.2);
+
+    EXPECT_EQ(BuildArrivalSchedule(options), offsets);
+    options.seed = 2;
+    EXPECT_NE(BuildArrivalSchedule(options), offsets);
+}
+
+TEST(LoadGeneratorTests, RampScheduleClimbsFromStartRate) {
+    LoadOptions options = ScheduleOptions(ArrivalPattern::Ramp, 1000, 450.0);
+    options.ramp_start_rate = 50.0;
+    const auto offsets = BuildArrivalSchedule(options);
+    ASSERT_EQ(offsets.size(), 1000u);
+    EXPECT_TRUE(std::is_sorted(offsets.begin(), offsets.end()));
+    // A linear ramp delivers n arrivals in 2n / (r0 + r1) = 4 s.
+    EXPECT_NEAR(static_cast<double>(offsets.back()) / 1e6, 4.0, 0.01);
+    // Early gaps follow the start rate, late ones the target rate.
+    EXPECT_NEAR(static_cast<double>(offsets[1] - offsets[0]) / 1e6, 1.0 / 50.0, 0.002);
+    EXPECT_NEAR(static_cast<double>(offsets[999] - offsets[998]) / 1e6, 1.0 / 450.0, 0.0005);
+}
+
+TEST(LoadGeneratorTests, IntensityCompressesBusyPeriods) {
+    LoadOptions options = ScheduleOptions(ArrivalPattern::Constant, 101, 100.0);
+    const auto flat = BuildArrivalSchedule(options);
+    options.intensity = [](double) { return 2.0; };
+    const auto busy = BuildArrivalSchedule(options);
+    ASSERT_EQ(busy.size(), flat.size());
+    // Twice the intensity delivers the same arrivals in half the wall time.
+    EXPECT_NEAR(static_cast<double>(flat.back()) / 1e6, 1.0, 1e-9);
+    EXPECT_NEAR(static_cast<double>(busy.back()) / 1e6, 0.5, 0.011);
+}
+
+TEST(LoadGeneratorTests, ReportPrintsCountsAndPercentiles) {
+    LoadReport report;
+    report.enqueued = 100;
+    report.enqueue_timeouts = 2;
+    report.cancel_timeouts = 1;
+    for (int i = 100; i >= 1; --i) {
+        report.enqueue_latency_us.push_back(i);
+    }
+
+    std::ostringstream out;
+    report.Print(out);
+    const std::string text = out.str();
+    EXPECT_NE(text.find("enqueued=100 failed=0 timed_out=2"), std::string::npos) << text;
+    EXPECT_NE(text.find("cancel_timed_out=1"), std::string::npos) << text;
+    EXPECT_NE(text.find("enqueue_latency: n=100 p50=50us p90=90us p99=99us max=100us"), std::string::npos) << text;
+    EXPECT_NE(text.find("match_latency: n=0\n"), std::string::npos) << text;
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "common/Logger.h"
+
+namespace {
+
+class LoggerTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sink_ = std::tmpfile();
+        ASSERT_NE(sink_, nullptr);
+        Logger::Instance().SetSink(sink_);
+        Logger::Instance().SetLevel(LogLevel::Info);
+    }
+
+    void TearDown() override {
+        Logger::Instance().SetSink(stdout);
+        Logger::Instance().SetLevel(LogLevel::Info);
+        Logger::Instance().SetRateLimit(100);
+        std::fclose(sink_);
+    }
+
+    std::string Output() {
+        Logger::Instance().Flush();
+        std::string text;
+        std::rewind(sink_);
+        char buffer[512];
+        std::size_t n = 0;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), sink_)) > 0) {
+            text.append(buffer, n);
+        }
+        return text;
+    }
+
+    std::FILE* sink_ = nullptr;
+};
+
+std::size_t CountOf(const std::string& text, const std::string& needle) {
+    std::size_t count = 0;
+    for (std::size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST_F(LoggerTests, WritesOneLogfmtLinePerRecord) {
+    const std::string region = "NA";
+    MM_LOG(Info, "match_created", "region", region, "players", 10, "spread", 42.5, "error", "bad value=1",
+           "ok", true);
+
+    const std::string out = Output();
+    EXPECT_EQ(out.rfind("ts=", 0), 0u);
+    EXPECT_NE(out.find(" level=info event=match_created region=NA players=10 spread=42.5 "
+                       "error=\"bad value=1\" ok=true\n"),
+              std::string::npos)
+        << out;
+}
+
+TEST_F(LoggerTests, RecordsBelowTheRuntimeLevelAreSkipped) {
+    Logger::Instance().SetLevel(LogLevel::Warn);
+    MM_LOG(Info, "hidden");
+    MM_LOG(Warn, "shown");
+
+    const std::string out = Output();
+    EXPECT_EQ(out.find("event=hidden"), std::string::npos);
+    EXPECT_NE(out.find("level=warn event=shown"), std::string::npos);
+}
+
+TEST_F(LoggerTests, CallSitesAreRateLimitedPerSecond) {
+    Logger::Instance().SetRateLimit(3);
+    for (int i = 0; i < 10; ++i) {
+        MM_LOG(Info, "burst", "i", i);
+    }
+
+    const std::string out = Output();
+    EXPECT_EQ(CountOf(out, "event=burst"), 3u);
+    EXPECT_EQ(out.find("i=3"), std::string::npos);
+}
+
+TEST_F(LoggerTests, LongRecordsAreTruncatedWithMarker) {
+    const std::string long_value(LogRecord::kTextCapacity * 2, 'x');
+    MM_LOG(Info, "long", "value", long_value);
+
+    const std::string out = Output();
+    EXPECT_NE(out.find("event=long value=xxx"), std::string::npos);
+    EXPECT_NE(out.find("...\n"), std::string::npos);
+}
+
+TEST(LogLevelTests, ParsesLevelNames) {
+    LogLevel level = LogLevel::Info;
+    EXPECT_TRUE(ParseLogLevel("debug", level));
+    EXPECT_EQ(level, LogLevel::Debug);
+    EXPECT_TRUE(ParseLogLevel("off", level));
+    EXPECT_EQ(level, LogLevel::Off);
+    EXPECT_FALSE(ParseLogLevel("verbose", level));
+    EXPECT_EQ(level, LogLevel::Off);
+}
@@ -1,10 +1,11 @@
-#include <deque>
 #include <chrono>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "Engine/MatchBuilder.h"
-#include "Engine/PlayerEntry.h"
+#include "Engine/PlayerQueue.h"
 #include "Engine/EngineConfig.h"
 
 using matchmaking::Player;
@@ -29,10 +30,26 @@ EngineConfig DefaultTestConfig() {
     return cfg;
 }
 
+// `count` players with uniform MMR in [1000, 2000], one arriving every 50 ms up to `now`.
+PlayerQueue UniformQueue(int count, std::int64_t now) {
+    PlayerQueue queue;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> mmr(1000, 2000);
+    for (int i = 0; i < count; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(mmr(rng));
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p, now - static_cast<std::int64_t>(count - i) * 50);
+    }
+    return queue;
+}
+
 }  // namespace
 
 TEST(MatchBuilderTests, ReturnsFalseWhenQueueHasFewerThanTenPlayers) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
     Match match;
     EngineConfig config = DefaultTestConfig();
 
@@ -42,7 +59,7 @@ TEST(MatchBuilderTests, ReturnsFalseWhenQueueHasFewerThanTenPlayers) {
     p.set_ping(50);
     p.set_region("NA");
 
-    queue.emplace_back(p);
+    queue.Push(p);
 
     bool built = MatchBuilder::BuildMatch(queue, match, config, "NA");
 
@@ -51,7 +68,7 @@ TEST(MatchBuilderTests, ReturnsFalseWhenQueueHasFewerThanTenPlayers) {
 }
 
 TEST(MatchBuilderTests, BuildsMatchWhenQueueHasAtLeastTenPlayers) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
 
@@ -61,7 +78,7 @@ TEST(MatchBuilderTests, BuildsMatchWhenQueueHasAtLeastTenPlayers) {
         p.set_mmr(1000 + i);
         p.set_ping(40 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -73,14 +90,14 @@ TEST(MatchBuilderTests, BuildsMatchWhenQueueHasAtLeastTenPlayers) {
 }
 
 TEST(MatchBuilderTests, NotEnoughPlayersInsideMmrWindowDoesNotBuildMatch) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     Player seed;
     seed.set_id("seed");
     seed.set_mmr(1000);
     seed.set_ping(50);
     seed.set_region("NA");
-    queue.emplace_back(seed);
+    queue.Push(seed);
 
     for (int i = 0; i < 4; ++i) {
         Player p;
@@ -88,7 +105,7 @@ TEST(MatchBuilderTests, NotEnoughPlayersInsideMmrWindowDoesNotBuildMatch) {
         p.set_mmr(1000 + i * 10);
         p.set_ping(40 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     for (int i = 0; i < 5; ++i) {
@@ -97,7 +114,7 @@ TEST(MatchBuilderTests, NotEnoughPlayersInsideMmrWindowDoesNotBuildMatch) {
         p.set_mmr(2000 + i * 10);
         p.set_ping(80 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     EngineConfig config = DefaultTestConfig();
@@ -107,18 +124,18 @@ TEST(MatchBuilderTests, NotEnoughPlayersInsideMmrWindowDoesNotBuildMatch) {
 
     EXPECT_FALSE(built);
     EXPECT_EQ(queue.size(), 10u);
-    EXPECT_EQ(queue.front().player.id(), "seed");
+    EXPECT_EQ(queue.PlayerOf(queue.front()).id(), "seed");
 }
 
 TEST(MatchBuilderTests, MatchUsesOnlyPlayersInsideMmrWindow) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     Player seed;
     seed.set_id("seed");
     seed.set_mmr(1000);
     seed.set_ping(50);
     seed.set_region("NA");
-    queue.emplace_back(seed);
+    queue.Push(seed);
 
     for (int i = 0; i < 9; ++i) {
         Player p;
@@ -126,7 +143,7 @@ TEST(MatchBuilderTests, MatchUsesOnlyPlayersInsideMmrWindow) {
         p.set_mmr(1000 + i * 10);
         p.set_ping(40 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     for (int i = 0; i < 3; ++i) {
@@ -135,7 +152,7 @@ TEST(MatchBuilderTests, MatchUsesOnlyPlayersInsideMmrWindow) {
         p.set_mmr(2000 + i * 10);
         p.set_ping(80 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     EngineConfig config = DefaultTestConfig();
@@ -148,12 +165,12 @@ TEST(MatchBuilderTests, MatchUsesOnlyPlayersInsideMmrWindow) {
     EXPECT_EQ(queue.size(), 3u);
 
     for (int i = 0; i < 3; ++i) {
-        EXPECT_EQ(queue[i].player.id(), "far" + std::to_string(i));
+        EXPECT_EQ(queue.PlayerOf(queue[i]).id(), "far" + std::to_string(i));
     }
 }
 
 TEST(MatchBuilderTests, TeamsAreReasonablyBalancedByMmr) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     for (int i = 0; i < 10; ++i) {
         Player p;
@@ -161,7 +178,7 @@ TEST(MatchBuilderTests, TeamsAreReasonablyBalancedByMmr) {
         p.set_mmr(900 + i * 10);
         p.set_ping(40 + i);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     EngineConfig config = DefaultTestConfig();
@@ -190,7 +207,7 @@ TEST(MatchBuilderTests, TeamsAreReasonablyBalancedByMmr) {
 }
 
 TEST(MatchBuilderTests, HighPingPlayersAreExcludedWhenUnderPingLimit) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.max_ping_ms = 80;
@@ -203,7 +220,7 @@ TEST(MatchBuilderTests, HighPingPlayersAreExcludedWhenUnderPingLimit) {
         p.set_mmr(1000);
         p.set_ping(50);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     for (int i = 0; i < 5; ++i) {
@@ -212,7 +229,7 @@ TEST(MatchBuilderTests, HighPingPlayersAreExcludedWhenUnderPingLimit) {
         p.set_mmr(1000);
         p.set_ping(150);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -227,12 +244,12 @@ TEST(MatchBuilderTests, HighPingPlayersAreExcludedWhenUnderPingLimit) {
     }
 
     for (int i = 0; i < 5; ++i) {
-        EXPECT_EQ(queue[i].player.id(), "high" + std::to_string(i));
+        EXPECT_EQ(queue.PlayerOf(queue[i]).id(), "high" + std::to_string(i));
     }
 }
 
 TEST(MatchBuilderTests, NotEnoughLowPingPlayersNoMatch) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.max_ping_ms = 80;
@@ -245,7 +262,7 @@ TEST(MatchBuilderTests, NotEnoughLowPingPlayersNoMatch) {
         p.set_mmr(1000);
         p.set_ping(50);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     for (int i = 0; i < 10; ++i) {
@@ -254,7 +271,7 @@ TEST(MatchBuilderTests, NotEnoughLowPingPlayersNoMatch) {
         p.set_mmr(1000);
         p.set_ping(150);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -265,7 +282,7 @@ TEST(MatchBuilderTests, NotEnoughLowPingPlayersNoMatch) {
 }
 
 TEST(MatchBuilderTests, PingRelaxationOverTimeAllowsHighPingPlayers) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.max_ping_ms = 80;
@@ -277,7 +294,7 @@ TEST(MatchBuilderTests, PingRelaxationOverTimeAllowsHighPingPlayers) {
     seed.set_mmr(1500);
     seed.set_ping(150);
     seed.set_region("NA");
-    queue.emplace_back(seed);
+    queue.Push(seed);
 
     for (int i = 0; i < 9; ++i) {
         Player p;
@@ -285,10 +302,10 @@ TEST(MatchBuilderTests, PingRelaxationOverTimeAllowsHighPingPlayers) {
         p.set_mmr(1500);
         p.set_ping(150);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
-    queue.front().queuedAt -= std::chrono::seconds(10);
+    queue.front().queued_ms -= 10000;
 
     Match match;
     bool built = MatchBuilder::BuildMatch(queue, match, config, "NA");
@@ -303,7 +320,7 @@ TEST(MatchBuilderTests, PingRelaxationOverTimeAllowsHighPingPlayers) {
 }
 
 TEST(MatchBuilderTests, PingWindowIsCappedByMaxPingCap) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.max_ping_ms = 50;
@@ -315,7 +332,7 @@ TEST(MatchBuilderTests, PingWindowIsCappedByMaxPingCap) {
     seed.set_mmr(1500);
     seed.set_ping(100);
     seed.set_region("NA");
-    queue.emplace_back(seed);
+    queue.Push(seed);
 
     for (int i = 0; i < 4; ++i) {
         Player p;
@@ -323,7 +340,7 @@ TEST(MatchBuilderTests, PingWindowIsCappedByMaxPingCap) {
         p.set_mmr(1500);
         p.set_ping(100);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     for (int i = 0; i < 10; ++i) {
@@ -332,10 +349,10 @@ TEST(MatchBuilderTests, PingWindowIsCappedByMaxPingCap) {
         p.set_mmr(1500);
         p.set_ping(200);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
-    queue.front().queuedAt -= std::chrono::seconds(10);
+    queue.front().queued_ms -= 10000;
 
     Match match;
     bool built = MatchBuilder::BuildMatch(queue, match, config, "NA");
@@ -345,7 +362,7 @@ TEST(MatchBuilderTests, PingWindowIsCappedByMaxPingCap) {
 }
 
 TEST(MatchBuilderTests, RejectsUnbalancedMatchBeforeMinWait) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.min_wait_before_match_ms = 30000;
@@ -357,7 +374,7 @@ TEST(MatchBuilderTests, RejectsUnbalancedMatchBeforeMinWait) {
         p.set_mmr(900 + i * 10);
         p.set_ping(50);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -368,7 +385,7 @@ TEST(MatchBuilderTests, RejectsUnbalancedMatchBeforeMinWait) {
 }
 
 TEST(MatchBuilderTests, AcceptsUnbalancedMatchAfterMinWait) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.min_wait_before_match_ms = 30000;
@@ -380,10 +397,10 @@ TEST(MatchBuilderTests, AcceptsUnbalancedMatchAfterMinWait) {
         p.set_mmr(900 + i * 10);
         p.set_ping(50);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
-    queue.front().queuedAt -= std::chrono::milliseconds(31000);
+    queue.front().queued_ms -= 31000;
 
     Match match;
     bool built = MatchBuilder::BuildMatch(queue, match, config, "NA");
@@ -394,7 +411,7 @@ TEST(MatchBuilderTests, AcceptsUnbalancedMatchAfterMinWait) {
 }
 
 TEST(MatchBuilderTests, GoodRegionPingAllowsCrossRegionWithoutWait) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.good_region_ping_ms = 60;
@@ -408,7 +425,7 @@ TEST(MatchBuilderTests, GoodRegionPingAllowsCrossRegionWithoutWait) {
         p.set_ping_eu(40);
         p.set_ping_asia(200);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -420,7 +437,7 @@ TEST(MatchBuilderTests, GoodRegionPingAllowsCrossRegionWithoutWait) {
 }
 
 TEST(MatchBuilderTests, CrossRegionRequiresWaitBeforeAllow) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
     config.good_region_ping_ms = 50;
@@ -434,7 +451,7 @@ TEST(MatchBuilderTests, CrossRegionRequiresWaitBeforeAllow) {
         p.set_ping_eu(80);
         p.set_ping_asia(200);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -444,7 +461,7 @@ TEST(MatchBuilderTests, CrossRegionRequiresWaitBeforeAllow) {
     EXPECT_EQ(queue.size(), 10u);
 
     for (auto& entry : queue) {
-        entry.queuedAt -= std::chrono::seconds(21);
+        entry.queued_ms -= 21000;
     }
 
     Match match_after_wait;
@@ -455,8 +472,124 @@ TEST(MatchBuilderTests, CrossRegionRequiresWaitBeforeAllow) {
     EXPECT_TRUE(queue.empty());
 }
 
+TEST(MatchBuilderTests, ConfiguredDatacentersReplaceTheFixedRegions) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.regions = {"IAD", "ORD", "SJC", "GRU", "FRA", "AMS", "SIN", "NRT", "SYD"};
+    config.good_region_ping_ms = 50;
+    config.cross_region_step_ms = 20000;
+
+    for (int i = 0; i < 10; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(1500);
+        p.set_ping(250);
+        p.set_region("EU");
+        auto* fra = p.add_pings();
+        fra->set_datacenter("FRA");
+        fra->set_ping_ms(20);
+        auto* ams = p.add_pings();
+        ams->set_datacenter("AMS");
+        ams->set_ping_ms(70);
+        queue.Push(p);
+    }
+
+    Match match;
+    EXPECT_FALSE(MatchBuilder::BuildMatch(queue, match, config, "NA"));
+    EXPECT_FALSE(MatchBuilder::BuildMatch(queue, match, config, "AMS"));
+    ASSERT_TRUE(MatchBuilder::BuildMatch(queue, match, config, "FRA"));
+    EXPECT_EQ(match.players_size(), 10);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MatchBuilderTests, MatchRecordsTheDatacenterWithTheLowestWorstPing) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.good_region_ping_ms = 100;
+
+    for (int i = 0; i < 10; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(1500);
+        p.set_ping(200);
+        p.set_region("EU");
+        p.set_ping_na(i < 5 ? 50 : 60);
+        p.set_ping_eu(i < 9 ? 30 : 75);
+        queue.Push(p);
+    }
+
+    Match match;
+    PlayerQueue copy = queue;
+    ASSERT_TRUE(MatchBuilder::BuildMatch(copy, match, config, "EU"));
+    EXPECT_EQ(match.datacenter(), "NA");
+    EXPECT_EQ(match.datacenter_ping_ms(), 60);
+
+    config.datacenter_objective = "p90";
+    match.Clear();
+    ASSERT_TRUE(MatchBuilder::BuildMatch(queue, match, config, "NA"));
+    EXPECT_EQ(match.datacenter(), "EU");
+    EXPECT_EQ(match.datacenter_ping_ms(), 30);
+}
+
+TEST(MatchBuilderTests, TeamSizeSetsThePlayersPerMatch) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.team_size = 3;
+
+    for (int i = 0; i < 7; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(1500 + i);
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p);
+    }
+
+    Match match;
+    ASSERT_TRUE(MatchBuilder::BuildMatch(queue, match, config, "NA"));
+    EXPECT_EQ(match.players_size(), 6);
+    EXPECT_EQ(queue.size(), 1u);
+    EXPECT_FALSE(MatchBuilder::BuildMatch(queue, match, config, "NA"));
+}
+
+TEST(MatchBuilderTests, SearchPastItsDeadlineResumesAtTheNextSeed) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    EngineSettings settings(config);
+    const std::int64_t now = 600000;
+
+    // p0 waited longest but has no opponents near its MMR.
+    for (int i = 0; i <= 10; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(i == 0 ? 5000 : 1500);
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p, now - (20 - i) * 1000);
+    }
+
+    MatchSearch search;
+    search.deadline = std::chrono::steady_clock::time_point::min();
+    Match match;
+    EXPECT_FALSE(MatchBuilder::BuildMatch(queue, match, settings, "NA", now, nullptr, nullptr, nullptr, &search));
+    EXPECT_TRUE(search.out_of_time);
+    ASSERT_TRUE(search.suspended);
+    EXPECT_EQ(search.resume_id, "p1");
+
+    // The next call skips p0 and still forms the match its first seed finds.
+    EXPECT_TRUE(MatchBuilder::BuildMatch(queue, match, settings, "NA", now, nullptr, nullptr, nullptr, &search));
+    EXPECT_EQ(match.players_size(), 10);
+    EXPECT_EQ(search.resume_id, "p2");
+    ASSERT_EQ(queue.size(), 1u);
+    EXPECT_EQ(queue.PlayerOf(queue.front()).id(), "p0");
+}
+
 TEST(MatchBuilderTests, MetricsAreComputedForBuiltMatch) {
-    std::deque<PlayerEntry> queue;
+    PlayerQueue queue;
 
     EngineConfig config = DefaultTestConfig();
 
@@ -466,7 +599,7 @@ TEST(MatchBuilderTests, MetricsAreComputedForBuiltMatch) {
         p.set_mmr(1000 + i * 10);
         p.set_ping(40);
         p.set_region("NA");
-        queue.emplace_back(p);
+        queue.Push(p);
     }
 
     Match match;
@@ -482,3 +615,166 @@ TEST(MatchBuilderTests, MetricsAreComputedForBuiltMatch) {
     EXPECT_EQ(metrics.max_mmr, 1090);
     EXPECT_GE(metrics.average_wait_ms, 0.0);
 }
+
+TEST(MatchBuilderTests, LongestWaitingGroupIsMatchedWithoutScanningFreshSeeds) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.mmr_relax_per_second = 0;
+
+    for (int i = 0; i < 200; ++i) {
+        Player p;
+        p.set_id("fresh" + std::to_string(i));
+        p.set_mmr(2000 + (i % 20));
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p);
+    }
+    for (int i = 0; i < 10; ++i) {
+        Player p;
+        p.set_id("waiting" + std::to_string(i));
+        p.set_mmr(1000 + i);
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p);
+        queue.back().queued_ms -= 30000;
+    }
+
+    Match match;
+    MatchMetrics metrics;
+    bool built = MatchBuilder::BuildMatch(queue, match, config, "NA", &metrics);
+
+    ASSERT_TRUE(built);
+    for (const auto& player : match.players()) {
+        EXPECT_EQ(player.id().rfind("waiting", 0), 0u);
+    }
+    EXPECT_EQ(queue.size(), 200u);
+    EXPECT_LT(metrics.seeds_evaluated, 20u);
+}
+
+TEST(MatchBuilderTests, SparseMmrSeedsAreSkippedWithoutScan) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.mmr_relax_per_second = 0;
+
+    const std::int64_t now = 600000;
+    for (int i = 0; i < 9; ++i) {
+        Player p;
+        p.set_id("high" + std::to_string(i));
+        p.set_mmr(3000 + i);
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p, now - 60000);
+    }
+    for (int i = 0; i < 10; ++i) {
+        Player p;
+        p.set_id("p" + std::to_string(i));
+        p.set_mmr(1000 + i);
+        p.set_ping(40);
+        p.set_region("NA");
+        queue.Push(p, now);
+    }
+
+    Match match;
+    MatchMetrics metrics;
+    bool built = MatchBuilder::BuildMatch(queue, match, config, "NA", now, &metrics);
+
+    ASSERT_TRUE(built);
+    EXPECT_EQ(queue.size(), 9u);
+    // The ten low seeds all form the same match, which counts once.
+    EXPECT_EQ(metrics.seeds_evaluated, 1u);
+}
+
+TEST(MatchBuilderTests, EmergencyStageTakesTightestWindowOfLongWaitersInAnyRegion) {
+    PlayerQueue queue;
+
+    EngineConfig config = DefaultTestConfig();
+    config.emergency_match_wait_ms = 60000;
+
+    const std::int64_t now = 600000;
+    auto add = [&](const std::string& id, int mmr, std::chrono::seconds waited) {
+        Player p;
+        p.set_id(id);
+        p.set_mmr(mmr);
+        p.set_ping(300);
+        p.set_ping_na(300);
+        p.set_ping_eu(40);
+        p.set_ping_asia(300);
+        p.set_region("EU");
+        queue.Push(p, now - waited.count() * 1000);
+    };
+
+    // Twelve long-waiters whose MMRs are too far apart for a regular match.
+    add("outlier_low", 0, std::chrono::seconds(120));
+    for (int i = 0; i < 10; ++i) {
+        add("w" + std::to_string(i), 1000 + i * 200, std::chrono::seconds(100 - i));
+    }
+    add("outlier_high", 5000, std::chrono::seconds(80));
+    add("fresh", 1500, std::chrono::seconds(0));
+
+    Match match;
+    MatchMetrics metrics;
+    bool built = MatchBuilder::BuildMatch(queue, match, config, "EU", now, &metrics);
+
+    ASSERT_TRUE(built);
+    EXPECT_EQ(match.players_size(), 10);
+    for (const auto& player : match.players()) {
+        EXPECT_EQ(player.id()[0], 'w');
+    }
+    EXPECT_EQ(metrics.min_mmr, 1000);
+    EXPECT_EQ(metrics.max_mmr, 2800);
+    EXPECT_EQ(queue.size(), 3u);
+}
+
+TEST(MatchBuilderTests, UniformMmrQueueEvaluatesFewSeeds) {
+    EngineConfig config = DefaultTestConfig();
+    EngineSettings settings(config);
+    const std::int64_t now = 600000;
+
+    for (int count : {1000, 2000}) {
+        PlayerQueue queue = UniformQueue(count, now);
+        Match match;
+        MatchMetrics metrics;
+        ASSERT_TRUE(MatchBuilder::BuildMatch(queue, match, settings, "NA", now, &metrics));
+        EXPECT_LT(metrics.seeds_evaluated, static_cast<std::size_t>(count) / 100) << count << " players";
+    }
+}
+
+TEST(MatchBuilderTests, ReusedPassFormsTheSameMatchesAsFreshCalls) {
+    EngineConfig config = DefaultTestConfig();
+    EngineSettings settings(config);
+    const std::int64_t now = 600000;
+    PlayerQueue fresh = UniformQueue(500, now);
+    PlayerQueue reused = fresh;
+
+    MatchPass pass;
+    for (int i = 0; i < 20; ++i) {
+        Match expected;
+        Match actual;
+        const bool built = MatchBuilder::BuildMatch(fresh, expected, settings, "NA", now);
+        ASSERT_EQ(MatchBuilder::BuildMatch(reused, actual, settings, "NA", now, nullptr, nullptr, nullptr, nullptr, &pass),
+                  built);
+        if (!built) {
+            break;
+        }
+        ASSERT_EQ(actual.players_size(), expected.players_size());
+        for (int p = 0; p < expected.players_size(); ++p) {
+            EXPECT_EQ(actual.players(p).id(), expected.players(p).id());
+        }
+    }
+    EXPECT_EQ(reused.size(), fresh.size());
+    EXPECT_EQ(pass.wait_ms.size(), reused.size());
+
+    // A player joining mid-pass invalidates it rather than being missed.
+    Player late;
+    late.set_id("late");
+    late.set_mmr(1500);
+    late.set_ping(40);
+    late.set_region("NA");
+    reused.Push(late, now);
+    Match match;
+    MatchBuilder::BuildMatch(reused, match, settings, "NA", now, nullptr, nullptr, nullptr, nullptr, &pass);
+    EXPECT_EQ(pass.queue_version, reused.Version());
+    EXPECT_EQ(pass.wait_ms.size(), reused.size());
+}
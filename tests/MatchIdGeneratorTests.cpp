@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/MatchIdGenerator.h"
+
+TEST(MatchIdGeneratorTests, IdsAreUniqueAndIncreasingAcrossThreads) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    MatchIdGenerator generator(7);
+
+    std::vector<std::vector<std::uint64_t>> issued(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            issued[t].reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                issued[t].push_back(generator.Next());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<std::uint64_t> seen;
+    for (const auto& ids : issued) {
+        EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+        for (std::uint64_t id : ids) {
+            EXPECT_EQ(MatchIdGenerator::NodeOf(id), 7);
+            seen.insert(id);
+        }
+    }
+    EXPECT_EQ(seen.size(), static_cast<std::size_t>(kThreads * kPerThread));
+}
+
+TEST(MatchIdGeneratorTests, NodesDoNotCollide) {
+    MatchIdGenerator a(1);
+    MatchIdGenerator b(2);
+    std::unordered_set<std::uint64_t> seen;
+    for (int i = 0; i < 5000; ++i) {
+        seen.insert(a.Next());
+        seen.insert(b.Next());
+    }
+    EXPECT_EQ(seen.size(), 10000u);
+}
+
+TEST(MatchIdGeneratorTests, EncodingIsFixedWidthOrderedAndReversible) {
+    MatchIdGenerator generator(MatchIdGenerator::kMaxNode);
+    const std::uint64_t first = generator.Next();
+    const std::uint64_t second = generator.Next();
+
+    auto a = MatchIdGenerator::Encode(first);
+    auto b = MatchIdGenerator::Encode(second);
+    const std::string text_a(a.data(), a.size());
+    const std::string text_b(b.data(), b.size());
+    EXPECT_EQ(text_a.size(), MatchIdGenerator::kEncodedLength);
+    EXPECT_LT(text_a, text_b);
+
+    std::uint64_t decoded = 0;
+    ASSERT_TRUE(MatchIdGenerator::Decode(text_a, decoded));
+    EXPECT_EQ(decoded, first);
+    EXPECT_EQ(MatchIdGenerator::NodeOf(decoded), MatchIdGenerator::kMaxNode);
+    EXPECT_GE(MatchIdGenerator::TimestampMsOf(decoded), MatchIdGenerator::kEpochMs);
+
+    auto max = MatchIdGenerator::Encode(~std::uint64_t{0});
+    ASSERT_TRUE(MatchIdGenerator::Decode(std::string(max.data(), max.size()), decoded));
+    EXPECT_EQ(decoded, ~std::uint64_t{0});
+
+    EXPECT_FALSE(MatchIdGenerator::Decode("short", decoded));
+    EXPECT_FALSE(MatchIdGenerator::Decode("ZZZZZZZZZZZZZ", decoded));
+    EXPECT_FALSE(MatchIdGenerator::Decode("0000000000U00", decoded));
+}
@@ -0,0 +1,112 @@
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "tools/MatchLogReader.h"
+
+namespace {
+
+std::string MakeRecord(int index, int base_mmr, const std::string& region, std::int64_t created_at_ms) {
+    std::string line = "{\"match_id\":\"m" + std::to_string(index) + "\",\"created_at_ms\":" +
+                       std::to_string(created_at_ms) + ",\"players\":[";
+    for (int i = 0; i < 4; ++i) {
+        if (i > 0) {
+            line += ",";
+        }
+        line += "{\"id\":\"p" + std::to_string(index) + "_" + std::to_string(i) + "\",\"mmr\":" +
+                std::to_string(base_mmr + i * 10) + ",\"region\":\"" + (i < 3 ? region : std::string("NA")) +
+                "\"}";
+    }
+    return line + "]}";
+}
+
+}  // namespace
+
+TEST(MatchLogReaderTests, ScanRecordExtractsPlayersSpreadRegionsAndMinute) {
+    MatchLogStats stats;
+    ASSERT_TRUE(MatchLogReader::ScanRecord(MakeRecord(1, 1000, "EU", 180000), stats));
+
+    EXPECT_EQ(stats.matches, 1u);
+    EXPECT_EQ(stats.players, 4u);
+    EXPECT_EQ(stats.spread_max, 30);
+    EXPECT_EQ(stats.spread_sum, 30u);
+    EXPECT_EQ(stats.spread_histogram[0], 1u);
+    EXPECT_EQ(stats.players_per_region.at("EU"), 3u);
+    EXPECT_EQ(stats.players_per_region.at("NA"), 1u);
+    EXPECT_EQ(stats.matches_per_majority_region.at("EU"), 1u);
+    EXPECT_EQ(stats.matches_per_minute.at(3), 1u);
+    EXPECT_EQ(stats.malformed_records, 0u);
+}
+
+TEST(MatchLogReaderTests, MalformedAndTruncatedRecordsAreRejected) {
+    const std::string full = MakeRecord(1, 1000, "EU", 0);
+    const std::string_view lines[] = {
+        "not json",
+        "[1,2,3]",
+        "{\"players\":[]}",
+        "{\"players\":[{\"id\":\"a\",\"mmr\":x}]}",
+        "{\"players\":[{\"id\":\"a\",\"mmr\":",
+        "{\"players\":[{\"id\":\"unterminated,\"mmr\":5}]}",
+        // Whole players before the cut, but the record never closes.
+        std::string_view(full).substr(0, full.find("p1_2")),
+        std::string_view(full).substr(0, full.size() - 2),
+    };
+    for (std::string_view line : lines) {
+        MatchLogStats stats;
+        EXPECT_FALSE(MatchLogReader::ScanRecord(line, stats)) << line;
+        EXPECT_EQ(stats.matches, 0u) << line;
+    }
+
+    MatchLogStats stats;
+    EXPECT_TRUE(MatchLogReader::ScanRecord(full + " \r", stats));
+}
+
+TEST(MatchLogReaderTests, EscapedQuotesInIdsDoNotEndTheString) {
+    MatchLogStats stats;
+    // The first id holds an escaped quote followed by text that looks like a region
+    // member; the second ends in an escaped backslash.
+    const std::string line =
+        R"({"match_id":"m","players":[{"id":"a\",\"region\":\"FAKE","mmr":1000,"region":"EU"},)"
+        R"({"id":"b\\","mmr":1200,"region":"EU"}]})";
+    ASSERT_TRUE(MatchLogReader::ScanRecord(line, stats));
+    EXPECT_EQ(stats.players, 2u);
+    EXPECT_EQ(stats.spread_max, 200);
+    EXPECT_EQ(stats.players_per_region.size(), 1u);
+    EXPECT_EQ(stats.players_per_region.at("EU"), 2u);
+}
+
+TEST(MatchLogReaderTests, ParallelScanMatchesSerialScanAcrossMidLineChunkBoundaries) {
+    std::string data;
+    int records = 0;
+    int garbage = 0;
+    // Just over 3 MiB: ScanParallel cuts it into three chunks.
+    while (data.size() < (3u << 20) + 4096) {
+        data += MakeRecord(records, 1000 + (records % 40) * 25, records % 3 == 0 ? "EU" : "ASIA",
+                           static_cast<std::int64_t>(records) * 1000);
+        data += "\n";
+        if (records % 1000 == 0) {
+            data += "garbage line\n";
+            ++garbage;
+        }
+        ++records;
+    }
+    data += MakeRecord(records++, 1500, "EU", 0);  // no trailing newline
+    for (std::size_t i = 1; i < 3; ++i) {
+        const std::size_t cut = data.size() * i / 3;
+        ASSERT_NE(data[cut - 1], '\n') << "chunk " << i << " should start mid-line";
+    }
+
+    const MatchLogStats serial = MatchLogReader::ScanParallel(data, 1);
+    const MatchLogStats parallel = MatchLogReader::ScanParallel(data, 3);
+
+    EXPECT_EQ(serial.matches, static_cast<std::uint64_t>(records));
+    EXPECT_EQ(serial.malformed_records, static_cast<std::uint64_t>(garbage));
+    EXPECT_EQ(parallel.matches, serial.matches);
+    EXPECT_EQ(parallel.players, serial.players);
+    EXPECT_EQ(parallel.malformed_records, serial.malformed_records);
+    EXPECT_EQ(parallel.spread_histogram, serial.spread_histogram);
+    EXPECT_EQ(parallel.players_per_region, serial.players_per_region);
+    EXPECT_EQ(parallel.matches_per_majority_region, serial.matches_per_majority_region);
+    EXPECT_EQ(parallel.matches_per_minute, serial.matches_per_minute);
+}
@@ -0,0 +1,82 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/MatchPipeline.h"
+
+namespace {
+
+FormedMatch MakeFormed(int i) {
+    FormedMatch formed;
+    formed.match.set_match_id("m" + std::to_string(i));
+    formed.region = "NA";
+    return formed;
+}
+
+}  // namespace
+
+TEST(MatchPipelineTests, StagesRunInlineBeforeStart) {
+    std::vector<std::string> events;
+    MatchPipeline pipeline(
+        [&](FormedMatch& m) {
+            m.handle = std::make_shared<const PendingMatch>(std::move(m.match));
+            events.push_back("deliver " + m.handle->match.match_id());
+        },
+        [&](FormedMatch& m) { events.push_back("persist " + m.handle->match.match_id()); }, 8);
+
+    pipeline.Push(MakeFormed(1));
+    EXPECT_EQ(events, (std::vector<std::string>{"deliver m1", "persist m1"}));
+    pipeline.Flush();
+}
+
+TEST(MatchPipelineTests, StartedStagesRunInOrderOnTheirOwnThreads) {
+    constexpr int kMatches = 5000;
+    std::vector<std::string> delivered;
+    std::vector<std::string> persisted;
+    std::thread::id delivery_thread;
+    std::thread::id persistence_thread;
+    MatchPipeline pipeline(
+        [&](FormedMatch& m) {
+            delivery_thread = std::this_thread::get_id();
+            m.handle = std::make_shared<const PendingMatch>(std::move(m.match));
+            delivered.push_back(m.handle->match.match_id());
+        },
+        [&](FormedMatch& m) {
+            persistence_thread = std::this_thread::get_id();
+            persisted.push_back(m.handle->match.match_id());
+        },
+        // Smaller than the batch, so the producer also waits on a full ring.
+        64);
+
+    pipeline.Start();
+    for (int i = 0; i < kMatches; ++i) {
+        pipeline.Push(MakeFormed(i));
+    }
+    pipeline.Flush();
+
+    ASSERT_EQ(persisted.size(), static_cast<std::size_t>(kMatches));
+    for (int i = 0; i < kMatches; ++i) {
+        EXPECT_EQ(persisted[static_cast<std::size_t>(i)], "m" + std::to_string(i));
+    }
+    EXPECT_EQ(delivered, persisted);
+    EXPECT_NE(delivery_thread, std::this_thread::get_id());
+    EXPECT_NE(persistence_thread, std::this_thread::get_id());
+    EXPECT_NE(delivery_thread, persistence_thread);
+    pipeline.Stop();
+}
+
+TEST(MatchPipelineTests, StopFinishesEveryPushedMatch) {
+    std::size_t persisted = 0;
+    MatchPipeline pipeline([](FormedMatch&) {}, [&](FormedMatch&) { ++persisted; }, 16);
+    pipeline.Start();
+    for (int i = 0; i < 100; ++i) {
+        pipeline.Push(MakeFormed(i));
+    }
+    pipeline.Stop();
+    EXPECT_EQ(persisted, 100u);
+
+    pipeline.Push(MakeFormed(100));
+    EXPECT_EQ(persisted, 101u);
+}
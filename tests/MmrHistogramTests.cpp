@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "Engine/MmrHistogram.h"
+
+TEST(MmrHistogramTests, CountsPlayersInsideRangeAtBucketGranularity) {
+    MmrHistogram histogram;
+    histogram.Add(1000);
+    histogram.Add(1010);
+    histogram.Add(1030);
+    histogram.Add(2000);
+
+    EXPECT_EQ(histogram.Total(), 4u);
+    EXPECT_EQ(histogram.CountInRange(1000, 1024), 2u);
+    // 1030 shares a bucket with 1049, so it is counted for a range ending at 1026.
+    EXPECT_EQ(histogram.CountInRange(1000, 1026), 3u);
+    EXPECT_EQ(histogram.CountInRange(0, MmrHistogram::kMaxMmr), 4u);
+    EXPECT_EQ(histogram.CountInRange(1100, 1900), 0u);
+    EXPECT_EQ(histogram.CountInRange(1200, 1100), 0u);
+}
+
+TEST(MmrHistogramTests, RemovalsAreReflectedAfterEarlierQueries) {
+    MmrHistogram histogram;
+    for (int i = 0; i < 10; ++i) {
+        histogram.Add(1500 + i);
+    }
+    EXPECT_EQ(histogram.CountInRange(1400, 1600), 10u);
+
+    histogram.Remove(1505);
+    EXPECT_EQ(histogram.CountInRange(1400, 1600), 9u);
+
+    histogram.Remove(3000);
+    EXPECT_EQ(histogram.Total(), 9u);
+}
+
+TEST(MmrHistogramTests, OutOfRangeMmrsAreClampedIntoEdgeBuckets) {
+    MmrHistogram histogram;
+    histogram.Add(-50);
+    histogram.Add(MmrHistogram::kMaxMmr + 500);
+
+    EXPECT_EQ(histogram.CountInRange(-100, -10), 1u);
+    EXPECT_EQ(histogram.CountInRange(MmrHistogram::kMaxMmr + 1, MmrHistogram::kMaxMmr + 900), 1u);
+}
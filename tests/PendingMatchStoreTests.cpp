@@ -0,0 +1,106 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Engine/PendingMatchStore.h"
+
+using matchmaking::Match;
+
+namespace {
+
+PendingMatchStore::MatchHandle MakeMatch(const std::string& id, int first_player, int players = 10) {
+    Match match;
+    match.set_match_id(id);
+    for (int i = 0; i < players; ++i) {
+        auto* p = match.add_players();
+        p->set_id("p" + std::to_string(first_player + i));
+        p->set_mmr(1500);
+    }
+    return std::make_shared<const PendingMatch>(std::move(match));
+}
+
+}  // namespace
+
+TEST(PendingMatchStoreTests, MatchIsStoredOnceAndFreedAfterLastAcknowledgement) {
+    PendingMatchStore store(std::chrono::seconds(60), 1 << 20);
+    const auto t0 = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+    store.Add(MakeMatch("m1", 0), t0);
+
+    auto a = store.Peek("p0");
+    auto b = store.Peek("p9");
+    ASSERT_EQ(a.size(), 1u);
+    ASSERT_EQ(b.size(), 1u);
+    EXPECT_EQ(a[0].get(), b[0].get());
+    Match decoded;
+    ASSERT_TRUE(decoded.ParseFromString(a[0]->wire));
+    EXPECT_EQ(decoded.match_id(), "m1");
+    EXPECT_EQ(decoded.players_size(), 10);
+    EXPECT_EQ(store.Stats().matches, 1u);
+    EXPECT_EQ(store.Stats().deliveries, 10u);
+
+    EXPECT_TRUE(store.Acknowledge("p0", "m1"));
+    EXPECT_FALSE(store.Acknowledge("p0", "m1"));
+    EXPECT_TRUE(store.Peek("p0").empty());
+    EXPECT_EQ(store.Stats().deliveries, 9u);
+
+    for (int i = 1; i < 10; ++i) {
+        EXPECT_EQ(store.Take("p" + std::to_string(i)).size(), 1u);
+    }
+    EXPECT_EQ(store.Stats().matches, 0u);
+    EXPECT_EQ(store.Stats().bytes, 0u);
+}
+
+TEST(PendingMatchStoreTests, UndeliveredMatchesExpireAfterTtl) {
+    PendingMatchStore store(std::chrono::seconds(5), 1 << 20);
+    const auto t0 = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+    store.Add(MakeMatch("m1", 0), t0);
+    store.Add(MakeMatch("m2", 10), t0 + std::chrono::seconds(3));
+
+    store.Expire(t0 + std::chrono::seconds(4));
+    EXPECT_EQ(store.Stats().matches, 2u);
+
+    store.Expire(t0 + std::chrono::seconds(6));
+    EXPECT_TRUE(store.Peek("p0").empty());
+    EXPECT_EQ(store.Peek("p10").size(), 1u);
+    EXPECT_EQ(store.Stats().expired, 1u);
+
+    // Well past a full turn of the wheel.
+    store.Expire(t0 + std::chrono::minutes(10));
+    EXPECT_EQ(store.Stats().matches, 0u);
+    EXPECT_EQ(store.Stats().deliveries, 0u);
+    EXPECT_EQ(store.Stats().expired, 2u);
+}
+
+TEST(PendingMatchStoreTests, LongTtlSurvivesWheelRounds) {
+    PendingMatchStore store(std::chrono::minutes(10), 1 << 20);
+    const auto t0 = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+    store.Add(MakeMatch("m1", 0), t0);
+
+    for (int s = 1; s < 600; s += 7) {
+        store.Expire(t0 + std::chrono::seconds(s));
+    }
+    EXPECT_EQ(store.Peek("p0").size(), 1u);
+
+    store.Expire(t0 + std::chrono::seconds(601));
+    EXPECT_TRUE(store.Peek("p0").empty());
+}
+
+TEST(PendingMatchStoreTests, OldestMatchesAreEvictedOverMemoryBudget) {
+    PendingMatchStore store(std::chrono::minutes(10), 1 << 20);
+    const auto t0 = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+    store.Add(MakeMatch("m0", 100), t0);
+    const std::size_t one_match = store.Stats().bytes;
+
+    store.SetLimits(std::chrono::minutes(10), one_match * 3);
+    for (int i = 1; i < 5; ++i) {
+        store.Add(MakeMatch("m" + std::to_string(i), 100 + i * 10), t0);
+    }
+
+    EXPECT_EQ(store.Stats().matches, 3u);
+    EXPECT_EQ(store.Stats().evicted_for_memory, 2u);
+    EXPECT_TRUE(store.Peek("p100").empty());
+    EXPECT_TRUE(store.Peek("p110").empty());
+    EXPECT_EQ(store.Peek("p140").size(), 1u);
+}
@@ -0,0 +1,78 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Engine/PlayerQueue.h"
+#include "Engine/RegionTable.h"
+
+using matchmaking::Player;
+
+namespace {
+
+Player MakePlayer(const std::string& id, int mmr, const std::string& region = "EU") {
+    Player p;
+    p.set_id(id);
+    p.set_mmr(mmr);
+    p.set_region(region);
+    p.set_ping(40);
+    return p;
+}
+
+}  // namespace
+
+TEST(PlayerQueueTests, RemoveIfKeepsOrderAndReusesHandles) {
+    PlayerQueue queue;
+    for (int i = 0; i < 5; ++i) {
+        queue.Push(MakePlayer("p" + std::to_string(i), 1000 + i));
+    }
+    EXPECT_EQ(queue[3].mmr, 1003);
+
+    const std::uint32_t freed_a = queue[1].handle;
+    const std::uint32_t freed_b = queue[3].handle;
+    EXPECT_EQ(queue.RemoveIf([](const PlayerEntry& e) { return e.mmr == 1001 || e.mmr == 1003; }), 2u);
+    ASSERT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.PlayerOf(queue[0]).id(), "p0");
+    EXPECT_EQ(queue.PlayerOf(queue[1]).id(), "p2");
+    EXPECT_EQ(queue.PlayerOf(queue[2]).id(), "p4");
+
+    // Freed handles are handed out again rather than growing the side table.
+    const PlayerEntry& added = queue.Push(MakePlayer("p5", 1005));
+    EXPECT_TRUE(added.handle == freed_a || added.handle == freed_b);
+    EXPECT_EQ(queue.PlayerOf(queue.back()).id(), "p5");
+    EXPECT_EQ(queue.back().mmr, 1005);
+}
+
+TEST(PlayerQueueTests, ResolvesPingsAndHomeRegionPerTable) {
+    PlayerQueue queue;
+    PlayerEntry& eu = queue.Push(MakePlayer("eu", 1500, "EU"));
+    queue.Push(MakePlayer("mars", 1500, "MARS"));
+
+    RegionTable table({"NA", "EU"});
+    queue.ResolvePings(queue[0], table);
+    queue.ResolvePings(queue[1], table);
+    EXPECT_EQ(eu.region, 1);
+    EXPECT_EQ(queue.PingsOf(eu).ping[1], 40);
+    EXPECT_EQ(queue[1].region, PlayerEntry::kNoRegion);
+
+    RegionTable reordered({"EU", "NA"});
+    queue.ResolvePings(queue[0], reordered);
+    EXPECT_EQ(queue[0].region, 0);
+    EXPECT_EQ(queue.PingsOf(queue[0]).ping[0], 40);
+}
+
+TEST(PlayerQueueTests, CopiesAreIndependent) {
+    PlayerQueue queue;
+    const std::int64_t queued_ms = 5000;
+    queue.Push(MakePlayer("a", 1000), queued_ms);
+    queue.Push(MakePlayer("b", 1100), queued_ms);
+
+    PlayerQueue copy = queue;
+    copy.RemoveIf([](const PlayerEntry&) { return true; });
+    copy.Push(MakePlayer("c", 1200));
+
+    ASSERT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.front().queued_ms, queued_ms);
+    EXPECT_EQ(queue.PlayerOf(queue[0]).id(), "a");
+    EXPECT_EQ(queue.PlayerOf(queue[1]).id(), "b");
+    EXPECT_EQ(copy.PlayerOf(copy.front()).id(), "c");
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common/ConfigParser.h"
+#include "simulator/PopulationModel.h"
+
+namespace {
+
+bool ParsePopulation(const std::string& json, PopulationConfig& out, ConfigError* error = nullptr) {
+    ConfigValue root;
+    return ConfigParser::Parse(json, root, error) && ReadPopulationConfig(root, out, error);
+}
+
+}  // namespace
+
+TEST(PopulationModelTests, DefaultsDrawUniformSoloPlayersThatNeverCancel) {
+    PopulationModel model(PopulationConfig(), 1);
+    EXPECT_DOUBLE_EQ(model.Intensity(0.0), 1.0);
+    EXPECT_DOUBLE_EQ(model.Intensity(43200.0), 1.0);
+
+    std::map<std::string, int> regions;
+    for (int i = 0; i < 3000; ++i) {
+        const auto arrival = model.MakeArrival(i, 0.0, "p");
+        ASSERT_EQ(arrival.size(), 1u);
+        const auto& player = arrival[0].player;
+        EXPECT_EQ(player.id(), "p" + std::to_string(i));
+        EXPECT_GE(player.mmr(), 800);
+        EXPECT_LE(player.mmr(), 2400);
+        EXPECT_EQ(arrival[0].cancel_after_ms, 0);
+        ASSERT_EQ(player.pings_size(), 3);
+        // The home datacenter has the player's base ping; the others are further away.
+        for (const auto& dc : player.pings()) {
+            if (dc.datacenter() == player.region()) {
+                EXPECT_EQ(dc.ping_ms(), player.ping());
+            } else {
+                EXPECT_GT(dc.ping_ms(), player.ping());
+            }
+        }
+        ++regions[player.region()];
+    }
+    ASSERT_EQ(regions.size(), 3u);
+    for (const auto& [region, count] : regions) {
+        EXPECT_NEAR(count, 1000, 150) << region;
+    }
+}
+
+TEST(PopulationModelTests, NormalModelAndParetoTail) {
+    PopulationConfig config;
+    config.mmr_model = MmrModel::Normal;
+    config.mmr_min = 0;
+    config.mmr_max = 3000;
+    PopulationModel normal(config, 2);
+    double sum = 0.0;
+    for (int i = 0; i < 4000; ++i) {
+        sum += normal.MakeArrival(i, 0.0, "n")[0].player.mmr();
+    }
+    EXPECT_NEAR(sum / 4000.0, config.mmr_mean, 20.0);
+
+    PopulationConfig tailed;
+    tailed.mmr_min = 800;
+    tailed.mmr_max = 1200;
+    tailed.tail_fraction = 0.1;
+    PopulationModel tail(tailed, 3);
+    int scarce = 0;
+    for (int i = 0; i < 4000; ++i) {
+        const int mmr = tail.MakeArrival(i, 0.0, "t")[0].player.mmr();
+        EXPECT_LE(mmr, tailed.tail_max_mmr);
+        scarce += mmr >= tailed.tail_start_mmr;
+    }
+    EXPECT_NEAR(scarce, 400, 80);
+}
+
+TEST(PopulationModelTests, RegionWeightsFollowLocalTimeOfDay) {
+    PopulationConfig config;
+    config.region_weights = {0.0, 1.0, 0.0};
+    config.diurnal_amplitude = 1.0;
+    config.day_length_seconds = 24.0;
+    PopulationModel model(config, 4);
+
+    // EU is UTC+1 and peaks at 20:00 local, so 19:00 UTC is its busiest hour.
+    EXPECT_NEAR(model.Intensity(19.0), 2.0, 1e-9);
+    EXPECT_NEAR(model.Intensity(7.0), 0.0, 1e-9);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(model.MakeArrival(i, static_cast<double>(i % 24), "e")[0].player.region(), "EU");
+    }
+}
+
+TEST(PopulationModelTests, PartiesArriveTogetherAndShareTheirPatience) {
+    PopulationConfig config;
+    config.party_size_weights = {0.0, 0.0, 1.0};
+    config.cancel_fraction = 1.0;
+    PopulationModel model(config, 5);
+
+    const auto party = model.MakeArrival(5, 0.0, "p");
+    ASSERT_EQ(party.size(), 3u);
+    EXPECT_EQ(party[0].player.id(), "p5");
+    EXPECT_EQ(party[1].player.id(), "p5_1");
+    EXPECT_EQ(party[2].player.id(), "p5_2");
+    EXPECT_GT(party[0].cancel_after_ms, 0);
+    for (const auto& member : party) {
+        EXPECT_EQ(member.player.region(), party[0].player.region());
+        EXPECT_EQ(member.cancel_after_ms, party[0].cancel_after_ms);
+    }
+}
+
+TEST(PopulationModelTests, ConfigRoundTripsAndRejectsBadSections) {
+    PopulationConfig config;
+    config.mmr_model = MmrModel::Bimodal;
+    config.tail_fraction = 0.05;
+    config.region_weights = {2.0, 1.0, 0.5};
+    config.diurnal_amplitude = 0.4;
+    config.party_size_weights = {0.7, 0.2, 0.1};
+    std::ostringstream out;
+    WritePopulationConfig(out, config, "");
+
+    PopulationConfig parsed;
+    ConfigError error;
+    ASSERT_TRUE(ParsePopulation(out.str(), parsed, &error)) << error.ToString();
+    EXPECT_EQ(parsed.mmr_model, MmrModel::Bimodal);
+    EXPECT_DOUBLE_EQ(parsed.tail_fraction, 0.05);
+    EXPECT_EQ(parsed.region_weights, config.region_weights);
+    EXPECT_DOUBLE_EQ(parsed.diurnal_amplitude, 0.4);
+    EXPECT_EQ(parsed.party_size_weights, config.party_size_weights);
+
+    const char* bad[] = {
+        R"({"mmr_model":"flat"})",
+        R"({"mmr_min":2000,"mmr_max":1000})",
+        R"({"region_weights":{"NA":0,"EU":0,"ASIA":0}})",
+        R"({"region_weights":{"MARS":1}})",
+        R"({"party_size_weights":[]})",
+        R"({"cancel_fraction":1.5})",
+        R"({"unknown":1})",
+    };
+    for (const char* json : bad) {
+        PopulationConfig rejected;
+        EXPECT_FALSE(ParsePopulation(json, rejected)) << json;
+    }
+}
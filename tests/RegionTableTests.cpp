@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/RegionTable.h"
+
+using matchmaking::Player;
+
+namespace {
+
+void AddPing(Player& p, const std::string& datacenter, int ping_ms) {
+    auto* dc = p.add_pings();
+    dc->set_datacenter(datacenter);
+    dc->set_ping_ms(ping_ms);
+}
+
+}  // namespace
+
+TEST(RegionTableTests, ResolvesPingsFromDatacenterListThenLegacyFieldsThenFallback) {
+    RegionTable table({"FRA", "NA", "SIN", "EU"});
+    Player p;
+    p.set_ping(150);
+    p.set_ping_na(90);
+    p.set_ping_eu(70);
+    AddPing(p, "FRA", 25);
+    AddPing(p, "EU", 0);  // unmeasured: falls through to ping_eu
+
+    RegionPings pings = table.Resolve(p);
+    EXPECT_EQ(pings.ping[0], 25);
+    EXPECT_EQ(pings.ping[1], 90);
+    EXPECT_EQ(pings.ping[2], 150);
+    EXPECT_EQ(pings.ping[3], 70);
+
+    EXPECT_EQ(pings.rank[0], 0);
+    EXPECT_EQ(pings.rank[3], 1);
+    EXPECT_EQ(pings.rank[1], 2);
+    EXPECT_EQ(pings.rank[2], 3);
+}
+
+TEST(RegionTableTests, RanksMatchStableSortForEveryTableSize) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> ping_dist(1, 40);  // narrow range forces ties
+    for (std::size_t size = 1; size <= kMaxRegions; ++size) {
+        std::vector<std::string> names;
+        for (std::size_t r = 0; r < size; ++r) {
+            names.push_back("DC" + std::to_string(r));
+        }
+        RegionTable table(names);
+        for (int trial = 0; trial < 50; ++trial) {
+            Player p;
+            std::vector<int> ping(size);
+            for (std::size_t r = 0; r < size; ++r) {
+                ping[r] = ping_dist(rng);
+                AddPing(p, names[r], ping[r]);
+            }
+            std::vector<std::size_t> order(size);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return ping[a] < ping[b]; });
+
+            RegionPings pings = table.Resolve(p);
+            for (std::size_t position = 0; position < size; ++position) {
+                ASSERT_EQ(pings.rank[order[position]], position) << "size " << size << " trial " << trial;
+            }
+        }
+    }
+}
+
+TEST(RegionTableTests, KeysIdentifyTheRegionList) {
+    EXPECT_EQ(RegionTable({"NA", "EU"}).Key(), RegionTable({"NA", "EU"}).Key());
+    EXPECT_NE(RegionTable({"NA", "EU"}).Key(), RegionTable({"EU", "NA"}).Key());
+    EXPECT_NE(RegionTable({"NAEU"}).Key(), RegionTable({"NA", "EU"}).Key());
+    EXPECT_EQ(RegionTable({"NA", "EU"}).IndexOf("EU"), 1);
+    EXPECT_EQ(RegionTable({"NA", "EU"}).IndexOf("ASIA"), -1);
+}
+
+TEST(RegionTableTests, SelectsTheDatacenterWithTheLowestWorstOrP90Ping) {
+    RegionTable table({"NA", "EU", "ASIA"});
+    std::vector<RegionPings> resolved;
+    for (int i = 0; i < 10; ++i) {
+        Player p;
+        AddPing(p, "NA", 60);
+        AddPing(p, "EU", i == 0 ? 140 : 30);
+        AddPing(p, "ASIA", 200);
+        resolved.push_back(table.Resolve(p));
+    }
+    std::vector<const RegionPings*> rows;
+    for (const auto& pings : resolved) {
+        rows.push_back(&pings);
+    }
+
+    DatacenterChoice worst = SelectDatacenter(rows.data(), rows.size(), table.size(), 2, DatacenterObjective::MaxPing);
+    EXPECT_EQ(worst.region, 0u);
+    EXPECT_EQ(worst.ping_ms, 60);
+
+    // p90 of ten pings ignores the single 140 ms player.
+    DatacenterChoice p90 = SelectDatacenter(rows.data(), rows.size(), table.size(), 2, DatacenterObjective::P90Ping);
+    EXPECT_EQ(p90.region, 1u);
+    EXPECT_EQ(p90.ping_ms, 30);
+}
+
+TEST(RegionTableTests, DatacenterTiesPreferTheRequestedRegion) {
+    RegionTable table({"NA", "EU", "ASIA"});
+    Player p;
+    AddPing(p, "NA", 50);
+    AddPing(p, "EU", 50);
+    AddPing(p, "ASIA", 50);
+    RegionPings pings = table.Resolve(p);
+    const RegionPings* rows[] = {&pings};
+
+    EXPECT_EQ(SelectDatacenter(rows, 1, table.size(), 1, DatacenterObjective::MaxPing).region, 1u);
+    EXPECT_EQ(SelectDatacenter(rows, 1, table.size(), 7, DatacenterObjective::MaxPing).region, 0u);
+    EXPECT_EQ(SelectDatacenter(rows, 1, table.size(), 2, DatacenterObjective::P90Ping).region, 2u);
+}
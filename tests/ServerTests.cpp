@@ -0,0 +1,44 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "server.h"
+
+TEST(ServerTests, InlineReloadCannotChangeFilePaths) {
+    EngineConfig config;
+    config.matches_path = "";
+    MatchmakerServiceImpl service(config, "");
+    const std::uint64_t version = service.ConfigVersion();
+
+    std::string error;
+    EXPECT_FALSE(service.Reload(R"({"matches_path":"/tmp/elsewhere.jsonl"})", error));
+    EXPECT_NE(error.find("matches_path"), std::string::npos) << error;
+    EXPECT_FALSE(service.Reload(R"({"tick_interval_ms":50,"arrival_trace_path":"trace.jsonl"})", error));
+    EXPECT_NE(error.find("arrival_trace_path"), std::string::npos) << error;
+    EXPECT_EQ(service.ConfigVersion(), version);
+
+    // Other keys still apply; the paths in effect are kept rather than reset to defaults.
+    error.clear();
+    EXPECT_TRUE(service.Reload(R"({"tick_interval_ms":50})", error)) << error;
+    EXPECT_EQ(service.ConfigVersion(), version + 1);
+}
+
+TEST(ServerTests, ReloadCannotChangeStartupOnlyKeys) {
+    EngineConfig config;
+    config.matches_path = "";
+    config.node_id = 7;
+    config.matching_threads = 2;
+    MatchmakerServiceImpl service(config, "");
+    const std::uint64_t version = service.ConfigVersion();
+
+    std::string error;
+    EXPECT_FALSE(service.Reload(R"({"node_id":8,"matching_threads":2})", error));
+    EXPECT_NE(error.find("node_id requires restart"), std::string::npos) << error;
+    EXPECT_FALSE(service.Reload(R"({"node_id":7,"matching_threads":4})", error));
+    EXPECT_NE(error.find("matching_threads requires restart"), std::string::npos) << error;
+    EXPECT_EQ(service.ConfigVersion(), version);
+
+    error.clear();
+    EXPECT_TRUE(service.Reload(R"({"node_id":7,"matching_threads":2,"tick_interval_ms":50})", error)) << error;
+    EXPECT_EQ(service.ConfigVersion(), version + 1);
+}
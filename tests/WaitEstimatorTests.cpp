@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "Engine/WaitEstimator.h"
+
+TEST(WaitEstimatorTests, UnknownUntilTheBucketSeesAMatch) {
+    WaitEstimator waits;
+    waits.Refresh(0);
+    EXPECT_EQ(waits.Estimate(0, 1000, 0, 0), -1);
+
+    waits.RecordMatched(0, 2000, 10000);
+    waits.RecordMatched(1, 1000, 10000);
+    waits.Refresh(0);
+    EXPECT_EQ(waits.Estimate(0, 1000, 0, 0), -1);
+    EXPECT_GE(waits.Estimate(0, 2000, 0, 0), 0);
+}
+
+TEST(WaitEstimatorTests, UsesTheMedianWaitOfMatchesThatWaitedAsLong) {
+    WaitEstimator waits;
+    for (int seconds : {10, 20, 30, 40, 50}) {
+        waits.RecordMatched(0, 1000, seconds * 1000);
+    }
+    // With no time elapsed there is no match rate yet, only the wait histogram.
+    waits.Refresh(0);
+
+    // Median of all five, interpolated within its 5 s bin.
+    EXPECT_EQ(waits.Estimate(0, 1000, 0, 0), 32500);
+    // Having waited 35 s, only the 40 s and 50 s matches are comparable.
+    EXPECT_EQ(waits.Estimate(0, 1000, 35000, 0), 10000);
+    // Past every recorded wait the history has nothing to add.
+    EXPECT_EQ(waits.Estimate(0, 1000, 60000, 0), 0);
+}
+
+TEST(WaitEstimatorTests, RecentMatchRateBoundsTheWaitBehindOtherPlayers) {
+    WaitEstimator waits;
+    waits.Refresh(0);
+    for (int i = 0; i < 10; ++i) {
+        waits.RecordMatched(0, 1000, 0);
+    }
+    waits.Refresh(10000);
+
+    // Ten matched players in ten seconds: one per second, less the first decay.
+    EXPECT_EQ(waits.Estimate(0, 1000, 0, 0), 2500);
+    EXPECT_NEAR(static_cast<double>(waits.Estimate(0, 1000, 0, 99)), 100000.0, 1.0);
+}
+
+TEST(WaitEstimatorTests, OldMatchesDecayAway) {
+    WaitEstimator waits;
+    waits.Refresh(0);
+    waits.RecordMatched(3, 1500, 20000);
+    waits.Refresh(1000);
+    EXPECT_GE(waits.Estimate(3, 1500, 0, 0), 0);
+
+    waits.Refresh(1000 + 3600 * 1000);
+    EXPECT_EQ(waits.Estimate(3, 1500, 0, 0), -1);
+}
@@ -0,0 +1,26 @@
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Engine/WorkerPool.h"
+
+TEST(WorkerPoolTests, RunsEveryTaskOncePerBatch) {
+    WorkerPool pool(4);
+    EXPECT_EQ(pool.Size(), 4u);
+
+    std::vector<std::atomic<int>> runs(37);
+    for (int batch = 0; batch < 50; ++batch) {
+        pool.Run(runs.size(), [&](std::size_t i) { runs[i].fetch_add(1); });
+    }
+    for (const auto& count : runs) {
+        EXPECT_EQ(count.load(), 50);
+    }
+}
+
+TEST(WorkerPoolTests, SingleThreadPoolRunsInline) {
+    WorkerPool pool(1);
+    std::vector<std::size_t> order;
+    pool.Run(3, [&](std::size_t i) { order.push_back(i); });
+    EXPECT_EQ(order, (std::vector<std::size_t>{0, 1, 2}));
+}